@@ -44,7 +44,7 @@
  */
 bool feat_is_magma(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_MAGMA);
+	return feat_has(feat, TF_MAGMA);
 }
 
 /**
@@ -52,7 +52,7 @@ bool feat_is_magma(int feat)
  */
 bool feat_is_quartz(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_QUARTZ);
+	return feat_has(feat, TF_QUARTZ);
 }
 
 /**
@@ -60,7 +60,7 @@ bool feat_is_quartz(int feat)
  */
 bool feat_is_granite(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_GRANITE);
+	return feat_has(feat, TF_GRANITE);
 }
 
 /**
@@ -68,7 +68,7 @@ bool feat_is_granite(int feat)
  */
 bool feat_is_treasure(int feat)
 {
-	return (tf_has(f_info[feat].flags, TF_GOLD));
+	return (feat_has(feat, TF_GOLD));
 }
 
 /**
@@ -76,7 +76,7 @@ bool feat_is_treasure(int feat)
  */
 bool feat_is_wall(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_WALL);
+	return feat_has(feat, TF_WALL);
 }
 
 /**
@@ -84,7 +84,7 @@ bool feat_is_wall(int feat)
  */
 bool feat_is_permanent(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PERMANENT);
+	return feat_has(feat, TF_PERMANENT);
 }
 
 /**
@@ -92,7 +92,7 @@ bool feat_is_permanent(int feat)
  */
 bool feat_is_path(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PATH);
+	return feat_has(feat, TF_PATH);
 }
 
 /**
@@ -100,7 +100,7 @@ bool feat_is_path(int feat)
  */
 bool feat_is_floor(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_FLOOR);
+	return feat_has(feat, TF_FLOOR);
 }
 
 /**
@@ -108,7 +108,7 @@ bool feat_is_floor(int feat)
  */
 bool feat_is_run1(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_RUN1);
+	return feat_has(feat, TF_RUN1);
 }
 
 /**
@@ -116,7 +116,7 @@ bool feat_is_run1(int feat)
  */
 bool feat_is_run2(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_RUN2);
+	return feat_has(feat, TF_RUN2);
 }
 
 /**
@@ -124,7 +124,7 @@ bool feat_is_run2(int feat)
  */
 bool feat_is_trap_holding(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_TRAP);
+	return feat_has(feat, TF_TRAP);
 }
 
 /**
@@ -132,7 +132,7 @@ bool feat_is_trap_holding(int feat)
  */
 bool feat_is_object_holding(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_OBJECT);
+	return feat_has(feat, TF_OBJECT);
 }
 
 /**
@@ -140,7 +140,7 @@ bool feat_is_object_holding(int feat)
  */
 bool feat_is_monster_walkable(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PASSABLE);
+	return feat_has(feat, TF_PASSABLE);
 }
 
 /**
@@ -148,7 +148,7 @@ bool feat_is_monster_walkable(int feat)
  */
 bool feat_is_shop(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_SHOP);
+	return feat_has(feat, TF_SHOP);
 }
 
 /**
@@ -156,7 +156,7 @@ bool feat_is_shop(int feat)
  */
 bool feat_is_los(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_LOS);
+	return feat_has(feat, TF_LOS);
 }
 
 /**
@@ -164,7 +164,7 @@ bool feat_is_los(int feat)
  */
 bool feat_is_passable(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PASSABLE);
+	return feat_has(feat, TF_PASSABLE);
 }
 
 /**
@@ -172,7 +172,7 @@ bool feat_is_passable(int feat)
  */
 bool feat_is_projectable(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PROJECT);
+	return feat_has(feat, TF_PROJECT);
 }
 
 /**
@@ -180,7 +180,7 @@ bool feat_is_projectable(int feat)
  */
 bool feat_is_torch(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_TORCH);
+	return feat_has(feat, TF_TORCH);
 }
 
 /**
@@ -188,7 +188,7 @@ bool feat_is_torch(int feat)
  */
 bool feat_is_bright(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_BRIGHT);
+	return feat_has(feat, TF_BRIGHT);
 }
 
 /**
@@ -196,7 +196,7 @@ bool feat_is_bright(int feat)
  */
 bool feat_is_fiery(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_FIERY);
+	return feat_has(feat, TF_FIERY);
 }
 
 /**
@@ -204,7 +204,7 @@ bool feat_is_fiery(int feat)
  */
 bool feat_is_no_flow(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_NO_FLOW);
+	return feat_has(feat, TF_NO_FLOW);
 }
 
 /**
@@ -212,7 +212,7 @@ bool feat_is_no_flow(int feat)
  */
 bool feat_is_no_scent(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_NO_SCENT);
+	return feat_has(feat, TF_NO_SCENT);
 }
 
 /**
@@ -220,7 +220,7 @@ bool feat_is_no_scent(int feat)
  */
 bool feat_is_smooth(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_SMOOTH);
+	return feat_has(feat, TF_SMOOTH);
 }
 
 /**
@@ -228,7 +228,7 @@ bool feat_is_smooth(int feat)
  */
 bool feat_is_fall(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_FALL);
+	return feat_has(feat, TF_FALL);
 }
 
 /**
@@ -236,7 +236,7 @@ bool feat_is_fall(int feat)
  */
 bool feat_is_tree(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_TREE);
+	return feat_has(feat, TF_TREE);
 }
 
 /**
@@ -244,7 +244,7 @@ bool feat_is_tree(int feat)
  */
 bool feat_is_hide_obj(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_HIDE_OBJ);
+	return feat_has(feat, TF_HIDE_OBJ);
 }
 
 /**
@@ -252,7 +252,7 @@ bool feat_is_hide_obj(int feat)
  */
 bool feat_is_organic(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_ORGANIC);
+	return feat_has(feat, TF_ORGANIC);
 }
 
 /**
@@ -260,7 +260,7 @@ bool feat_is_organic(int feat)
  */
 bool feat_is_freeze(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_FREEZE);
+	return feat_has(feat, TF_FREEZE);
 }
 
 /**
@@ -268,7 +268,7 @@ bool feat_is_freeze(int feat)
  */
 bool feat_is_watery(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_WATERY);
+	return feat_has(feat, TF_WATERY);
 }
 
 /**
@@ -276,7 +276,7 @@ bool feat_is_watery(int feat)
  */
 bool feat_is_icy(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_ICY);
+	return feat_has(feat, TF_ICY);
 }
 
 /**
@@ -284,7 +284,7 @@ bool feat_is_icy(int feat)
  */
 bool feat_is_protect(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PROTECT);
+	return feat_has(feat, TF_PROTECT);
 }
 
 /**
@@ -292,15 +292,15 @@ bool feat_is_protect(int feat)
  */
 bool feat_is_expose(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_EXPOSE);
+	return feat_has(feat, TF_EXPOSE);
 }
 
 /**
  * SQUARE FEATURE PREDICATES
  *
  * These functions are used to figure out what kind of square something is,
- * via c->squares[y][x].feat (preferably accessed via square(c, grid)).
- * All direct testing of square(c, grid)->feat should be rewritten
+ * via c->sq_feat[] (preferably accessed via square_fidx(c, grid)).
+ * All direct testing of square_fidx(c, grid) should be rewritten
  * in terms of these functions.
  *
  * It's often better to use square behavior predicates (written in terms of
@@ -316,7 +316,7 @@ bool feat_is_expose(int feat)
  */
 bool square_isfloor(struct chunk *c, struct loc grid)
 {
-	return feat_is_floor(square(c, grid)->feat);
+	return feat_is_floor(square_fidx(c, grid));
 }
 
 /**
@@ -324,7 +324,7 @@ bool square_isfloor(struct chunk *c, struct loc grid)
  */
 bool square_isrun1(struct chunk *c, struct loc grid)
 {
-	return feat_is_run1(square(c, grid)->feat);
+	return feat_is_run1(square_fidx(c, grid));
 }
 
 /**
@@ -332,7 +332,7 @@ bool square_isrun1(struct chunk *c, struct loc grid)
  */
 bool square_isrun2(struct chunk *c, struct loc grid)
 {
-	return feat_is_run2(square(c, grid)->feat);
+	return feat_is_run2(square_fidx(c, grid));
 }
 
 /**
@@ -340,7 +340,7 @@ bool square_isrun2(struct chunk *c, struct loc grid)
  */
 bool square_istrappable(struct chunk *c, struct loc grid)
 {
-	return feat_is_trap_holding(square(c, grid)->feat);
+	return feat_is_trap_holding(square_fidx(c, grid));
 }
 
 /**
@@ -348,7 +348,7 @@ bool square_istrappable(struct chunk *c, struct loc grid)
  */
 bool square_isobjectholding(struct chunk *c, struct loc grid)
 {
-	return feat_is_object_holding(square(c, grid)->feat);
+	return feat_is_object_holding(square_fidx(c, grid));
 }
 
 /**
@@ -356,7 +356,7 @@ bool square_isobjectholding(struct chunk *c, struct loc grid)
  */
 bool square_isobjecthiding(struct chunk *c, struct loc grid)
 {
-	return feat_is_hide_obj(square(c, grid)->feat);
+	return feat_is_hide_obj(square_fidx(c, grid));
 }
 
 /**
@@ -364,8 +364,8 @@ bool square_isobjecthiding(struct chunk *c, struct loc grid)
  */
 bool square_isrock(struct chunk *c, struct loc grid)
 {
-	return (tf_has(f_info[square(c, grid)->feat].flags, TF_GRANITE) &&
-			!tf_has(f_info[square(c, grid)->feat].flags, TF_DOOR_ANY));
+	return (feat_has(square_fidx(c, grid), TF_GRANITE) &&
+			!feat_has(square_fidx(c, grid), TF_DOOR_ANY));
 }
 
 /**
@@ -373,7 +373,7 @@ bool square_isrock(struct chunk *c, struct loc grid)
  */
 bool square_isgranite(struct chunk *c, struct loc grid)
 {
-	return feat_is_granite(square(c, grid)->feat);
+	return feat_is_granite(square_fidx(c, grid));
 }
 
 /**
@@ -381,7 +381,7 @@ bool square_isgranite(struct chunk *c, struct loc grid)
  */
 bool square_ispermanent(struct chunk *c, struct loc grid)
 {
-	return feat_is_permanent(square(c, grid)->feat);
+	return feat_is_permanent(square_fidx(c, grid));
 }
 
 /**
@@ -390,7 +390,7 @@ bool square_ispermanent(struct chunk *c, struct loc grid)
 bool square_isperm(struct chunk *c, struct loc grid)
 {
 	return (square_ispermanent(c, grid) &&
-			tf_has(f_info[square(c, grid)->feat].flags, TF_ROCK));
+			feat_has(square_fidx(c, grid), TF_ROCK));
 }
 
 /**
@@ -398,7 +398,7 @@ bool square_isperm(struct chunk *c, struct loc grid)
  */
 bool square_ismagma(struct chunk *c, struct loc grid)
 {
-	return feat_is_magma(square(c, grid)->feat);
+	return feat_is_magma(square_fidx(c, grid));
 }
 
 /**
@@ -406,7 +406,7 @@ bool square_ismagma(struct chunk *c, struct loc grid)
  */
 bool square_isquartz(struct chunk *c, struct loc grid)
 {
-	return feat_is_quartz(square(c, grid)->feat);
+	return feat_is_quartz(square_fidx(c, grid));
 }
 
 /**
@@ -420,7 +420,7 @@ bool square_ismineral(struct chunk *c, struct loc grid)
 
 bool square_hasgoldvein(struct chunk *c, struct loc grid)
 {
-	return tf_has(f_info[square(c, grid)->feat].flags, TF_GOLD);
+	return feat_has(square_fidx(c, grid), TF_GOLD);
 }
 
 /**
@@ -428,8 +428,8 @@ bool square_hasgoldvein(struct chunk *c, struct loc grid)
  */
 bool square_isrubble(struct chunk *c, struct loc grid)
 {
-    return (!tf_has(f_info[square(c, grid)->feat].flags, TF_WALL) &&
-			tf_has(f_info[square(c, grid)->feat].flags, TF_ROCK));
+    return (!feat_has(square_fidx(c, grid), TF_WALL) &&
+			feat_has(square_fidx(c, grid), TF_ROCK));
 }
 
 /**
@@ -440,8 +440,8 @@ bool square_isrubble(struct chunk *c, struct loc grid)
  */
 bool square_issecretdoor(struct chunk *c, struct loc grid)
 {
-    return (tf_has(f_info[square(c, grid)->feat].flags, TF_DOOR_ANY) &&
-			tf_has(f_info[square(c, grid)->feat].flags, TF_ROCK));
+    return (feat_has(square_fidx(c, grid), TF_DOOR_ANY) &&
+			feat_has(square_fidx(c, grid), TF_ROCK));
 }
 
 /**
@@ -449,7 +449,7 @@ bool square_issecretdoor(struct chunk *c, struct loc grid)
  */
 bool square_isopendoor(struct chunk *c, struct loc grid)
 {
-    return (tf_has(f_info[square(c, grid)->feat].flags, TF_CLOSABLE));
+    return (feat_has(square_fidx(c, grid), TF_CLOSABLE));
 }
 
 /**
@@ -457,16 +457,16 @@ bool square_isopendoor(struct chunk *c, struct loc grid)
  */
 bool square_iscloseddoor(struct chunk *c, struct loc grid)
 {
-	int feat = square(c, grid)->feat;
-	return tf_has(f_info[feat].flags, TF_DOOR_CLOSED);
+	int feat = square_fidx(c, grid);
+	return feat_has(feat, TF_DOOR_CLOSED);
 }
 
 bool square_isbrokendoor(struct chunk *c, struct loc grid)
 {
-	int feat = square(c, grid)->feat;
-    return (tf_has(f_info[feat].flags, TF_DOOR_ANY) &&
-			tf_has(f_info[feat].flags, TF_PASSABLE) &&
-			!tf_has(f_info[feat].flags, TF_CLOSABLE));
+	int feat = square_fidx(c, grid);
+    return (feat_has(feat, TF_DOOR_ANY) &&
+			feat_has(feat, TF_PASSABLE) &&
+			!feat_has(feat, TF_CLOSABLE));
 }
 
 /**
@@ -476,8 +476,8 @@ bool square_isbrokendoor(struct chunk *c, struct loc grid)
  */
 bool square_isdoor(struct chunk *c, struct loc grid)
 {
-	int feat = square(c, grid)->feat;
-	return tf_has(f_info[feat].flags, TF_DOOR_ANY);
+	int feat = square_fidx(c, grid);
+	return feat_has(feat, TF_DOOR_ANY);
 }
 
 /**
@@ -485,8 +485,8 @@ bool square_isdoor(struct chunk *c, struct loc grid)
  */
 bool square_isstairs(struct chunk *c, struct loc grid)
 {
-	int feat = square(c, grid)->feat;
-	return tf_has(f_info[feat].flags, TF_STAIR);
+	int feat = square_fidx(c, grid);
+	return feat_has(feat, TF_STAIR);
 }
 
 /**
@@ -494,8 +494,8 @@ bool square_isstairs(struct chunk *c, struct loc grid)
  */
 bool square_isupstairs(struct chunk*c, struct loc grid)
 {
-	int feat = square(c, grid)->feat;
-	return tf_has(f_info[feat].flags, TF_UPSTAIR);
+	int feat = square_fidx(c, grid);
+	return feat_has(feat, TF_UPSTAIR);
 }
 
 /**
@@ -503,8 +503,8 @@ bool square_isupstairs(struct chunk*c, struct loc grid)
  */
 bool square_isdownstairs(struct chunk *c, struct loc grid)
 {
-	int feat = square(c, grid)->feat;
-	return tf_has(f_info[feat].flags, TF_DOWNSTAIR);
+	int feat = square_fidx(c, grid);
+	return feat_has(feat, TF_DOWNSTAIR);
 }
 
 /**
@@ -512,7 +512,7 @@ bool square_isdownstairs(struct chunk *c, struct loc grid)
  */
 bool square_ispath(struct chunk *c, struct loc grid)
 {
-	return feat_is_path(square(c, grid)->feat);
+	return feat_is_path(square_fidx(c, grid));
 }
 
 /**
@@ -520,21 +520,21 @@ bool square_ispath(struct chunk *c, struct loc grid)
  */
 bool square_isshop(struct chunk *c, struct loc grid)
 {
-	return feat_is_shop(square(c, grid)->feat);
+	return feat_is_shop(square_fidx(c, grid));
 }
 
 /**
  * True if the square contains the player
  */
 bool square_isplayer(struct chunk *c, struct loc grid) {
-	return square(c, grid)->mon < 0 ? true : false;
+	return square_midx(c, grid) < 0 ? true : false;
 }
 
 /**
  * True if the square contains the player or a monster
  */
 bool square_isoccupied(struct chunk *c, struct loc grid) {
-	return square(c, grid)->mon != 0 ? true : false;
+	return square_midx(c, grid) != 0 ? true : false;
 }
 
 /**
@@ -543,7 +543,7 @@ bool square_isoccupied(struct chunk *c, struct loc grid) {
 bool square_isknown(struct chunk *c, struct loc grid) {
 	if (c != cave && (!player || c != player->cave)) return false;
 	if (!player->cave) return false;
-	return square(player->cave, grid)->feat == FEAT_NONE ? false : true;
+	return square_fidx(player->cave, grid) == FEAT_NONE ? false : true;
 }
 
 /**
@@ -552,7 +552,7 @@ bool square_isknown(struct chunk *c, struct loc grid) {
  */
 bool square_ismemorybad(struct chunk *c, struct loc grid) {
 	return !square_isknown(c, grid)
-		|| square(player->cave, grid)->feat != square(cave, grid)->feat;
+		|| square_fidx(player->cave, grid) != square_fidx(cave, grid);
 }
 
 /**
@@ -560,7 +560,7 @@ bool square_ismemorybad(struct chunk *c, struct loc grid) {
  */
 bool square_isfall(struct chunk *c, struct loc grid)
 {
-	return feat_is_fall(square(c, grid)->feat);
+	return feat_is_fall(square_fidx(c, grid));
 }
 
 /**
@@ -568,7 +568,7 @@ bool square_isfall(struct chunk *c, struct loc grid)
  */
 bool square_istree(struct chunk *c, struct loc grid)
 {
-	return feat_is_tree(square(c, grid)->feat);
+	return feat_is_tree(square_fidx(c, grid));
 }
 
 /**
@@ -576,7 +576,7 @@ bool square_istree(struct chunk *c, struct loc grid)
  */
 bool square_isorganic(struct chunk *c, struct loc grid)
 {
-	return feat_is_organic(square(c, grid)->feat);
+	return feat_is_organic(square_fidx(c, grid));
 }
 
 /**
@@ -584,7 +584,7 @@ bool square_isorganic(struct chunk *c, struct loc grid)
  */
 bool square_isfreeze(struct chunk *c, struct loc grid)
 {
-	return feat_is_freeze(square(c, grid)->feat);
+	return feat_is_freeze(square_fidx(c, grid));
 }
 
 /**
@@ -592,7 +592,7 @@ bool square_isfreeze(struct chunk *c, struct loc grid)
  */
 bool square_iswatery(struct chunk *c, struct loc grid)
 {
-	return feat_is_watery(square(c, grid)->feat);
+	return feat_is_watery(square_fidx(c, grid));
 }
 
 /**
@@ -600,7 +600,7 @@ bool square_iswatery(struct chunk *c, struct loc grid)
  */
 bool square_isicy(struct chunk *c, struct loc grid)
 {
-	return feat_is_icy(square(c, grid)->feat);
+	return feat_is_icy(square_fidx(c, grid));
 }
 
 /**
@@ -608,7 +608,7 @@ bool square_isicy(struct chunk *c, struct loc grid)
  */
 bool square_isprotect(struct chunk *c, struct loc grid)
 {
-	return feat_is_protect(square(c, grid)->feat);
+	return feat_is_protect(square_fidx(c, grid));
 }
 
 /**
@@ -616,7 +616,7 @@ bool square_isprotect(struct chunk *c, struct loc grid)
  */
 bool square_isexpose(struct chunk *c, struct loc grid)
 {
-	return feat_is_expose(square(c, grid)->feat);
+	return feat_is_expose(square_fidx(c, grid));
 }
 
 /**
@@ -632,7 +632,7 @@ bool square_isexpose(struct chunk *c, struct loc grid)
  */
 bool square_ismark(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_MARK);
+	return sqinfo_has(square_info(c, grid), SQUARE_MARK);
 }
 
 /**
@@ -640,7 +640,7 @@ bool square_ismark(struct chunk *c, struct loc grid) {
  */
 bool square_isglow(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_GLOW);
+	return sqinfo_has(square_info(c, grid), SQUARE_GLOW);
 }
 
 /**
@@ -650,7 +650,7 @@ bool square_isglow(struct chunk *c, struct loc grid) {
  */
 bool square_isvault(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_VAULT);
+	return sqinfo_has(square_info(c, grid), SQUARE_VAULT);
 }
 
 /**
@@ -658,7 +658,7 @@ bool square_isvault(struct chunk *c, struct loc grid) {
  */
 bool square_isroom(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_ROOM);
+	return sqinfo_has(square_info(c, grid), SQUARE_ROOM);
 }
 
 /**
@@ -666,7 +666,7 @@ bool square_isroom(struct chunk *c, struct loc grid) {
  */
 bool square_isseen(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_SEEN);
+	return sqinfo_has(square_info(c, grid), SQUARE_SEEN);
 }
 
 /**
@@ -674,7 +674,7 @@ bool square_isseen(struct chunk *c, struct loc grid) {
  */
 bool square_isview(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_VIEW);
+	return sqinfo_has(square_info(c, grid), SQUARE_VIEW);
 }
 
 /**
@@ -682,7 +682,7 @@ bool square_isview(struct chunk *c, struct loc grid) {
  */
 bool square_wasseen(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_WASSEEN);
+	return sqinfo_has(square_info(c, grid), SQUARE_WASSEEN);
 }
 
 /**
@@ -690,7 +690,7 @@ bool square_wasseen(struct chunk *c, struct loc grid) {
  */
 bool square_isfeel(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_FEEL);
+	return sqinfo_has(square_info(c, grid), SQUARE_FEEL);
 }
 
 /**
@@ -698,7 +698,7 @@ bool square_isfeel(struct chunk *c, struct loc grid) {
  */
 bool square_istrap(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_TRAP);
+	return sqinfo_has(square_info(c, grid), SQUARE_TRAP);
 }
 
 /**
@@ -706,7 +706,7 @@ bool square_istrap(struct chunk *c, struct loc grid) {
  */
 bool square_isinvis(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_INVIS);
+	return sqinfo_has(square_info(c, grid), SQUARE_INVIS);
 }
 
 /**
@@ -714,7 +714,7 @@ bool square_isinvis(struct chunk *c, struct loc grid) {
  */
 bool square_iswall_inner(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_WALL_INNER);
+	return sqinfo_has(square_info(c, grid), SQUARE_WALL_INNER);
 }
 
 /**
@@ -722,7 +722,7 @@ bool square_iswall_inner(struct chunk *c, struct loc grid) {
  */
 bool square_iswall_outer(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_WALL_OUTER);
+	return sqinfo_has(square_info(c, grid), SQUARE_WALL_OUTER);
 }
 
 /**
@@ -730,7 +730,7 @@ bool square_iswall_outer(struct chunk *c, struct loc grid) {
  */
 bool square_iswall_solid(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_WALL_SOLID);
+	return sqinfo_has(square_info(c, grid), SQUARE_WALL_SOLID);
 }
 
 /**
@@ -738,7 +738,7 @@ bool square_iswall_solid(struct chunk *c, struct loc grid) {
  */
 bool square_ismon_restrict(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_MON_RESTRICT);
+	return sqinfo_has(square_info(c, grid), SQUARE_MON_RESTRICT);
 }
 
 /**
@@ -746,7 +746,7 @@ bool square_ismon_restrict(struct chunk *c, struct loc grid) {
  */
 bool square_isno_teleport(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_NO_TELEPORT);
+	return sqinfo_has(square_info(c, grid), SQUARE_NO_TELEPORT);
 }
 
 /**
@@ -754,7 +754,7 @@ bool square_isno_teleport(struct chunk *c, struct loc grid) {
  */
 bool square_isno_map(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_NO_MAP);
+	return sqinfo_has(square_info(c, grid), SQUARE_NO_MAP);
 }
 
 /**
@@ -762,7 +762,7 @@ bool square_isno_map(struct chunk *c, struct loc grid) {
  */
 bool square_isno_esp(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_NO_ESP);
+	return sqinfo_has(square_info(c, grid), SQUARE_NO_ESP);
 }
 
 /**
@@ -770,7 +770,7 @@ bool square_isno_esp(struct chunk *c, struct loc grid) {
  */
 bool square_isproject(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_PROJECT);
+	return sqinfo_has(square_info(c, grid), SQUARE_PROJECT);
 }
 
 /**
@@ -778,7 +778,7 @@ bool square_isproject(struct chunk *c, struct loc grid) {
  */
 bool square_isdtrap(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_DTRAP);
+	return sqinfo_has(square_info(c, grid), SQUARE_DTRAP);
 }
 
 /**
@@ -786,7 +786,7 @@ bool square_isdtrap(struct chunk *c, struct loc grid) {
  */
 bool square_isno_stairs(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid)->info, SQUARE_NO_STAIRS);
+	return sqinfo_has(square_info(c, grid), SQUARE_NO_STAIRS);
 }
 
 
@@ -804,7 +804,7 @@ bool square_isno_stairs(struct chunk *c, struct loc grid) {
  * True if the square is open (a floor square not occupied by a monster).
  */
 bool square_isopen(struct chunk *c, struct loc grid) {
-	return square_isfloor(c, grid) && !square(c, grid)->mon;
+	return square_isfloor(c, grid) && !square_midx(c, grid);
 }
 
 /**
@@ -820,7 +820,7 @@ bool square_isempty(struct chunk *c, struct loc grid) {
  * True if the square is empty (an open square without any items).
  */
 bool square_isarrivable(struct chunk *c, struct loc grid) {
-	if (square(c, grid)->mon) return false;
+	if (square_midx(c, grid)) return false;
 	if (square_isplayertrap(c, grid)) return false;
 	if (square_iswebbed(c, grid)) return false;
 	if (square_isfloor(c, grid)) return true;
@@ -864,7 +864,7 @@ bool square_iswebbable(struct chunk *c, struct loc grid) {
 bool square_is_monster_walkable(struct chunk *c, struct loc grid)
 {
 	assert(square_in_bounds(c, grid));
-	return feat_is_monster_walkable(square(c, grid)->feat);
+	return feat_is_monster_walkable(square_fidx(c, grid));
 }
 
 /**
@@ -872,7 +872,7 @@ bool square_is_monster_walkable(struct chunk *c, struct loc grid)
  */
 bool square_ispassable(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_passable(square(c, grid)->feat);
+	return c->sq_pred[square_index(c, grid)] & SQUARE_PRED_PASSABLE;
 }
 
 /**
@@ -880,7 +880,7 @@ bool square_ispassable(struct chunk *c, struct loc grid) {
  */
 bool square_isprojectable(struct chunk *c, struct loc grid) {
 	if (!square_in_bounds(c, grid)) return false;
-	return feat_is_projectable(square(c, grid)->feat);
+	return c->sq_pred[square_index(c, grid)] & SQUARE_PRED_PROJECT;
 }
 
 /**
@@ -896,7 +896,7 @@ bool square_allowsfeel(struct chunk *c, struct loc grid) {
  */
 bool square_allowslos(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_los(square(c, grid)->feat);
+	return c->sq_pred[square_index(c, grid)] & SQUARE_PRED_LOS;
 }
 
 /**
@@ -915,7 +915,7 @@ bool square_isstrongwall(struct chunk *c, struct loc grid) {
  */
 bool square_isbright(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_bright(square(c, grid)->feat);
+	return feat_is_bright(square_fidx(c, grid));
 }
 
 /**
@@ -923,7 +923,7 @@ bool square_isbright(struct chunk *c, struct loc grid) {
  */
 bool square_isfiery(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_fiery(square(c, grid)->feat);
+	return feat_is_fiery(square_fidx(c, grid));
 }
 
 /**
@@ -939,7 +939,7 @@ bool square_islit(struct chunk *c, struct loc grid) {
  */
 bool square_isdamaging(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_fiery(square(c, grid)->feat);
+	return feat_is_fiery(square_fidx(c, grid));
 }
 
 /**
@@ -947,7 +947,7 @@ bool square_isdamaging(struct chunk *c, struct loc grid) {
  */
 bool square_isnoflow(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_no_flow(square(c, grid)->feat);
+	return feat_is_no_flow(square_fidx(c, grid));
 }
 
 /**
@@ -955,7 +955,7 @@ bool square_isnoflow(struct chunk *c, struct loc grid) {
  */
 bool square_isnoscent(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_no_scent(square(c, grid)->feat);
+	return feat_is_no_scent(square_fidx(c, grid));
 }
 
 bool square_iswarded(struct chunk *c, struct loc grid)
@@ -978,13 +978,13 @@ bool square_iswebbed(struct chunk *c, struct loc grid)
 
 bool square_seemslikewall(struct chunk *c, struct loc grid)
 {
-	return tf_has(f_info[square(c, grid)->feat].flags, TF_ROCK);
+	return feat_has(square_fidx(c, grid), TF_ROCK);
 }
 
 bool square_isinteresting(struct chunk *c, struct loc grid)
 {
-	int f = square(c, grid)->feat;
-	return tf_has(f_info[f].flags, TF_INTERESTING);
+	int f = square_fidx(c, grid);
+	return feat_has(f, TF_INTERESTING);
 }
 
 /**
@@ -1211,22 +1211,48 @@ bool square_allows_summon(struct chunk *c, struct loc grid)
  * Below are various square-specific functions which are not predicates
  */
 
-const struct square *square(struct chunk *c, struct loc grid)
+/**
+ * Get the index of a grid in the chunk's flat per-grid arrays.
+ */
+int square_index(struct chunk *c, struct loc grid)
 {
 	assert(square_in_bounds(c, grid));
-	return &c->squares[grid.y][grid.x];
+	return grid.y * c->width + grid.x;
+}
+
+/**
+ * Get the terrain index of a grid.
+ */
+int square_fidx(struct chunk *c, struct loc grid)
+{
+	return c->sq_feat[square_index(c, grid)];
+}
+
+/**
+ * Get the square info flags of a grid; the result can be modified with
+ * sqinfo_on() and the like.
+ */
+bitflag *square_info(struct chunk *c, struct loc grid)
+{
+	return c->sq_info + square_index(c, grid) * SQUARE_SIZE;
+}
+
+/**
+ * Get the monster index of a grid; -1 is the player, 0 is no monster.
+ */
+int square_midx(struct chunk *c, struct loc grid)
+{
+	return c->sq_mon[square_index(c, grid)];
 }
 
 struct feature *square_feat(struct chunk *c, struct loc grid)
 {
-	assert(square_in_bounds(c, grid));
-	return &f_info[square(c, grid)->feat];
+	return &f_info[square_fidx(c, grid)];
 }
 
 int square_light(struct chunk *c, struct loc grid)
 {
-	assert(square_in_bounds(c, grid));
-	return square(c, grid)->light;
+	return c->sq_light[square_index(c, grid)];
 }
 
 /**
@@ -1234,9 +1260,12 @@ int square_light(struct chunk *c, struct loc grid)
  */
 struct monster *square_monster(struct chunk *c, struct loc grid)
 {
+	int midx;
+
 	if (!square_in_bounds(c, grid)) return NULL;
-	if (square(c, grid)->mon > 0) {
-		struct monster *mon = cave_monster(c, square(c, grid)->mon);
+	midx = square_midx(c, grid);
+	if (midx > 0) {
+		struct monster *mon = cave_monster(c, midx);
 		return mon && mon->race ? mon : NULL;
 	}
 
@@ -1248,7 +1277,7 @@ struct monster *square_monster(struct chunk *c, struct loc grid)
  */
 struct object *square_object(struct chunk *c, struct loc grid) {
 	if (!square_in_bounds(c, grid)) return NULL;
-	return square(c, grid)->obj;
+	return c->sq_obj[square_index(c, grid)];
 }
 
 /**
@@ -1257,7 +1286,7 @@ struct object *square_object(struct chunk *c, struct loc grid) {
 struct trap *square_trap(struct chunk *c, struct loc grid)
 {
 	if (!square_in_bounds(c, grid)) return NULL;
-    return square(c, grid)->trap;
+    return c->sq_trap[square_index(c, grid)];
 }
 
 /**
@@ -1273,7 +1302,7 @@ bool square_holds_object(struct chunk *c, struct loc grid, struct object *obj) {
  */
 void square_excise_object(struct chunk *c, struct loc grid, struct object *obj){
 	assert(square_in_bounds(c, grid));
-	pile_excise(&c->squares[grid.y][grid.x].obj, obj);
+	pile_excise(&c->sq_obj[square_index(c, grid)], obj);
 }
 
 /**
@@ -1450,10 +1479,10 @@ int square_num_walls_adjacent(struct chunk *c, struct loc grid)
     int k = 0;
     assert(square_in_bounds(c, grid));
 
-    if (feat_is_wall(square(c, next_grid(grid, DIR_S))->feat)) k++;
-	if (feat_is_wall(square(c, next_grid(grid, DIR_N))->feat)) k++;
-    if (feat_is_wall(square(c, next_grid(grid, DIR_E))->feat)) k++;
-    if (feat_is_wall(square(c, next_grid(grid, DIR_W))->feat)) k++;
+    if (feat_is_wall(square_fidx(c, next_grid(grid, DIR_S)))) k++;
+	if (feat_is_wall(square_fidx(c, next_grid(grid, DIR_N)))) k++;
+    if (feat_is_wall(square_fidx(c, next_grid(grid, DIR_E)))) k++;
+    if (feat_is_wall(square_fidx(c, next_grid(grid, DIR_W)))) k++;
 
     return k;
 }
@@ -1469,10 +1498,10 @@ int square_num_walls_diagonal(struct chunk *c, struct loc grid)
     int k = 0;
     assert(square_in_bounds(c, grid));
 
-    if (feat_is_wall(square(c, next_grid(grid, DIR_SE))->feat)) k++;
-    if (feat_is_wall(square(c, next_grid(grid, DIR_NW))->feat)) k++;
-    if (feat_is_wall(square(c, next_grid(grid, DIR_NE))->feat)) k++;
-    if (feat_is_wall(square(c, next_grid(grid, DIR_SW))->feat)) k++;
+    if (feat_is_wall(square_fidx(c, next_grid(grid, DIR_SE)))) k++;
+    if (feat_is_wall(square_fidx(c, next_grid(grid, DIR_NW)))) k++;
+    if (feat_is_wall(square_fidx(c, next_grid(grid, DIR_NE)))) k++;
+    if (feat_is_wall(square_fidx(c, next_grid(grid, DIR_SW)))) k++;
 
     return k;
 }
@@ -1489,7 +1518,7 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 	int current_feat;
 
 	assert(square_in_bounds(c, grid));
-	current_feat = square(c, grid)->feat;
+	current_feat = square_fidx(c, grid);
 
 	/* Floor and road have only cosmetic differences; use road when outside */
 	if (player->place && (feat == FEAT_FLOOR) &&
@@ -1500,13 +1529,17 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 	/* Track changes */
 	if (current_feat) c->feat_count[current_feat]--;
 	if (feat) c->feat_count[feat]++;
+	if (feat_is_no_flow(current_feat) != feat_is_no_flow(feat)) {
+		c->flow_changes++;
+	}
 
 	/* Make the change */
-	c->squares[grid.y][grid.x].feat = feat;
+	c->sq_feat[square_index(c, grid)] = feat;
+	c->sq_pred[square_index(c, grid)] = f_info[feat].sq_pred;
 
 	/* Light bright terrain */
 	if (feat_is_bright(feat)) {
-		sqinfo_on(square(c, grid)->info, SQUARE_GLOW);
+		sqinfo_on(square_info(c, grid), SQUARE_GLOW);
 	}
 
 	/* Make the new terrain feel at home */
@@ -1523,9 +1556,9 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 		square_light_spot(c, grid);
 	} else {
 		/* Make sure no incorrect wall flags set for dungeon generation */
-		sqinfo_off(square(c, grid)->info, SQUARE_WALL_INNER);
-		sqinfo_off(square(c, grid)->info, SQUARE_WALL_OUTER);
-		sqinfo_off(square(c, grid)->info, SQUARE_WALL_SOLID);
+		sqinfo_off(square_info(c, grid), SQUARE_WALL_INNER);
+		sqinfo_off(square_info(c, grid), SQUARE_WALL_OUTER);
+		sqinfo_off(square_info(c, grid), SQUARE_WALL_SOLID);
 	}
 }
 
@@ -1535,7 +1568,9 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 static void square_set_known_feat(struct chunk *c, struct loc grid, int feat)
 {
 	if (c != cave) return;
-	player->cave->squares[grid.y][grid.x].feat = feat;
+	player->cave->sq_feat[square_index(player->cave, grid)] = feat;
+	player->cave->sq_pred[square_index(player->cave, grid)] =
+		f_info[feat].sq_pred;
 }
 
 /**
@@ -1543,7 +1578,15 @@ static void square_set_known_feat(struct chunk *c, struct loc grid, int feat)
  */
 void square_set_mon(struct chunk *c, struct loc grid, int midx)
 {
-	c->squares[grid.y][grid.x].mon = midx;
+	int idx = square_index(c, grid);
+	bool had = c->sq_mon[idx] > 0;
+
+	c->sq_mon[idx] = midx;
+
+	/* Keep the index of monster grids; the player isn't in it */
+	if (had != (midx > 0)) {
+		cave_index_monster(c, grid, midx > 0);
+	}
 }
 
 /**
@@ -1551,7 +1594,7 @@ void square_set_mon(struct chunk *c, struct loc grid, int midx)
  */
 void square_set_obj(struct chunk *c, struct loc grid, struct object *obj)
 {
-	c->squares[grid.y][grid.x].obj = obj;
+	c->sq_obj[square_index(c, grid)] = obj;
 }
 
 /**
@@ -1559,7 +1602,7 @@ void square_set_obj(struct chunk *c, struct loc grid, struct object *obj)
  */
 void square_set_trap(struct chunk *c, struct loc grid, struct trap *trap)
 {
-	c->squares[grid.y][grid.x].trap = trap;
+	c->sq_trap[square_index(c, grid)] = trap;
 }
 
 void square_add_trap(struct chunk *c, struct loc grid)
@@ -1779,9 +1822,9 @@ void square_earthquake(struct chunk *c, struct loc grid) {
  */
 void square_upgrade_mineral(struct chunk *c, struct loc grid)
 {
-	if (square(c, grid)->feat == FEAT_MAGMA)
+	if (square_fidx(c, grid) == FEAT_MAGMA)
 		square_set_feat(c, grid, FEAT_MAGMA_K);
-	if (square(c, grid)->feat == FEAT_QUARTZ)
+	if (square_fidx(c, grid) == FEAT_QUARTZ)
 		square_set_feat(c, grid, FEAT_QUARTZ_K);
 }
 
@@ -1797,13 +1840,13 @@ void square_force_floor(struct chunk *c, struct loc grid) {
 /* Note that this returns the STORE_ index, which is one less than shopnum */
 int square_shopnum(struct chunk *c, struct loc grid) {
 	if (square_isshop(c, grid))
-		return f_info[square(c, grid)->feat].shopnum - 1;
+		return f_info[square_fidx(c, grid)].shopnum - 1;
 	return -1;
 }
 
 int square_digging(struct chunk *c, struct loc grid) {
 	if (square_isdiggable(c, grid) || square_iscloseddoor(c, grid))
-		return f_info[square(c, grid)->feat].dig;
+		return f_info[square_fidx(c, grid)].dig;
 	return 0;
 }
 
@@ -1816,7 +1859,7 @@ int square_digging(struct chunk *c, struct loc grid) {
  * \param grid Is the grid to use.
  */
 const char *square_apparent_name(struct chunk *c, struct loc grid) {
-	int actual = square(c, grid)->feat;
+	int actual = square_fidx(c, grid);
 	char *mimic_name = f_info[actual].mimic;
 	int f = mimic_name ? lookup_feat(mimic_name) : actual;
 	return f_info[f].name;
@@ -1833,7 +1876,7 @@ const char *square_apparent_name(struct chunk *c, struct loc grid) {
  * The prefix is usually an indefinite article.  It may be an empty string.
  */
 const char *square_apparent_look_prefix(struct chunk *c, struct loc grid) {
-	int actual = square(c, grid)->feat;
+	int actual = square_fidx(c, grid);
 	char *mimic_name = f_info[actual].mimic;
 	int f = mimic_name ? lookup_feat(mimic_name) : actual;
 	return (f_info[f].look_prefix) ? f_info[f].look_prefix :
@@ -1850,7 +1893,7 @@ const char *square_apparent_look_prefix(struct chunk *c, struct loc grid) {
  * \param grid Is the grid to use.
  */
 const char *square_apparent_look_in_preposition(struct chunk *c, struct loc grid) {
-	int actual = square(c, grid)->feat;
+	int actual = square_fidx(c, grid);
 	char *mimic_name = f_info[actual].mimic;
 	int f = mimic_name ? lookup_feat(mimic_name) : actual;
 	return (f_info[f].look_in_preposition) ?
@@ -1860,7 +1903,7 @@ const char *square_apparent_look_in_preposition(struct chunk *c, struct loc grid
 /* Memorize the terrain */
 void square_memorize(struct chunk *c, struct loc grid) {
 	if (c != cave) return;
-	square_set_known_feat(c, grid, square(c, grid)->feat);
+	square_set_known_feat(c, grid, square_fidx(c, grid));
 }
 
 /* Forget the terrain */
@@ -1870,9 +1913,9 @@ void square_forget(struct chunk *c, struct loc grid) {
 }
 
 void square_mark(struct chunk *c, struct loc grid) {
-	sqinfo_on(square(c, grid)->info, SQUARE_MARK);
+	sqinfo_on(square_info(c, grid), SQUARE_MARK);
 }
 
 void square_unmark(struct chunk *c, struct loc grid) {
-	sqinfo_off(square(c, grid)->info, SQUARE_MARK);
+	sqinfo_off(square_info(c, grid), SQUARE_MARK);
 }
@@ -248,6 +248,246 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 	return (true);
 }
 
+/**
+ * One step of a precomputed line of sight, as an offset from the viewer
+ */
+struct view_step {
+	int8_t x, y;
+};
+
+/**
+ * The precomputed line of sight from the origin to one offset:  the grids
+ * that los() would test, in order, plus the grid tested by its "knight's
+ * move" shortcut, if any.
+ */
+struct view_line {
+	struct view_step knight;
+	bool has_knight;
+	uint16_t n_steps;
+	uint32_t first_step;
+};
+
+/**
+ * Lines of sight from the origin to every offset with both components no
+ * larger than view_table_radius in magnitude; built by init_view_table().
+ */
+static int view_table_radius;
+static struct view_line *view_lines;
+static struct view_step *view_steps;
+
+/**
+ * Record the grids which los() would test when looking from the origin to
+ * d.  This has to mirror los() exactly.
+ * \param d is the offset of the target.
+ * \param line is set to the knight's move shortcut, if any, and the number
+ * of steps.
+ * \param steps if not NULL, receives the steps.
+ */
+static void trace_los(struct loc d, struct view_line *line,
+		struct view_step *steps)
+{
+	int ax = ABS(d.x), ay = ABS(d.y);
+	int sx = (d.x < 0) ? -1 : 1, sy = (d.y < 0) ? -1 : 1;
+	int n = 0, tx, ty, f1, f2, m, q;
+
+#define VIEW_STEP(px, py) \
+	do { \
+		if (steps) { \
+			steps[n].x = (px); \
+			steps[n].y = (py); \
+		} \
+		n++; \
+	} while (0)
+
+	line->has_knight = false;
+	line->n_steps = 0;
+
+	/* Adjacent (or identical) grids */
+	if ((ax < 2) && (ay < 2)) return;
+
+	/* Directly South/North or directly East/West */
+	if (!d.x) {
+		for (ty = sy; ty != d.y; ty += sy) VIEW_STEP(0, ty);
+		line->n_steps = n;
+		return;
+	}
+	if (!d.y) {
+		for (tx = sx; tx != d.x; tx += sx) VIEW_STEP(tx, 0);
+		line->n_steps = n;
+		return;
+	}
+
+	/* Vertical and horizontal "knights" */
+	if ((ax == 1) && (ay == 2)) {
+		line->has_knight = true;
+		line->knight.x = 0;
+		line->knight.y = sy;
+	} else if ((ay == 1) && (ax == 2)) {
+		line->has_knight = true;
+		line->knight.x = sx;
+		line->knight.y = 0;
+	}
+
+	f2 = ax * ay;
+	f1 = f2 << 1;
+	if (ax >= ay) {
+		/* Travel horizontally */
+		q = ay * ay;
+		m = q << 1;
+		tx = sx;
+		if (q == f2) {
+			ty = sy;
+			q -= f1;
+		} else {
+			ty = 0;
+		}
+		while (d.x - tx) {
+			VIEW_STEP(tx, ty);
+			q += m;
+			if (q < f2) {
+				tx += sx;
+			} else if (q > f2) {
+				ty += sy;
+				VIEW_STEP(tx, ty);
+				q -= f1;
+				tx += sx;
+			} else {
+				ty += sy;
+				q -= f1;
+				tx += sx;
+			}
+		}
+	} else {
+		/* Travel vertically */
+		q = ax * ax;
+		m = q << 1;
+		ty = sy;
+		if (q == f2) {
+			tx = sx;
+			q -= f1;
+		} else {
+			tx = 0;
+		}
+		while (d.y - ty) {
+			VIEW_STEP(tx, ty);
+			q += m;
+			if (q < f2) {
+				ty += sy;
+			} else if (q > f2) {
+				tx += sx;
+				VIEW_STEP(tx, ty);
+				q -= f1;
+				ty += sy;
+			} else {
+				tx += sx;
+				q -= f1;
+				ty += sy;
+			}
+		}
+	}
+	line->n_steps = n;
+
+#undef VIEW_STEP
+}
+
+/**
+ * Build the table of precomputed lines of sight out to z_info->max_sight.
+ */
+static void init_view_table(void)
+{
+	int span, total = 0;
+	struct loc d;
+
+	view_table_radius = MIN(z_info->max_sight, 127);
+	span = 2 * view_table_radius + 1;
+	view_lines = mem_zalloc(span * span * sizeof(*view_lines));
+
+	/* Count the steps, then fill them in */
+	for (d.y = -view_table_radius; d.y <= view_table_radius; d.y++) {
+		for (d.x = -view_table_radius; d.x <= view_table_radius; d.x++) {
+			struct view_line *line = &view_lines[(d.y +
+				view_table_radius) * span + d.x + view_table_radius];
+
+			trace_los(d, line, NULL);
+			line->first_step = total;
+			total += line->n_steps;
+		}
+	}
+	view_steps = mem_zalloc(MAX(total, 1) * sizeof(*view_steps));
+	for (d.y = -view_table_radius; d.y <= view_table_radius; d.y++) {
+		for (d.x = -view_table_radius; d.x <= view_table_radius; d.x++) {
+			struct view_line *line = &view_lines[(d.y +
+				view_table_radius) * span + d.x + view_table_radius];
+			uint32_t first = line->first_step;
+
+			trace_los(d, line, view_steps + first);
+			line->first_step = first;
+		}
+	}
+}
+
+static void cleanup_view_table(void)
+{
+	mem_free(view_steps);
+	view_steps = NULL;
+	mem_free(view_lines);
+	view_lines = NULL;
+	view_table_radius = 0;
+}
+
+struct init_module view_module = {
+	.name = "view",
+	.init = init_view_table,
+	.cleanup = cleanup_view_table
+};
+
+/**
+ * The projectability of every grid in a rectangle of the chunk, used by
+ * view_los() in place of repeated calls to square_isprojectable()
+ */
+struct view_los {
+	struct loc min, max;
+	int width;
+	bool *proj;
+};
+
+/**
+ * Check for line of sight with los() semantics, using the precomputed
+ * lines of sight and the projectability cached in vl.
+ * \param vl is the cached projectability or NULL to fall back on los().
+ * All the grids los() would test must lie within it.
+ */
+static bool view_los(const struct view_los *vl, struct chunk *c,
+		struct loc grid1, struct loc grid2)
+{
+	int dx = grid2.x - grid1.x, dy = grid2.y - grid1.y, span, i, base;
+	const struct view_line *line;
+	const struct view_step *step;
+
+	if (!vl || ABS(dx) > view_table_radius || ABS(dy) > view_table_radius) {
+		return los(c, grid1, grid2);
+	}
+	assert(grid1.x >= vl->min.x && grid1.x <= vl->max.x
+		&& grid1.y >= vl->min.y && grid1.y <= vl->max.y
+		&& grid2.x >= vl->min.x && grid2.x <= vl->max.x
+		&& grid2.y >= vl->min.y && grid2.y <= vl->max.y);
+	span = 2 * view_table_radius + 1;
+	line = &view_lines[(dy + view_table_radius) * span + dx
+		+ view_table_radius];
+	base = (grid1.y - vl->min.y) * vl->width + grid1.x - vl->min.x;
+	if (line->has_knight && vl->proj[base + line->knight.y * vl->width
+			+ line->knight.x]) {
+		return true;
+	}
+	step = view_steps + line->first_step;
+	for (i = 0; i < line->n_steps; i++, step++) {
+		if (!vl->proj[base + step->y * vl->width + step->x]) {
+			return false;
+		}
+	}
+	return true;
+}
+
 /**
  * The comments below are still predominantly true, and have been left
  * (slightly modified for accuracy) for historical and nostalgic reasons.
@@ -289,8 +529,7 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
  * twice is inconsequential compared to the speed increase.
  *
  * Several pieces of information about each cave grid are stored in the
- * info field of the "cave->squares" array, which is a special array of
- * bitflags.
+ * "cave->sq_info" array, which holds SQUARE_SIZE bitflags for each grid.
  *
  * The "SQUARE_ROOM" flag is used to determine which grids are part of "rooms", 
  * and thus which grids are affected by "illumination" spells.
@@ -432,19 +671,28 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 
 /**
  * Mark the currently seen grids, then wipe in preparation for recalculating
+ * \param c Is the chunk to modify.
+ * \param min Is the upper left corner of the rectangle to process.
+ * \param max Is the lower right corner of the rectangle to process.
+ * \param wipe If true, also clears the view flags in the rectangle.
  */
-static void mark_wasseen(struct chunk *c)
+static void mark_wasseen(struct chunk *c, struct loc min, struct loc max,
+		bool wipe)
 {
 	int x, y;
-	/* Save the old "view" grids for later */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			struct loc grid = loc(x, y);
-			if (square_isseen(c, grid))
-				sqinfo_on(square(c, grid)->info, SQUARE_WASSEEN);
-			sqinfo_off(square(c, grid)->info, SQUARE_VIEW);
-			sqinfo_off(square(c, grid)->info, SQUARE_SEEN);
-			sqinfo_off(square(c, grid)->info, SQUARE_CLOSE_PLAYER);
+
+	/* Save the old "view" grids for later; walk the flags directly */
+	for (y = min.y; y <= max.y; y++) {
+		bitflag *info = c->sq_info + (y * c->width + min.x) * SQUARE_SIZE;
+
+		for (x = min.x; x <= max.x; x++, info += SQUARE_SIZE) {
+			if (sqinfo_has(info, SQUARE_SEEN))
+				sqinfo_on(info, SQUARE_WASSEEN);
+			if (wipe) {
+				sqinfo_off(info, SQUARE_VIEW);
+				sqinfo_off(info, SQUARE_SEEN);
+				sqinfo_off(info, SQUARE_CLOSE_PLAYER);
+			}
 		}
 	}
 }
@@ -617,25 +865,31 @@ static bool glow_can_light_wall(struct chunk *c, struct player *p,
  * \param sgrid Is the location of the light source.
  * \param radius Is the radius, in grids, of the light source.
  * \param inten Is the intensity of the light source.
+ * \param min Is the upper left corner of the rectangle to light.
+ * \param max Is the lower right corner of the rectangle to light.
+ * \param vl Is the cached projectability to use for line of sight or NULL.
  * This is a brute force approach.  Some computation probably could be saved by
  * propagating the light out from the source and terminating paths when they
  * reach a wall.
  */
 static void add_light(struct chunk *c, struct player *p, struct loc sgrid,
-		int radius, int inten)
+		int radius, int inten, struct loc min, struct loc max,
+		const struct view_los *vl)
 {
 	int y;
 
-	for (y = -radius; y <= radius; y++) {
+	for (y = MAX(-radius, min.y - sgrid.y);
+			y <= MIN(radius, max.y - sgrid.y); y++) {
 		int x;
 
-		for (x = -radius; x <= radius; x++) {
+		for (x = MAX(-radius, min.x - sgrid.x);
+				x <= MIN(radius, max.x - sgrid.x); x++) {
 			struct loc grid = loc_sum(sgrid, loc(x, y));
 			int dist = distance(sgrid, grid);
 			if (!square_in_bounds(c, grid)) continue;
 			if (dist > radius) continue;
 			/* Don't propagate the light through walls. */
-			if (!los(c, sgrid, grid)) continue;
+			if (!view_los(vl, c, sgrid, grid)) continue;
 			/*
 			 * Only light a wall if the face lit is possibly visible
 			 * to the player.
@@ -645,11 +899,11 @@ static void add_light(struct chunk *c, struct player *p, struct loc sgrid,
 			/* Adjust the light level */
 			if (inten > 0) {
 				/* Light getting less further away */
-				c->squares[grid.y][grid.x].light +=
+				c->sq_light[square_index(c, grid)] +=
 					inten - dist;
 			} else {
 				/* Light getting greater further away */
-				c->squares[grid.y][grid.x].light +=
+				c->sq_light[square_index(c, grid)] +=
 					inten + dist;
 			}
 		}
@@ -658,33 +912,45 @@ static void add_light(struct chunk *c, struct player *p, struct loc sgrid,
 
 /**
  * Calculate light level for every grid in view - stolen from Sil
+ * \param c Is the chunk to use.
+ * \param p Is the player to use.
+ * \param min Is the upper left corner of the rectangle to light.
+ * \param max Is the lower right corner of the rectangle to light.
+ * \param vl Is the cached projectability to use for line of sight or NULL.
+ * Light levels outside of the rectangle are left as they were.
  */
-static void calc_lighting(struct chunk *c, struct player *p)
+static void calc_lighting(struct chunk *c, struct player *p, struct loc min,
+		struct loc max, const struct view_los *vl)
 {
-	int dir, k, x, y;
+	int dir, k, x, y, reach;
 	int light = p->state.cur_light, radius = ABS(light) - 1;
 	int old_light = square_light(c, p->grid);
+	struct point_set *mon_grids;
 	bool sunlit = is_daytime() && outside();
 
 	/* Starting values based on permanent light */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
+	for (y = min.y; y <= max.y; y++) {
+		for (x = min.x; x <= max.x; x++) {
 			struct loc grid = loc(x, y);
+			int idx = y * c->width + x;
 
 			if (square_isglow(c, grid) &&
 					(sunlit || square_allowslos(c, grid) ||
 					glow_can_light_wall(c, p, grid, sunlit))) {
-				c->squares[y][x].light = 1;
+				c->sq_light[idx] = 1;
 			} else {
-				c->squares[y][x].light = 0;
+				c->sq_light[idx] = 0;
 			}
 
 			/* Squares with bright terrain have intensity 2 */
 			if (square_isbright(c, grid)) {
-				c->squares[y][x].light += 2;
+				c->sq_light[idx] += 2;
 				for (dir = 0; dir < 8; dir++) {
 					struct loc adj_grid = loc_sum(grid, ddgrid_ddd[dir]);
 					if (!square_in_bounds(c, adj_grid)) continue;
+					if (adj_grid.x < min.x || adj_grid.x > max.x
+							|| adj_grid.y < min.y
+							|| adj_grid.y > max.y) continue;
 					/*
 					 * Only brighten a wall if the player
 					 * is in position to view the face
@@ -694,22 +960,55 @@ static void calc_lighting(struct chunk *c, struct player *p)
 							!source_can_light_wall(
 							c, p, grid, adj_grid))
 							continue;
-					c->squares[adj_grid.y][adj_grid.x].light += 1;
+					c->sq_light[square_index(c, adj_grid)] += 1;
 				}
 			}
 		}
 	}
 
+	/*
+	 * Bright terrain just outside of the rectangle can brighten grids at
+	 * its edge.  Mimic the loop above, where the starting value for a
+	 * grid overwrites what came from neighbors earlier in the scan.
+	 */
+	for (y = min.y - 1; y <= max.y + 1; y++) {
+		for (x = min.x - 1; x <= max.x + 1; x++) {
+			struct loc grid = loc(x, y);
+
+			if (x >= min.x && x <= max.x && y >= min.y && y <= max.y) {
+				x = max.x;
+				continue;
+			}
+			if (!square_in_bounds(c, grid) || !square_isbright(c, grid))
+				continue;
+			for (dir = 0; dir < 8; dir++) {
+				struct loc adj_grid = loc_sum(grid, ddgrid_ddd[dir]);
+				if (adj_grid.x < min.x || adj_grid.x > max.x
+						|| adj_grid.y < min.y
+						|| adj_grid.y > max.y) continue;
+				if (adj_grid.y > y || (adj_grid.y == y
+						&& adj_grid.x > x)) continue;
+				if (!square_allowslos(c, adj_grid) &&
+						!source_can_light_wall(
+						c, p, grid, adj_grid))
+						continue;
+				c->sq_light[square_index(c, adj_grid)] += 1;
+			}
+		}
+	}
+
 	/* Light around the player */
-	add_light(c, p, p->grid, radius, light);
+	add_light(c, p, p->grid, radius, light, min, max, vl);
 
-	/* Scan monster list and add monster light or darkness */
-	for (k = 1; k < cave_monster_max(c); k++) {
-		/* Check the k'th monster */
-		struct monster *mon = cave_monster(c, k);
+	/* Add light or darkness from monsters close enough to reach the area */
+	reach = MAX(r_light_max - 1, 0);
+	mon_grids = cave_monster_grids(c, loc(min.x - reach, min.y - reach),
+		loc(max.x + reach, max.y + reach));
+	for (k = 0; k < point_set_size(mon_grids); k++) {
+		struct monster *mon = square_monster(c, mon_grids->pts[k]);
 
 		/* Skip dead monsters */
-		if (!mon->race) continue;
+		if (!mon) continue;
 
 		/* Skip if the monster is hidden */
 		if (monster_is_camouflaged(mon)) continue;
@@ -725,8 +1024,9 @@ static void calc_lighting(struct chunk *c, struct player *p)
 		if (distance(p->grid, mon->grid) - radius > z_info->max_sight)
 			continue;
 
-		add_light(c, p, mon->grid, radius, light);
+		add_light(c, p, mon->grid, radius, light, min, max, vl);
 	}
+	point_set_dispose(mon_grids);
 
 	/* Update light level indicator */
 	if (square_light(c, p->grid) != old_light) {
@@ -747,10 +1047,10 @@ static void become_viewable(struct chunk *c, struct loc grid, struct player *p,
 	if (square_isview(c, grid)) return;
 
 	/* Add the grid to the view, make seen if it's close enough to the player */
-	sqinfo_on(square(c, grid)->info, SQUARE_VIEW);
+	sqinfo_on(square_info(c, grid), SQUARE_VIEW);
 	if (close) {
-		sqinfo_on(square(c, grid)->info, SQUARE_SEEN);
-		sqinfo_on(square(c, grid)->info, SQUARE_CLOSE_PLAYER);
+		sqinfo_on(square_info(c, grid), SQUARE_SEEN);
+		sqinfo_on(square_info(c, grid), SQUARE_CLOSE_PLAYER);
 	}
 
 	/* Mark lit grids, and walls near to them, as seen */
@@ -760,10 +1060,10 @@ static void become_viewable(struct chunk *c, struct loc grid, struct player *p,
 			int xc = (x < p->grid.x) ? (x + 1) : (x > p->grid.x) ? (x - 1) : x;
 			int yc = (y < p->grid.y) ? (y + 1) : (y > p->grid.y) ? (y - 1) : y;
 			if (square_islit(c, loc(xc, yc))) {
-				sqinfo_on(square(c, grid)->info, SQUARE_SEEN);
+				sqinfo_on(square_info(c, grid), SQUARE_SEEN);
 			}
 		} else {
-			sqinfo_on(square(c, grid)->info, SQUARE_SEEN);
+			sqinfo_on(square_info(c, grid), SQUARE_SEEN);
 		}
 	}
 }
@@ -771,7 +1071,8 @@ static void become_viewable(struct chunk *c, struct loc grid, struct player *p,
 /**
  * Decide whether to include a square in the current view
  */
-static void update_view_one(struct chunk *c, struct loc grid, struct player *p)
+static void update_view_one(struct chunk *c, struct loc grid, struct player *p,
+		const struct view_los *vl)
 {
 	int x = grid.x;
 	int y = grid.y;
@@ -835,7 +1136,7 @@ static void update_view_one(struct chunk *c, struct loc grid, struct player *p)
 		}
 	}
 
-	if (los(c, p->grid, loc(xc, yc)))
+	if (view_los(vl, c, p->grid, loc(xc, yc)))
 		become_viewable(c, grid, p, close);
 }
 
@@ -846,8 +1147,8 @@ static void update_one(struct chunk *c, struct loc grid, struct player *p)
 {
 	/* Remove view if blind, check visible squares for traps */
 	if (p->timed[TMD_BLIND]) {
-		sqinfo_off(square(c, grid)->info, SQUARE_SEEN);
-		sqinfo_off(square(c, grid)->info, SQUARE_CLOSE_PLAYER);
+		sqinfo_off(square_info(c, grid), SQUARE_SEEN);
+		sqinfo_off(square_info(c, grid), SQUARE_CLOSE_PLAYER);
 	} else if (square_isseen(c, grid)) {
 		square_reveal_trap(c, grid, false, true);
 	}
@@ -856,7 +1157,7 @@ static void update_one(struct chunk *c, struct loc grid, struct player *p)
 	if (square_isseen(c, grid) && !square_wasseen(c, grid)) {
 		if (square_isfeel(c, grid)) {
 			c->feeling_squares++;
-			sqinfo_off(square(c, grid)->info, SQUARE_FEEL);
+			sqinfo_off(square_info(c, grid), SQUARE_FEEL);
 			/* Don't display feeling if it will display for the new level */
 			if (((c->feeling_squares & 0xff) == z_info->feeling_need) &&
 				!p->upkeep->only_partial) {
@@ -873,49 +1174,416 @@ static void update_one(struct chunk *c, struct loc grid, struct player *p)
 	if (!square_isseen(c, grid) && square_wasseen(c, grid))
 		square_light_spot(c, grid);
 
-	sqinfo_off(square(c, grid)->info, SQUARE_WASSEEN);
+	sqinfo_off(square_info(c, grid), SQUARE_WASSEEN);
 }
 
 /**
- * Update the player's current view
+ * Set the view flags for the player's own grid.
  */
-void update_view(struct chunk *c, struct player *p)
+static void view_player_grid(struct chunk *c, struct player *p)
 {
-	int x, y;
-
-	/* Record the current view */
-	mark_wasseen(c);
-
-	/* Calculate light levels */
-	calc_lighting(c, p);
-
-	/* Assume we can view the player grid */
-	sqinfo_on(square(c, p->grid)->info, SQUARE_VIEW);
+	sqinfo_on(square_info(c, p->grid), SQUARE_VIEW);
 	if (p->state.cur_light > 0 || square_islit(c, p->grid) ||
 		player_has(p, PF_UNLIGHT) || player_of_has(p, OF_DARKNESS)) {
-		sqinfo_on(square(c, p->grid)->info, SQUARE_SEEN);
-		sqinfo_on(square(c, p->grid)->info, SQUARE_CLOSE_PLAYER);
+		sqinfo_on(square_info(c, p->grid), SQUARE_SEEN);
+		sqinfo_on(square_info(c, p->grid), SQUARE_CLOSE_PLAYER);
 	}
-	/*
-	 * If the player is blind and in terrain that was remembered to be
-	 * impassable, forget the remembered terrain.  This will have to be
-	 * modified in variants that have timed effects which allow a player
-	 * to move through impassable terrain.
-	 */
+}
+
+/**
+ * If the player is blind and in terrain that was remembered to be
+ * impassable, forget the remembered terrain.  This will have to be
+ * modified in variants that have timed effects which allow a player
+ * to move through impassable terrain.
+ */
+static void view_forget_blind(struct chunk *c, struct player *p)
+{
 	if (p->timed[TMD_BLIND] && square_isknown(c, p->grid)
 			&& !square_ispassable(p->cave, p->grid)) {
 		square_forget(c, p->grid);
 	}
+}
+
+/**
+ * Compute the view flags and light levels for the whole chunk the
+ * straightforward way:  every grid gets its own los() trace.  This leaves
+ * out the per-grid bookkeeping done by update_one().
+ */
+static void update_view_brute(struct chunk *c, struct player *p)
+{
+	struct loc min = loc(0, 0), max = loc(c->width - 1, c->height - 1);
+	struct loc grid;
+
+	mark_wasseen(c, min, max, true);
+	calc_lighting(c, p, min, max, NULL);
+	view_player_grid(c, p);
+	for (grid.y = 0; grid.y < c->height; grid.y++)
+		for (grid.x = 0; grid.x < c->width; grid.x++)
+			update_view_one(c, grid, p, NULL);
+}
+
+/**
+ * State kept with a chunk between calls to update_view()
+ */
+struct view_light {
+	struct loc grid;
+	int light;
+};
+
+struct view_state {
+	/* Whether the rest is from a completed update */
+	bool valid;
+
+	/* What the last update depended on */
+	struct loc pgrid;
+	int cur_light;
+	int lev;
+	bool unlight;
+	bool blind;
+	bool sunlit;
+	struct view_light *lights;
+	int n_lights;
+
+	/* The rectangle within view range of the player at the last update */
+	struct loc box_min, box_max;
+
+	/*
+	 * Terrain and square flags, as of the end of the last update, in the
+	 * rectangle that affects the view
+	 */
+	struct loc snap_min, snap_max;
+	uint8_t *snap_feat;
+	bitflag *snap_info;
+	size_t snap_alloc;
+
+	/* Scratch space */
+	struct view_light *new_lights;
+	int n_new_lights;
+	int lights_alloc;
+	struct view_los vl;
+	size_t proj_alloc;
+};
+
+bool view_differential_check = false;
+int view_differential_mismatches = 0;
+
+/**
+ * Get the rectangle of grids within range of a grid, clipped to the chunk.
+ */
+static void view_box(struct chunk *c, struct loc centre, int range,
+		struct loc *min, struct loc *max)
+{
+	min->x = MAX(centre.x - range, 0);
+	min->y = MAX(centre.y - range, 0);
+	max->x = MIN(centre.x + range, c->width - 1);
+	max->y = MIN(centre.y + range, c->height - 1);
+}
+
+/**
+ * Collect the monster light sources that calc_lighting() will use into
+ * vs->new_lights.
+ * \return the largest radius of those sources, but at least one.
+ */
+static int view_gather_lights(struct chunk *c, struct player *p,
+		struct view_state *vs)
+{
+	int k, margin = 1;
+
+	vs->n_new_lights = 0;
+	for (k = 1; k < cave_monster_max(c); k++) {
+		struct monster *mon = cave_monster(c, k);
+		int light, radius;
+
+		/* Same tests as calc_lighting() */
+		if (!mon->race) continue;
+		if (monster_is_camouflaged(mon)) continue;
+		light = mon->race->light;
+		radius = ABS(light) - 1;
+		if (!light) continue;
+		if (distance(p->grid, mon->grid) - radius > z_info->max_sight)
+			continue;
+
+		if (vs->n_new_lights == vs->lights_alloc) {
+			vs->lights_alloc = MAX(8, 2 * vs->lights_alloc);
+			vs->new_lights = mem_realloc(vs->new_lights,
+				vs->lights_alloc * sizeof(*vs->new_lights));
+			vs->lights = mem_realloc(vs->lights,
+				vs->lights_alloc * sizeof(*vs->lights));
+		}
+		vs->new_lights[vs->n_new_lights].grid = mon->grid;
+		vs->new_lights[vs->n_new_lights].light = light;
+		vs->n_new_lights++;
+		margin = MAX(margin, radius);
+	}
+	return margin;
+}
+
+/**
+ * Make the light sources gathered for this update the remembered ones.
+ */
+static void view_swap_lights(struct view_state *vs)
+{
+	struct view_light *tmp = vs->lights;
+
+	vs->lights = vs->new_lights;
+	vs->n_lights = vs->n_new_lights;
+	vs->new_lights = tmp;
+}
+
+/**
+ * Check whether the terrain and square flags in vs->vl's rectangle are the
+ * same as at the end of the last update.
+ */
+static bool view_snapshot_matches(struct chunk *c, struct view_state *vs)
+{
+	int w = vs->vl.max.x - vs->vl.min.x + 1, y, i = 0;
 
-	/* Squares we have LOS to get marked as in the view, and perhaps seen */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
-			update_view_one(c, loc(x, y), p);
+	if (!loc_eq(vs->snap_min, vs->vl.min)
+			|| !loc_eq(vs->snap_max, vs->vl.max)) {
+		return false;
+	}
+	for (y = vs->vl.min.y; y <= vs->vl.max.y; y++, i += w) {
+		int start = y * c->width + vs->vl.min.x;
+
+		if (memcmp(vs->snap_feat + i, c->sq_feat + start,
+				w * sizeof(*c->sq_feat))
+				|| memcmp(vs->snap_info + i * SQUARE_SIZE,
+				c->sq_info + start * SQUARE_SIZE,
+				w * SQUARE_SIZE * sizeof(*c->sq_info))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Copy the terrain and square flags in vs->vl's rectangle.
+ */
+static void view_take_snapshot(struct chunk *c, struct view_state *vs)
+{
+	int w = vs->vl.max.x - vs->vl.min.x + 1, y, i = 0;
+	size_t n = (size_t)w * (vs->vl.max.y - vs->vl.min.y + 1);
+
+	if (n > vs->snap_alloc) {
+		vs->snap_alloc = n;
+		vs->snap_feat = mem_realloc(vs->snap_feat,
+			n * sizeof(*vs->snap_feat));
+		vs->snap_info = mem_realloc(vs->snap_info,
+			n * SQUARE_SIZE * sizeof(*vs->snap_info));
+	}
+	for (y = vs->vl.min.y; y <= vs->vl.max.y; y++, i += w) {
+		int start = y * c->width + vs->vl.min.x;
+
+		memcpy(vs->snap_feat + i, c->sq_feat + start,
+			w * sizeof(*c->sq_feat));
+		memcpy(vs->snap_info + i * SQUARE_SIZE,
+			c->sq_info + start * SQUARE_SIZE,
+			w * SQUARE_SIZE * sizeof(*c->sq_info));
+	}
+	vs->snap_min = vs->vl.min;
+	vs->snap_max = vs->vl.max;
+}
+
+/**
+ * Record which grids in vs->vl's rectangle are projectable.
+ */
+static void view_cache_projectable(struct chunk *c, struct view_state *vs)
+{
+	struct loc grid;
+	size_t n;
+	bool *proj;
+
+	vs->vl.width = vs->vl.max.x - vs->vl.min.x + 1;
+	n = (size_t)vs->vl.width * (vs->vl.max.y - vs->vl.min.y + 1);
+	if (n > vs->proj_alloc) {
+		vs->proj_alloc = n;
+		vs->vl.proj = mem_realloc(vs->vl.proj, n * sizeof(bool));
+	}
+	proj = vs->vl.proj;
+	for (grid.y = vs->vl.min.y; grid.y <= vs->vl.max.y; grid.y++)
+		for (grid.x = vs->vl.min.x; grid.x <= vs->vl.max.x; grid.x++)
+			*proj++ = square_isprojectable(c, grid);
+}
+
+/**
+ * Compare the view flags against those from update_view_brute() and the
+ * light levels in the rectangle in view range, counting the differences
+ * in view_differential_mismatches.
+ */
+static void view_compare(struct chunk *c, struct loc min, struct loc max,
+		const bitflag *check_info, const int *check_light)
+{
+	int flags[] = { SQUARE_VIEW, SQUARE_SEEN, SQUARE_CLOSE_PLAYER };
+	int i, j, n = c->height * c->width;
+
+	for (i = 0; i < n; i++) {
+		const bitflag *a = c->sq_info + i * SQUARE_SIZE;
+		const bitflag *b = check_info + i * SQUARE_SIZE;
+		int x = i % c->width, y = i / c->width;
+
+		for (j = 0; j < (int)N_ELEMENTS(flags); j++) {
+			if (sqinfo_has(a, flags[j]) != sqinfo_has(b, flags[j])) {
+				view_differential_mismatches++;
+			}
+		}
+		if (x >= min.x && x <= max.x && y >= min.y && y <= max.y
+				&& c->sq_light[i] != check_light[i]) {
+			view_differential_mismatches++;
+		}
+	}
+}
+
+/**
+ * Update the player's current view
+ *
+ * Only the rectangle within z_info->max_sight of the player is recomputed,
+ * along with whatever was in view after the last update.  If nothing that
+ * affects the view has changed since then, the light levels and lines of
+ * sight are reused.  Setting view_differential_check compares the results
+ * against update_view_brute() on every call.
+ */
+void update_view(struct chunk *c, struct player *p)
+{
+	struct view_state *vs;
+	struct loc bmin, bmax, rmin, rmax, grid;
+	bitflag *check_info = NULL;
+	int *check_light = NULL;
+	int margin;
+	bool reuse;
+
+	if (!c->view) {
+		c->view = mem_zalloc(sizeof(*c->view));
+	}
+	vs = c->view;
+
+	/*
+	 * Get the rectangle that could be in view and, allowing for the
+	 * light sources around it, the rectangle which affects the view.
+	 */
+	margin = view_gather_lights(c, p, vs);
+	view_box(c, p->grid, z_info->max_sight, &bmin, &bmax);
+	view_box(c, p->grid, z_info->max_sight + margin, &vs->vl.min,
+		&vs->vl.max);
+
+	/* Check whether anything relevant changed since the last update */
+	reuse = vs->valid && loc_eq(vs->pgrid, p->grid)
+		&& vs->cur_light == p->state.cur_light
+		&& vs->lev == p->lev
+		&& vs->unlight == (player_has(p, PF_UNLIGHT)
+			|| player_of_has(p, OF_DARKNESS))
+		/* Blindness wipes what update_one() sees, so can't reuse */
+		&& !vs->blind && !p->timed[TMD_BLIND]
+		&& vs->sunlit == (is_daytime() && outside())
+		&& vs->n_lights == vs->n_new_lights
+		&& !memcmp(vs->lights, vs->new_lights,
+			vs->n_lights * sizeof(*vs->lights))
+		&& view_snapshot_matches(c, vs);
+
+	if (view_differential_check) {
+		size_t n = c->height * c->width;
+		bitflag *orig_info = mem_alloc(n * SQUARE_SIZE * sizeof(bitflag));
+		int *orig_light = mem_alloc(n * sizeof(int));
+
+		/* Do it the slow way, then put things back */
+		memcpy(orig_info, c->sq_info, n * SQUARE_SIZE * sizeof(bitflag));
+		memcpy(orig_light, c->sq_light, n * sizeof(int));
+		update_view_brute(c, p);
+		check_info = c->sq_info;
+		check_light = c->sq_light;
+		c->sq_info = orig_info;
+		c->sq_light = orig_light;
+	}
+
+	/*
+	 * Outside of the current rectangle and the one from the last
+	 * update, there is nothing in view.  Without a last update, do
+	 * everything.
+	 */
+	if (vs->valid) {
+		rmin.x = MIN(bmin.x, vs->box_min.x);
+		rmin.y = MIN(bmin.y, vs->box_min.y);
+		rmax.x = MAX(bmax.x, vs->box_max.x);
+		rmax.y = MAX(bmax.y, vs->box_max.y);
+	} else {
+		rmin = loc(0, 0);
+		rmax = loc(c->width - 1, c->height - 1);
+	}
+
+	if (reuse) {
+		/* The view is unchanged; just record it */
+		mark_wasseen(c, bmin, bmax, false);
+		rmin = bmin;
+		rmax = bmax;
+	} else {
+		/* Record the current view */
+		mark_wasseen(c, rmin, rmax, true);
+
+		/* Cache what can be seen through */
+		view_cache_projectable(c, vs);
+
+		/* Calculate light levels */
+		calc_lighting(c, p, bmin, bmax, &vs->vl);
+		if (!vs->valid || p->grid.x < vs->box_min.x
+				|| p->grid.x > vs->box_max.x
+				|| p->grid.y < vs->box_min.y
+				|| p->grid.y > vs->box_max.y) {
+			/* The old light level at the player's grid is stale */
+			p->upkeep->redraw |= PR_LIGHT;
+		}
+
+		/* Assume we can view the player grid */
+		view_player_grid(c, p);
+	}
+
+	view_forget_blind(c, p);
+
+	if (!reuse) {
+		/*
+		 * Squares we have LOS to get marked as in the view, and
+		 * perhaps seen
+		 */
+		for (grid.y = bmin.y; grid.y <= bmax.y; grid.y++)
+			for (grid.x = bmin.x; grid.x <= bmax.x; grid.x++)
+				update_view_one(c, grid, p, &vs->vl);
+	}
+
+	if (view_differential_check) {
+		view_compare(c, bmin, bmax, check_info, check_light);
+		mem_free(check_info);
+		mem_free(check_light);
+	}
 
 	/* Update each grid */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
-			update_one(c, loc(x, y), p);
+	for (grid.y = rmin.y; grid.y <= rmax.y; grid.y++)
+		for (grid.x = rmin.x; grid.x <= rmax.x; grid.x++)
+			update_one(c, grid, p);
+
+	/* Remember what this update used */
+	vs->valid = true;
+	vs->pgrid = p->grid;
+	vs->cur_light = p->state.cur_light;
+	vs->lev = p->lev;
+	vs->unlight = player_has(p, PF_UNLIGHT) || player_of_has(p, OF_DARKNESS);
+	vs->blind = (p->timed[TMD_BLIND] != 0);
+	vs->sunlit = is_daytime() && outside();
+	view_swap_lights(vs);
+	vs->box_min = bmin;
+	vs->box_max = bmax;
+	view_take_snapshot(c, vs);
+}
+
+/**
+ * Release the view state for a chunk.
+ */
+void view_state_free(struct view_state *vs)
+{
+	if (!vs) return;
+	mem_free(vs->lights);
+	mem_free(vs->new_lights);
+	mem_free(vs->snap_feat);
+	mem_free(vs->snap_info);
+	mem_free(vs->vl.proj);
+	mem_free(vs);
 }
 
 
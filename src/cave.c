@@ -25,12 +25,14 @@
 #include "generate.h"
 #include "init.h"
 #include "mon-group.h"
+#include "mon-move.h"
 #include "monster.h"
 #include "obj-ignore.h"
 #include "obj-pile.h"
 #include "obj-tval.h"
 #include "obj-util.h"
 #include "object.h"
+#include "player-path.h"
 #include "player-timed.h"
 #include "trap.h"
 #include "z-queue.h"
@@ -376,46 +378,100 @@ void set_terrain(void)
 	FEAT_DUNE = lookup_feat("sand dune");
 }
 
+/**
+ * Allocate the grids for a heatmap; the rows share one block.
+ */
 uint16_t **heatmap_new(struct chunk *c)
 {
 	uint16_t **grids;
 	int y;
 	grids = mem_zalloc(c->height * sizeof(uint16_t*));
-	for (y = 0; y < c->height; y++) {
-		grids[y] = mem_zalloc(c->width * sizeof(uint16_t));
+	grids[0] = mem_zalloc(c->height * c->width * sizeof(uint16_t));
+	for (y = 1; y < c->height; y++) {
+		grids[y] = grids[0] + y * c->width;
 	}
 	return grids;
 }
 
 void heatmap_free(struct chunk *c, struct heatmap map)
 {
-	int y;
-	for (y = 0; y < c->height; y++) {
-		mem_free(map.grids[y]);
-	}
+	if (!map.grids) return;
+	mem_free(map.grids[0]);
 	mem_free(map.grids);
 }
 
+/**
+ * Widen a heatmap's bounds of non-zero grids to include a grid.
+ */
+static void heatmap_extend(struct heatmap *map, struct loc grid)
+{
+	if (!map->used) {
+		map->used = true;
+		map->min = grid;
+		map->max = grid;
+		return;
+	}
+	map->min.x = MIN(map->min.x, grid.x);
+	map->min.y = MIN(map->min.y, grid.y);
+	map->max.x = MAX(map->max.x, grid.x);
+	map->max.y = MAX(map->max.y, grid.y);
+}
+
+/**
+ * Allocate the noise and scent for a monster that others will track.
+ */
+struct flow_field *flow_field_new(struct chunk *c)
+{
+	struct flow_field *flow = mem_zalloc(sizeof(*flow));
+
+	flow->noise.grids = heatmap_new(c);
+	flow->scent.grids = heatmap_new(c);
+	return flow;
+}
+
+void flow_field_free(struct chunk *c, struct flow_field *flow)
+{
+	if (!flow) return;
+	heatmap_free(c, flow->noise);
+	heatmap_free(c, flow->scent);
+	mem_free(flow);
+}
+
+/**
+ * The number of monster blocks across a chunk, and in all
+ */
+static int mon_block_cols(struct chunk *c)
+{
+	return (c->width + MON_BLOCK_SIZE - 1) >> MON_BLOCK_SHIFT;
+}
+
+static int mon_block_count(struct chunk *c)
+{
+	return ((c->height + MON_BLOCK_SIZE - 1) >> MON_BLOCK_SHIFT)
+		* mon_block_cols(c);
+}
+
 /**
  * Allocate a new chunk of the world
  */
 struct chunk *cave_new(int height, int width) {
-	int y, x;
-
 	struct chunk *c = mem_zalloc(sizeof *c);
 	c->height = height;
 	c->width = width;
 	c->feat_count = mem_zalloc((z_info->f_max + 1) * sizeof(int));
 
-	c->squares = mem_zalloc(c->height * sizeof(struct square*));
+	c->sq_feat = mem_zalloc(height * width * sizeof(uint8_t));
+	c->sq_pred = mem_zalloc(height * width * sizeof(uint8_t));
+	if (f_info) {
+		memset(c->sq_pred, f_info[0].sq_pred, height * width);
+	}
+	c->sq_info = mem_zalloc(height * width * SQUARE_SIZE * sizeof(bitflag));
+	c->sq_light = mem_zalloc(height * width * sizeof(int));
+	c->sq_mon = mem_zalloc(height * width * sizeof(int16_t));
+	c->sq_obj = mem_zalloc(height * width * sizeof(struct object*));
+	c->sq_trap = mem_zalloc(height * width * sizeof(struct trap*));
 	c->noise.grids = heatmap_new(c);
 	c->scent.grids = heatmap_new(c);
-	for (y = 0; y < c->height; y++) {
-		c->squares[y] = mem_zalloc(c->width * sizeof(struct square));
-		for (x = 0; x < c->width; x++) {
-			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
-		}
-	}
 
 	c->objects = mem_zalloc(OBJECT_LIST_SIZE * sizeof(struct object*));
 	c->obj_max = OBJECT_LIST_SIZE - 1;
@@ -454,6 +510,8 @@ void cave_free(struct chunk *c) {
 	struct chunk *p_c = (c == cave && player) ? player->cave : NULL;
 	int y, x, i;
 
+	/* Stored chunks may have their grids packed away */
+	chunk_expand(c);
 	cave_connectors_free(c->join);
 
 	/* Look for orphaned objects and delete them. */
@@ -465,21 +523,40 @@ void cave_free(struct chunk *c) {
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			mem_free(c->squares[y][x].info);
-			if (c->squares[y][x].trap)
+			int idx = y * c->width + x;
+
+			if (c->sq_trap[idx])
 				square_free_trap(c, loc(x, y));
-			if (c->squares[y][x].obj)
-				object_pile_free(c, p_c, c->squares[y][x].obj);
+			if (c->sq_obj[idx])
+				object_pile_free(c, p_c, c->sq_obj[idx]);
 		}
-		mem_free(c->squares[y]);
 	}
-	mem_free(c->squares);
+	mem_free(c->sq_feat);
+	mem_free(c->sq_pred);
+	mem_free(c->sq_info);
+	mem_free(c->sq_light);
+	mem_free(c->sq_mon);
+	mem_free(c->sq_obj);
+	mem_free(c->sq_trap);
+	view_state_free(c->view);
+	mem_free(c->save_record);
 	heatmap_free(c, c->noise);
 	heatmap_free(c, c->scent);
+	mem_free(c->flow_queue);
+	path_workspace_free(c->path_work);
+	mem_free(c->trap_timers);
+	mem_free(c->charging);
+	if (c->mon_blocks) {
+		for (i = 0; i < mon_block_count(c); i++) {
+			mem_free(c->mon_blocks[i].grids);
+		}
+		mem_free(c->mon_blocks);
+	}
 
 	mem_free(c->feat_count);
 	mem_free(c->objects);
 	mem_free(c->monsters);
+	monster_schedule_free(c->mon_sched);
 	mem_free(c->monster_groups);
 	if (c->ghost) {
 		mem_free(c->ghost);
@@ -515,6 +592,7 @@ void list_object(struct chunk *c, struct object *obj)
 		if (c->objects[i] == NULL) {
 			c->objects[i] = obj;
 			obj->oidx = i;
+			note_charging_object(c, obj);
 			return;
 		}
 	}
@@ -524,6 +602,7 @@ void list_object(struct chunk *c, struct object *obj)
 	c->objects = mem_realloc(c->objects, newsize);
 	c->objects[c->obj_max] = obj;
 	obj->oidx = c->obj_max;
+	note_charging_object(c, obj);
 	for (i = c->obj_max + 1; i <= c->obj_max + OBJECT_LIST_INCR; i++)
 		c->objects[i] = NULL;
 	c->obj_max += OBJECT_LIST_INCR;
@@ -553,6 +632,46 @@ void delist_object(struct chunk *c, struct object *obj)
 	obj->oidx = 0;
 }
 
+/**
+ * Note that a listed object may have started charging, so it is recharged.
+ * Entries stay in the list until recharge_objects() finds them no longer
+ * charging, so this does nothing for objects already there.
+ */
+void note_charging_object(struct chunk *c, struct object *obj)
+{
+	int i;
+
+	if (!c->charging || !obj || !obj->oidx || obj->oidx >= c->obj_max
+			|| c->objects[obj->oidx] != obj) return;
+	if (!tval_can_have_timeout(obj) || !obj->timeout) return;
+	for (i = 0; i < c->charging_count; i++) {
+		if (c->charging[i] == obj->oidx) return;
+	}
+	if (c->charging_count == c->charging_size) {
+		c->charging_size *= 2;
+		c->charging = mem_realloc(c->charging,
+			c->charging_size * sizeof(*c->charging));
+	}
+	c->charging[c->charging_count++] = obj->oidx;
+}
+
+/**
+ * Make the list of charging objects by looking over all the listed ones, if
+ * that hasn't been done yet
+ */
+void find_charging_objects(struct chunk *c)
+{
+	int i;
+
+	if (c->charging) return;
+	c->charging_size = 8;
+	c->charging_count = 0;
+	c->charging = mem_alloc(c->charging_size * sizeof(*c->charging));
+	for (i = 1; i < c->obj_max; i++) {
+		note_charging_object(c, c->objects[i]);
+	}
+}
+
 /**
  * Check consistency of an object list or a pair of object lists
  *
@@ -693,6 +812,93 @@ int cave_monster_count(struct chunk *c) {
 	return c->mon_cnt;
 }
 
+/**
+ * Add a grid to or remove it from the index of grids holding a monster
+ * \param c is the chunk
+ * \param grid is the grid whose monster has arrived or gone
+ * \param present is whether the grid now has a monster
+ */
+void cave_index_monster(struct chunk *c, struct loc grid, bool present)
+{
+	struct grid_bucket *block;
+	int i;
+
+	if (!c->mon_blocks) {
+		if (!present) return;
+		c->mon_blocks = mem_zalloc(mon_block_count(c)
+			* sizeof(*c->mon_blocks));
+	}
+	block = &c->mon_blocks[(grid.y >> MON_BLOCK_SHIFT) * mon_block_cols(c)
+		+ (grid.x >> MON_BLOCK_SHIFT)];
+
+	if (present) {
+		if (block->count == block->size) {
+			block->size = block->size ? 2 * block->size : 4;
+			block->grids = mem_realloc(block->grids,
+				block->size * sizeof(*block->grids));
+		}
+		block->grids[block->count++] = grid;
+		return;
+	}
+	for (i = 0; i < block->count; i++) {
+		if (loc_eq(block->grids[i], grid)) {
+			block->grids[i] = block->grids[--block->count];
+			return;
+		}
+	}
+}
+
+static int cmp_row_major(const void *a, const void *b)
+{
+	const struct loc *ga = a, *gb = b;
+
+	if (ga->y != gb->y) return ga->y - gb->y;
+	return ga->x - gb->x;
+}
+
+/**
+ * Get the grids holding a monster within a rectangle, in the order a scan of
+ * the rectangle row by row would find them; the caller disposes of the set
+ * \param c is the chunk
+ * \param top_left is the upper left corner of the rectangle
+ * \param bottom_right is the lower right corner, which is included
+ */
+struct point_set *cave_monster_grids(struct chunk *c, struct loc top_left,
+		struct loc bottom_right)
+{
+	struct point_set *grids = point_set_new(16);
+	int cols = mon_block_cols(c), by, bx, i;
+
+	top_left.x = MAX(top_left.x, 0);
+	top_left.y = MAX(top_left.y, 0);
+	bottom_right.x = MIN(bottom_right.x, c->width - 1);
+	bottom_right.y = MIN(bottom_right.y, c->height - 1);
+	if (!c->mon_blocks || top_left.x > bottom_right.x
+			|| top_left.y > bottom_right.y) {
+		return grids;
+	}
+
+	for (by = top_left.y >> MON_BLOCK_SHIFT;
+			by <= bottom_right.y >> MON_BLOCK_SHIFT; by++) {
+		for (bx = top_left.x >> MON_BLOCK_SHIFT;
+				bx <= bottom_right.x >> MON_BLOCK_SHIFT; bx++) {
+			struct grid_bucket *block = &c->mon_blocks[by * cols + bx];
+
+			for (i = 0; i < block->count; i++) {
+				struct loc grid = block->grids[i];
+
+				if (grid.x < top_left.x || grid.x > bottom_right.x
+						|| grid.y < top_left.y
+						|| grid.y > bottom_right.y) continue;
+				add_to_point_set(grids, grid);
+			}
+		}
+	}
+	sort(grids->pts, point_set_size(grids), sizeof(*grids->pts),
+		cmp_row_major);
+	return grids;
+}
+
 /**
  * Return the number of matching grids around (or under) the character.
  * \param grid If not NULL, *grid is set to the location of the last match.
@@ -797,45 +1003,73 @@ struct loc cave_find_decoy(struct chunk *c)
  * they can detect.
  *
  * Update: Monsters can also have noise heatmaps generated for them
+ *
+ * The map is only recomputed when the source, the grid the noise must skip,
+ * the increment or the terrain that blocks noise has changed since the last
+ * time.  The queue is kept with the chunk, and only the rectangle the last
+ * noise reached is cleared.
  */
 void make_noise(struct chunk *c, struct player *p, struct monster *mon)
 {
 	struct loc next = p ? p->grid : mon->grid;
-	int y, x, d;
-	int noise = 0;
+	struct loc skip = p ? player->grid : mon->grid;
+	int y, d;
 	int noise_increment = p && p->timed[TMD_COVERTRACKS] ? 4 : 1;
-    struct queue *queue = q_new(c->height * c->width);
 	struct loc decoy = cave_find_decoy(c);
-	struct heatmap noise_map = p ? c->noise : mon->noise;
-
-	/* Set all the grids to silence */
-	for (y = 1; y < c->height - 1; y++) {
-		for (x = 1; x < c->width - 1; x++) {
-			noise_map.grids[y][x] = 0;
-		}
-	}
+	struct heatmap *noise_map = p ? &c->noise : &mon->flow->noise;
+	int *queue;
+	int head = 0, tail = 0;
 
 	/* If there's a decoy, use that instead of the player */
 	if (p && !loc_is_zero(decoy)) {
 		next = decoy;
 	}
 
+	/* Nothing has changed */
+	if (noise_map->valid && loc_eq(noise_map->source, next)
+			&& loc_eq(noise_map->skip, skip)
+			&& noise_map->increment == noise_increment
+			&& noise_map->flow_changes == c->flow_changes) {
+		return;
+	}
+	noise_map->valid = true;
+	noise_map->source = next;
+	noise_map->skip = skip;
+	noise_map->increment = noise_increment;
+	noise_map->flow_changes = c->flow_changes;
+
+	/* Set all the grids the last noise reached to silence */
+	if (noise_map->used) {
+		for (y = noise_map->min.y; y <= noise_map->max.y; y++) {
+			memset(&noise_map->grids[y][noise_map->min.x], 0,
+				(noise_map->max.x - noise_map->min.x + 1)
+				* sizeof(uint16_t));
+		}
+		noise_map->used = false;
+	}
+
+	if (!c->flow_queue) {
+		c->flow_queue = mem_alloc((c->height * c->width + 1)
+			* sizeof(int));
+	}
+	queue = c->flow_queue;
+
 	/* Player/monster makes noise */
-	noise_map.grids[next.y][next.x] = noise;
-	q_push_int(queue, grid_to_i(next, c->width));
-	noise += noise_increment;
+	noise_map->grids[next.y][next.x] = 0;
+	heatmap_extend(noise_map, next);
+	queue[tail++] = grid_to_i(next, c->width);
+
+	/*
+	 * Propagate noise; a grid is only queued when it gets noise, so
+	 * apart from the source grid (which can get noise later, if it
+	 * isn't the grid skipped) each is queued at most once
+	 */
+	while (head < tail) {
+		int noise;
 
-	/* Propagate noise */
-	while (q_len(queue) > 0) {
 		/* Get the next grid */
-		i_to_grid(q_pop_int(queue), c->width, &next);
-
-		/* If we've reached the current noise level, put it back and step */
-		if (noise_map.grids[next.y][next.x] == noise) {
-			q_push_int(queue, grid_to_i(next, c->width));
-			noise += noise_increment;
-			continue;
-		}
+		i_to_grid(queue[head++], c->width, &next);
+		noise = noise_map->grids[next.y][next.x] + noise_increment;
 
 		/* Assign noise to the children and enqueue them */
 		for (d = 0; d < 8; d++)	{
@@ -848,24 +1082,19 @@ void make_noise(struct chunk *c, struct player *p, struct monster *mon)
 			if (square_isnoflow(c, grid)) continue;
 
 			/* Skip grids that already have noise */
-			if (noise_map.grids[grid.y][grid.x] != 0) continue;
+			if (noise_map->grids[grid.y][grid.x] != 0) continue;
 
 			/* Skip the player/monster grid */
-			if (p && loc_eq(player->grid, grid)) {
-				continue;
-			} else if (mon && loc_eq(mon->grid, grid)) {
-				continue;
-			}
+			if (loc_eq(skip, grid)) continue;
 
 			/* Save the noise */
-			noise_map.grids[grid.y][grid.x] = noise;
+			noise_map->grids[grid.y][grid.x] = noise;
+			heatmap_extend(noise_map, grid);
 
 			/* Enqueue that entry */
-			q_push_int(queue, grid_to_i(grid, c->width));
+			queue[tail++] = grid_to_i(grid, c->width);
 		}
 	}
-
-	q_free(queue);
 }
 
 /**
@@ -892,13 +1121,18 @@ void update_scent(struct chunk *c, struct player *p, struct monster *mon)
 		{2, 1, 1, 1, 2},
 		{2, 2, 2, 2, 2},
 	};
-	struct heatmap scent_map = p ? c->scent : mon->scent;
+	struct heatmap *scent_map = p ? &c->scent : &mon->flow->scent;
+
+	/* Update scent for all grids that have any */
+	if (scent_map->used) {
+		int y_max = MIN(scent_map->max.y, c->height - 2);
+		int x_max = MIN(scent_map->max.x, c->width - 2);
 
-	/* Update scent for all grids */
-	for (y = 1; y < c->height - 1; y++) {
-		for (x = 1; x < c->width - 1; x++) {
-			if (scent_map.grids[y][x] > 0) {
-				scent_map.grids[y][x]++;
+		for (y = MAX(scent_map->min.y, 1); y <= y_max; y++) {
+			for (x = MAX(scent_map->min.x, 1); x <= x_max; x++) {
+				if (scent_map->grids[y][x] > 0) {
+					scent_map->grids[y][x]++;
+				}
 			}
 		}
 	}
@@ -936,7 +1170,7 @@ void update_scent(struct chunk *c, struct player *p, struct monster *mon)
 				}
 
 				/* Adjacent to a closer grid, so valid */
-				if (scent_map.grids[adj.y][adj.x] == new_scent - 1) {
+				if (scent_map->grids[adj.y][adj.x] == new_scent - 1) {
 					add_scent = true;
 				}
 			}
@@ -947,7 +1181,8 @@ void update_scent(struct chunk *c, struct player *p, struct monster *mon)
 			}
 
 			/* Mark the scent */
-			scent_map.grids[scent.y][scent.x] = new_scent;
+			scent_map->grids[scent.y][scent.x] = new_scent;
+			heatmap_extend(scent_map, scent);
 		}
 	}
 }
@@ -25,6 +25,9 @@
 struct player;
 struct monster;
 struct monster_group;
+struct view_state;
+struct path_workspace;
+struct monster_schedule;
 
 extern const int16_t ddd[9];
 extern const int16_t ddx[10];
@@ -100,6 +103,22 @@ enum
 
 #define tf_has(f, flag)        flag_has_dbg(f, TF_SIZE, flag, #f, #flag)
 
+/**
+ * Test a terrain flag of a feature index with a single load and mask, using
+ * the flag word filled in when terrain.txt is read
+ */
+#define feat_has(feat, flag)   ((f_info[feat].tf_bits >> (flag)) & 1)
+
+/**
+ * Bits of the per-grid predicate plane (chunk.sq_pred), each a copy of the
+ * matching terrain flag of the grid's feature
+ */
+enum {
+	SQUARE_PRED_PASSABLE = 0x01,
+	SQUARE_PRED_PROJECT = 0x02,
+	SQUARE_PRED_LOS = 0x04
+};
+
 /**
  * Information about terrain features.
  *
@@ -120,6 +139,8 @@ struct feature {
 	uint8_t dig;		/**< How hard is it to dig through? */
 
 	bitflag flags[TF_SIZE];	/**< Terrain flags */
+	uint64_t tf_bits;	/**< Terrain flags as one word, bit n for flag n */
+	uint8_t sq_pred;	/**< SQUARE_PRED_* bits for grids of this feature */
 
 	uint8_t d_attr;	/**< Default feature attribute */
 	wchar_t d_char;	/**< Default feature character */
@@ -160,17 +181,43 @@ struct grid_data {
 	bool hallucinate;
 };
 
-struct square {
-	uint8_t feat;
-	bitflag *info;
-	int light;
-	int16_t mon;
-	struct object *obj;
-	struct trap *trap;
-};
-
+/**
+ * A noise or scent map.  Besides the values, it keeps the rectangle outside
+ * which every value is zero (so clearing or ageing the map need not visit
+ * the whole chunk) and, for noise, what the values were computed from (so
+ * make_noise() can skip the work when nothing relevant has changed).
+ */
 struct heatmap {
 	uint16_t **grids;
+	bool used;		/**< whether min and max are meaningful */
+	struct loc min, max;	/**< bounds of the non-zero grids */
+	bool valid;		/**< whether the fields below are meaningful */
+	struct loc source;	/**< where the noise came from */
+	struct loc skip;	/**< grid the noise isn't allowed into */
+	int increment;		/**< noise added per step */
+	uint32_t flow_changes;	/**< value of the chunk's flow_changes */
+};
+
+/**
+ * The noise and scent around a monster that other monsters are tracking.
+ * All the trackers share the target's field.
+ */
+struct flow_field {
+	struct heatmap noise;
+	struct heatmap scent;
+};
+
+/**
+ * The grids holding a monster in one block of a chunk; the blocks are
+ * MON_BLOCK_SIZE grids on a side, so monsters within a range can be found
+ * without visiting every grid of it
+ */
+#define MON_BLOCK_SHIFT 3
+#define MON_BLOCK_SIZE (1 << MON_BLOCK_SHIFT)
+
+struct grid_bucket {
+	struct loc *grids;
+	int count, size;
 };
 
 struct connector {
@@ -206,11 +253,43 @@ struct chunk {
 	uint16_t feeling_squares; /* How many feeling squares the player has visited */
 	int *feat_count;
 
-	struct square **squares;
+	/*
+	 * Per-grid data, kept as one flat array per field with the grid at
+	 * (y, x) at index y * width + x; sq_info holds SQUARE_SIZE bitflags
+	 * for each grid; sq_pred mirrors the SQUARE_PRED_* bits of the feature
+	 * in sq_feat and must be written along with it
+	 */
+	uint8_t *sq_feat;
+	uint8_t *sq_pred;
+	bitflag *sq_info;
+	int *sq_light;
+	int16_t *sq_mon;
+	struct object **sq_obj;
+	struct trap **sq_trap;
 	struct heatmap noise;
 	struct heatmap scent;
 	struct loc decoy;
 
+	/* Grids with a monster by block, kept by square_set_mon(), or NULL */
+	struct grid_bucket *mon_blocks;
+
+	/* Queue for make_noise(), kept between calls but not while stored */
+	int *flow_queue;
+
+	/* Scratch space for pathfinding, kept between calls but not while stored */
+	struct path_workspace *path_work;
+
+	/* Grids with a disabled trap, or NULL until they have been found */
+	struct loc *trap_timers;
+	int trap_timer_count, trap_timer_size;
+
+	/* Indices of listed objects which may be charging, or NULL until found */
+	int *charging;
+	int charging_count, charging_size;
+
+	/* Count of terrain changes which altered where noise can flow */
+	uint32_t flow_changes;
+
 	struct object **objects;
 	uint16_t obj_max;
 
@@ -219,11 +298,33 @@ struct chunk {
 	uint16_t mon_cnt;
 	int mon_current;
 	int num_repro;
+	struct monster_schedule *mon_sched;
 	struct ghost_info *ghost;
 
 	struct monster_group **monster_groups;
 
 	struct connector *join;
+
+	struct view_state *view;
+
+	/*
+	 * Generation bumped whenever the chunk enters or leaves the stored
+	 * chunk list, and its savefile record as written at save_record_gen;
+	 * stored chunks don't otherwise change, so the record can be reused
+	 */
+	uint32_t gen;
+	uint8_t *save_record;
+	uint32_t save_record_size;
+	uint32_t save_record_gen;
+
+	/*
+	 * While stored: when the chunk was last used, and its per-grid arrays
+	 * packed into memory or spilled to a file when they aren't expanded
+	 */
+	uint32_t store_used;
+	uint8_t *packed;
+	uint32_t packed_size;
+	char *spill_file;
 };
 
 /*** Feature Indexes (see "lib/gamedata/terrain.txt") ***/
@@ -284,9 +385,13 @@ extern struct chunk **chunk_list;
 extern uint16_t chunk_list_max;
 
 /* cave-view.c */
+extern bool view_differential_check;
+extern int view_differential_mismatches;
+
 int distance(struct loc grid1, struct loc grid2);
 bool los(struct chunk *c, struct loc grid1, struct loc grid2);
 void update_view(struct chunk *c, struct player *p);
+void view_state_free(struct view_state *vs);
 bool no_light(const struct player *p);
 
 /* cave-map.c */
@@ -450,7 +555,10 @@ bool square_isinemptysquare(struct chunk *c, struct loc grid);
 bool square_allows_summon(struct chunk *c, struct loc grid);
 
 
-const struct square *square(struct chunk *c, struct loc grid);
+int square_index(struct chunk *c, struct loc grid);
+int square_fidx(struct chunk *c, struct loc grid);
+bitflag *square_info(struct chunk *c, struct loc grid);
+int square_midx(struct chunk *c, struct loc grid);
 struct feature *square_feat(struct chunk *c, struct loc grid);
 int square_light(struct chunk *c, struct loc grid);
 struct monster *square_monster(struct chunk *c, struct loc grid);
@@ -518,11 +626,15 @@ int lookup_feat(const char *name);
 void set_terrain(void);
 uint16_t **heatmap_new(struct chunk *c);
 void heatmap_free(struct chunk *c, struct heatmap map);
+struct flow_field *flow_field_new(struct chunk *c);
+void flow_field_free(struct chunk *c, struct flow_field *flow);
 struct chunk *cave_new(int height, int width);
 void cave_connectors_free(struct connector *join);
 void cave_free(struct chunk *c);
 void list_object(struct chunk *c, struct object *obj);
 void delist_object(struct chunk *c, struct object *obj);
+void note_charging_object(struct chunk *c, struct object *obj);
+void find_charging_objects(struct chunk *c);
 void object_lists_check_integrity(struct chunk *c, struct chunk *c_k);
 void scatter(struct chunk *c, struct loc *place, struct loc grid, int d,
 			 bool need_los);
@@ -532,6 +644,9 @@ int scatter_ext(struct chunk *c, struct loc *places, int n, struct loc grid,
 struct monster *cave_monster(struct chunk *c, int idx);
 int cave_monster_max(struct chunk *c);
 int cave_monster_count(struct chunk *c);
+void cave_index_monster(struct chunk *c, struct loc grid, bool present);
+struct point_set *cave_monster_grids(struct chunk *c, struct loc top_left,
+		struct loc bottom_right);
 
 int count_feats(struct loc *grid,
 				bool (*test)(struct chunk *c, struct loc grid), bool under);
@@ -521,7 +521,7 @@ static bool do_cmd_close_test(struct player *p, struct loc grid)
 	}
 
 	/* Don't allow if player is in the way. */
-	if (square(cave, grid)->mon < 0) {
+	if (square_midx(cave, grid) < 0) {
 		/* Message */
 		msg("You're standing in that doorway.");
 
@@ -610,7 +610,7 @@ void do_cmd_close(struct command *cmd)
 	}
 
 	/* Monster - alert, then attack */
-	if (square(cave, grid)->mon > 0) {
+	if (square_midx(cave, grid) > 0) {
 		msg("There is a monster in the way!");
 		py_attack(player, grid);
 	} else
@@ -848,7 +848,7 @@ void do_cmd_tunnel(struct command *cmd)
 	}
 
 	/* Attack any monster we run into */
-	if (square(cave, grid)->mon > 0) {
+	if (square_midx(cave, grid) > 0) {
 		msg("There is a monster in the way!");
 		py_attack(player, grid);
 	} else {
@@ -961,7 +961,7 @@ static bool do_cmd_lock_door(struct loc grid)
 static bool do_cmd_disarm_aux(struct loc grid)
 {
 	int skill, power, chance;
-    struct trap *trap = square(cave, grid)->trap;
+    struct trap *trap = square_trap(cave, grid);
 	bool more = false;
 
 	/* Verify legality */
@@ -1197,7 +1197,7 @@ static void do_cmd_alter_aux(int dir)
 	o_chest_trapped = chest_check(player, grid, CHEST_TRAPPED);
 
 	/* Action depends on what's there */
-	if (square(cave, grid)->mon > 0) {
+	if (square_midx(cave, grid) > 0) {
 		/* Attack monster */
 		py_attack(player, grid);
 	} else if (square_isdiggable(cave, grid)) {
@@ -1260,7 +1260,7 @@ static void do_cmd_steal_aux(int dir)
 	}
 
 	/* Attack or steal from monsters */
-	if ((square(cave, grid)->mon > 0) && player_has(player, PF_STEAL)) {
+	if ((square_midx(cave, grid) > 0) && player_has(player, PF_STEAL)) {
 		steal_monster_item(square_monster(cave, grid), -1);
 	} else {
 		/* Oops */
@@ -1291,7 +1291,7 @@ void move_player(int dir, bool disarm)
 {
 	struct loc grid = loc_sum(player->grid, ddgrid[dir]);
 
-	int m_idx = square(cave, grid)->mon;
+	int m_idx = square_midx(cave, grid);
 	struct monster *mon = cave_monster(cave, m_idx);
 	bool trapsafe = player_is_trapsafe(player);
 	bool trap = square_isdisarmabletrap(cave, grid);
@@ -1438,7 +1438,7 @@ void move_player(int dir, bool disarm)
  */
 static bool do_cmd_walk_test(struct player *p, struct loc grid)
 {
-	int m_idx = square(cave, grid)->mon;
+	int m_idx = square_midx(cave, grid);
 	struct monster *mon = cave_monster(cave, m_idx);
 
 	/* Allow attack on obvious monsters if unafraid */
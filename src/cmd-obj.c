@@ -535,6 +535,7 @@ static bool use_aux(struct command *cmd, struct object *obj, enum use use,
 					charges = obj->timeout;
 					obj->timeout += randcalc(obj->time, 0,
 						RANDOMISE);
+					note_charging_object(cave, obj);
 				} else {
 					deduct_before = false;
 				}
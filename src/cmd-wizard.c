@@ -1916,7 +1916,7 @@ static void wiz_hack_map_query_feature(struct chunk *c, void *closure,
 {
 	const struct wiz_query_feature_closure *sel_feats = closure;
 	int i = 0;
-	int sq_feat = square(c, grid)->feat;
+	int sq_feat = square_fidx(c, grid);
 
 	while (1) {
 		if (i >= sel_feats->n) {
@@ -2098,7 +2098,7 @@ static void wiz_hack_map_query_square_flag(struct chunk *c, void *closure,
 	int flag = *((int*)closure);
 
 	/* With a flag, test for that.  Otherwise, test if grid is known. */
-	if ((flag && sqinfo_has(square(c, grid)->info, flag)) ||
+	if ((flag && sqinfo_has(square_info(c, grid), flag)) ||
 			(!flag && square_isknown(c, grid))) {
 		*show = true;
 		*color = (square_ispassable(c, grid)) ?
@@ -37,18 +37,28 @@ const char *parser_error_str[PARSE_ERROR_MAX] = {
 	#undef PARSE_ERROR
 };
 
+/**
+ * Parse times, kept for each call of run_parser() while parse_timing is set
+ */
+bool parse_timing = false;
+struct parse_time *parse_times = NULL;
+int parse_times_num = 0;
+
 /**
  * ------------------------------------------------------------------------
  * Angband datafile parsing routines
  * ------------------------------------------------------------------------ */
 
 errr run_parser(struct file_parser *fp) {
+	clock_t start = clock();
 	struct parser *p = fp->init();
+	struct parser_state s;
 	errr r;
 	if (!p) {
 		return PARSE_ERROR_GENERIC;
 	}
 	r = fp->run(p);
+	parser_getstate(p, &s);
 	if (!r) {
 		r = fp->finish(p);
 		if (r) {
@@ -57,9 +67,29 @@ errr run_parser(struct file_parser *fp) {
 				parser_error_str[r] : "unspecified error");
 		}
 	}
+	if (parse_timing) {
+		struct parse_time *t;
+
+		parse_times = mem_realloc(parse_times,
+			(parse_times_num + 1) * sizeof(*parse_times));
+		t = &parse_times[parse_times_num++];
+		t->name = fp->name;
+		t->lines = s.line;
+		t->seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+	}
 	return r;
 }
 
+/**
+ * Forget the parse times
+ */
+void parse_times_free(void)
+{
+	mem_free(parse_times);
+	parse_times = NULL;
+	parse_times_num = 0;
+}
+
 /**
  * The basic file parsing function.  Attempt to load filename through
  * parser and perform a quit if the file is not found.
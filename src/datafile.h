@@ -30,9 +30,22 @@ struct file_parser {
 	void (*cleanup)(void);
 };
 
+/**
+ * How long run_parser() took over a file, recorded if parse_timing is set
+ */
+struct parse_time {
+	const char *name;
+	unsigned int lines;
+	double seconds;
+};
+
 extern const char *parser_error_str[PARSE_ERROR_MAX];
+extern bool parse_timing;
+extern struct parse_time *parse_times;
+extern int parse_times_num;
 
 errr run_parser(struct file_parser *fp);
+void parse_times_free(void);
 errr parse_file_quit_not_found(struct parser *p, const char *filename);
 errr parse_file(struct parser *p, const char *filename);
 void cleanup_parser(struct file_parser *fp);
@@ -22,6 +22,7 @@
 #include "init.h"
 #include "mon-desc.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-spell.h"
 #include "mon-util.h"
 #include "obj-desc.h"
@@ -1549,14 +1550,14 @@ bool effect_handler_DESTRUCTION(effect_handler_context_t *context)
 			if (k > r) continue;
 
 			/* Lose room and vault */
-			sqinfo_off(square(cave, grid)->info, SQUARE_ROOM);
-			sqinfo_off(square(cave, grid)->info, SQUARE_VAULT);
+			sqinfo_off(square_info(cave, grid), SQUARE_ROOM);
+			sqinfo_off(square_info(cave, grid), SQUARE_VAULT);
 
 			/* Forget completely */
 			if (!square_isbright(cave, grid)) {
-				sqinfo_off(square(cave, grid)->info, SQUARE_GLOW);
+				sqinfo_off(square_info(cave, grid), SQUARE_GLOW);
 			}
-			sqinfo_off(square(cave, grid)->info, SQUARE_SEEN);
+			sqinfo_off(square_info(cave, grid), SQUARE_SEEN);
 			square_forget(cave, grid);
 			square_light_spot(cave, grid);
 
@@ -1698,14 +1699,14 @@ bool effect_handler_EARTHQUAKE(effect_handler_context_t *context)
 			if (distance(centre, grid) > r) continue;
 
 			/* Lose room and vault */
-			sqinfo_off(square(cave, grid)->info, SQUARE_ROOM);
-			sqinfo_off(square(cave, grid)->info, SQUARE_VAULT);
+			sqinfo_off(square_info(cave, grid), SQUARE_ROOM);
+			sqinfo_off(square_info(cave, grid), SQUARE_VAULT);
 
 			/* Forget completely */
 			if (!square_isbright(cave, grid)) {
-				sqinfo_off(square(cave, grid)->info, SQUARE_GLOW);
+				sqinfo_off(square_info(cave, grid), SQUARE_GLOW);
 			}
-			sqinfo_off(square(cave, grid)->info, SQUARE_SEEN);
+			sqinfo_off(square_info(cave, grid), SQUARE_SEEN);
 			square_forget(cave, grid);
 			square_light_spot(cave, grid);
 
@@ -1825,7 +1826,7 @@ bool effect_handler_EARTHQUAKE(effect_handler_context_t *context)
 			if (!map[16 + grid.y - centre.y][16 + grid.x - centre.x]) continue;
 
 			/* Process monsters */
-			if (square(cave, grid)->mon > 0) {
+			if (square_midx(cave, grid) > 0) {
 				struct monster *mon = square_monster(cave, grid);
 
 				/* Most monsters cannot co-exist with rock */
@@ -2024,6 +2025,7 @@ bool effect_handler_ENERGY_DRAIN(effect_handler_context_t *context)
 			if (!mon) continue;
 
 			/* Take the energy */
+			monster_schedule_wake(cave, mon);
 			player->energy += mon->energy;
 			mon->energy = 0;
 		}
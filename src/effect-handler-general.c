@@ -148,7 +148,7 @@ static bool has_teleport_destination_prereqs(struct chunk *c, struct loc grid,
 			return false;
 		}
 	}
-	if (square(c, grid)->mon
+	if (square_midx(c, grid)
 			|| square_isdamaging(c, grid)
 			|| square_isfall(c, grid)
 			|| square_iswebbed(c, grid)
@@ -1447,7 +1447,7 @@ bool effect_handler_DETECT_TRAPS(effect_handler_context_t *context)
 				}
 			}
 			/* Mark as trap-detected */
-			sqinfo_on(square(cave, loc(x, y))->info, SQUARE_DTRAP);
+			sqinfo_on(square_info(cave, loc(x, y)), SQUARE_DTRAP);
 		}
 	}
 
@@ -2804,7 +2804,7 @@ bool effect_handler_TELEPORT(effect_handler_context_t *context)
 	}
 
 	/* Clear any projection marker to prevent double processing */
-	sqinfo_off(square(cave, spots->grid)->info, SQUARE_PROJECT);
+	sqinfo_off(square_info(cave, spots->grid), SQUARE_PROJECT);
 
 	/* Clear monster target if it's no longer visible */
 	if (!target_able(target_get_monster())) {
@@ -2967,7 +2967,7 @@ bool effect_handler_TELEPORT_TO(effect_handler_context_t *context)
 	}
 
 	/* Clear any projection marker to prevent double processing */
-	sqinfo_off(square(cave, land)->info, SQUARE_PROJECT);
+	sqinfo_off(square_info(cave, land), SQUARE_PROJECT);
 
 	/* Lots of updates after monster_swap() */
 	handle_stuff(player);
@@ -34,6 +34,7 @@
 #include "player-calcs.h"
 #include "player-timed.h"
 #include "player-util.h"
+#include "savefile.h"
 #include "source.h"
 #include "target.h"
 #include "trap.h"
@@ -145,14 +146,44 @@ char *level_name(struct level *lev)
 	return name;
 }
 
+/**
+ * Make the table for looking levels up by name; this is an open addressing
+ * hash table, keyed by the hash of the level name, of level index + 1.
+ */
+static void level_map_index(struct level_map *map)
+{
+	int i, mask;
+
+	map->name_table_size = 2;
+	while (map->name_table_size < 2 * map->num_levels) {
+		map->name_table_size *= 2;
+	}
+	mask = map->name_table_size - 1;
+	map->name_table = mem_zalloc(map->name_table_size * sizeof(int));
+	for (i = 0; i < map->num_levels; i++) {
+		int j = djb2_hash(level_name(&map->levels[i])) & mask;
+
+		while (map->name_table[j]) {
+			j = (j + 1) & mask;
+		}
+		map->name_table[j] = i + 1;
+	}
+}
+
 /**
  * Find a level by its name
  */
 struct level *level_by_name(struct level_map *map, const char *name)
 {
-	int i;
-	for (i = 0; i < map->num_levels; i++) {
-		struct level *lev = &map->levels[i];
+	int i, mask;
+
+	if (!map->name_table) {
+		level_map_index(map);
+	}
+	mask = map->name_table_size - 1;
+	for (i = djb2_hash(name) & mask; map->name_table[i];
+			i = (i + 1) & mask) {
+		struct level *lev = &map->levels[map->name_table[i] - 1];
 		if (streq(name, level_name(lev))) {
 			return lev;
 		}
@@ -374,14 +405,19 @@ static void recharge_objects(void)
 		}
 	}
 
-	/* Recharge other level objects */
-	for (i = 1; i < cave->obj_max; i++) {
-		obj = cave->objects[i];
-		if (!obj) continue;
-
-		/* Recharge rods */
-		if (tval_can_have_timeout(obj))
+	/* Recharge level objects which are charging, dropping finished ones */
+	find_charging_objects(cave);
+	i = 0;
+	while (i < cave->charging_count) {
+		obj = cave->objects[cave->charging[i]];
+		if (obj && tval_can_have_timeout(obj)) {
 			recharge_timeout(obj);
+		}
+		if (obj && tval_can_have_timeout(obj) && obj->timeout) {
+			i++;
+		} else {
+			cave->charging[i] = cave->charging[--cave->charging_count];
+		}
 	}
 }
 
@@ -589,7 +625,7 @@ static void decrease_timeouts(void)
  */
 void process_world(struct chunk *c)
 {
-	int i, y, x;
+	int i;
 	bool was_ghost = false;
 
 	/* Compact the monster list if we're approaching the limit */
@@ -842,26 +878,7 @@ void process_world(struct chunk *c)
 		equip_learn_after_time(player);
 
 	/* Decrease trap timeouts */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			struct loc grid = loc(x, y);
-			struct trap *trap = square(c, grid)->trap;
-			bool changed = false;
-			while (trap) {
-				if (trap->timeout) {
-					trap->timeout--;
-					if (!trap->timeout) {
-						changed = true;
-					}
-				}
-				trap = trap->next;
-			}
-			if (changed && square_isseen(c, grid)) {
-				square_memorize_traps(c, grid);
-				square_light_spot(c, grid);
-			}
-		}
-	}
+	decrease_trap_timeouts(c);
 
 
 	/*** Involuntary Movement ***/
@@ -1183,6 +1200,38 @@ static void on_leave_level(void) {
 }
 
 
+/**
+ * Jump the game clock over turns in which nothing could happen but the
+ * player gaining energy.
+ *
+ * A turn can be skipped if no monster needs processing, process_world() is
+ * not due and the player will still be short of a move at the end of it.
+ * The player's energy is then added up as it would have been turn by turn,
+ * so the turn on which anything next happens is unchanged.
+ */
+static void skip_quiet_turns(void)
+{
+	int gain = turn_energy(player->state.speed);
+	int32_t skip = monster_schedule_quiet_turns(cave);
+
+	if (skip <= 0 || gain <= 0) return;
+
+	/* The world is processed every ten turns */
+	skip = MIN(skip, (turn % 10) ? 10 - (int32_t) (turn % 10) : 0);
+
+	/* The player must still be short of a move after every skipped turn */
+	if (player->energy < z_info->move_energy) {
+		skip = MIN(skip, (z_info->move_energy - player->energy - 1) / gain);
+	} else {
+		skip = 0;
+	}
+	if (skip <= 0) return;
+
+	player->energy += skip * gain;
+	monster_schedule_skip(cave, skip);
+	turn += skip;
+}
+
 /**
  * The main game loop.
  *
@@ -1191,6 +1240,9 @@ static void on_leave_level(void) {
  */
 void run_game_loop(void)
 {
+	/* Report on any save that has finished in the background */
+	savefile_background_finish(false);
+
 	/* Tidy up after the player's command */
 	process_player_cleanup();
 
@@ -1239,6 +1291,9 @@ void run_game_loop(void)
 		if (player->is_dead || !player->upkeep->playing)
 			return;
 		else if (!player->upkeep->generate_level) {
+			/* Don't spend time on turns where nothing happens */
+			skip_quiet_turns();
+
 			/* Process the rest of the monsters */
 			process_monsters(0);
 
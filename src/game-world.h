@@ -63,6 +63,8 @@ struct level_map {
 	int num_towns;
 	struct level *levels;
 	struct town *towns;
+	int *name_table;	/* Level indices + 1 by name hash, made when needed */
+	int name_table_size;
 	struct level_map *next;
 };
 
@@ -16,8 +16,8 @@
  *    and not for profit purposes provided that this copyright and statement
  *    are included in all such copies.  Other copyrights may also apply.
  *
- * In this file, we use the SQUARE_WALL flags to the info field in
- * cave->squares.  Those are usually only applied and tested on granite, but
+ * In this file, we use the SQUARE_WALL flags in the per-grid info flags of
+ * cave->sq_info.  Those are usually only applied and tested on granite, but
  * some (SQUARE_WALL_INNER) is applied and tested on permanent walls.
  * SQUARE_WALL_SOLID indicates the wall should not be tunnelled;
  * SQUARE_WALL_INNER marks an inward-facing wall of a room; SQUARE_WALL_OUTER
@@ -87,8 +87,8 @@
 static bool square_is_granite_with_flag(struct chunk *c, struct loc grid,
 										int flag)
 {
-	if (square(c, grid)->feat != FEAT_GRANITE) return false;
-	if (!sqinfo_has(square(c, grid)->info, flag)) return false;
+	if (square_fidx(c, grid) != FEAT_GRANITE) return false;
+	if (!sqinfo_has(square_info(c, grid), flag)) return false;
 
 	return true;
 }
@@ -155,19 +155,13 @@ static void reset_entrance_data(const struct chunk *c)
 	for (i = 0; i < z_info->level_room_max; ++i) {
 		dun->ent_n[i] = 0;
 	}
-	if (dun->ent2room) {
-		for (i = 0; dun->ent2room[i]; ++i) {
-			mem_free(dun->ent2room[i]);
-		}
-		mem_free(dun->ent2room);
-	}
-	/* Add a trailing NULL so the deallocation knows when to stop. */
-	dun->ent2room = mem_alloc((c->height + 1) * sizeof(*dun->ent2room));
+	/* The old table, if any, goes with the rest of the scratch memory */
+	dun->ent2room = gen_alloc((c->height + 1) * sizeof(*dun->ent2room));
 	for (i = 0; i < c->height; ++i) {
 		int j;
 
 		dun->ent2room[i] =
-			mem_alloc(c->width * sizeof(*dun->ent2room[i]));
+			gen_alloc(c->width * sizeof(*dun->ent2room[i]));
 		for (j = 0; j < c->width; ++j) {
 			dun->ent2room[i][j] = -1;
 		}
@@ -203,8 +197,9 @@ static struct loc choose_random_entrance(struct chunk *c, int ridx,
 {
 	assert(ridx >= 0 && ridx < dun->cent_n);
 	if (dun->ent_n[ridx] > 0) {
+		struct gen_arena_mark mark = gen_arena_mark();
 		int nchoice = 0;
-		int *accum = mem_alloc((dun->ent_n[ridx] + 1) *
+		int *accum = gen_alloc((dun->ent_n[ridx] + 1) *
 			sizeof(*accum));
 		int i;
 
@@ -245,7 +240,7 @@ static struct loc choose_random_entrance(struct chunk *c, int ridx,
 						 * There's an exact match.  Use
 						 * it.
 						 */
-						mem_free(accum);
+						gen_arena_release(mark);
 						return dun->ent[ridx][i];
 					}
 
@@ -275,7 +270,7 @@ static struct loc choose_random_entrance(struct chunk *c, int ridx,
 				if (low == high - 1) {
 					assert(accum[low] <= chosen &&
 						accum[high] > chosen);
-					mem_free(accum);
+					gen_arena_release(mark);
 					return dun->ent[ridx][low];
 				}
 				mid = low + (high - low) / 2;
@@ -286,7 +281,7 @@ static struct loc choose_random_entrance(struct chunk *c, int ridx,
 				}
 			}
 		}
-		mem_free(accum);
+		gen_arena_release(mark);
 	}
 
 	/* There's no satisfactory marked entrances. */
@@ -547,8 +542,8 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 		}
 
 		/* Avoid obstacles */
-		if ((square_isperm(c, tmp_grid) && !sqinfo_has(square(c,
-				tmp_grid)->info, SQUARE_WALL_INNER)) ||
+		if ((square_isperm(c, tmp_grid) && !sqinfo_has(square_info(c,
+				tmp_grid), SQUARE_WALL_INNER)) ||
 				square_is_granite_with_flag(c, tmp_grid,
 				SQUARE_WALL_SOLID)) {
 			continue;
@@ -841,7 +836,7 @@ static void try_door(struct chunk *c, struct loc grid)
  */
 static void do_traditional_tunneling(struct chunk *c)
 {
-	int *scrambled = mem_alloc(dun->cent_n * sizeof(*scrambled));
+	int *scrambled = gen_alloc(dun->cent_n * sizeof(*scrambled));
 	int i;
 	struct loc grid;
 
@@ -890,8 +885,6 @@ static void do_traditional_tunneling(struct chunk *c)
 		grid = next_grid;
 	}
 
-	mem_free(scrambled);
-
 	/* Place intersection doors. */
 	for (i = 0; i < dun->door_n; ++i) {
 		/* Try placing doors. */
@@ -985,6 +978,7 @@ static void handle_level_stairs(struct chunk *c, bool persistent,
 static int find_joinfree_vertical_seam(const struct connector *join,
 		int colpref, int range, int rowmin, int rowmax)
 {
+	struct gen_arena_mark mark = gen_arena_mark();
 	int metric = range + 1;
 	int result = -1;
 	int i;
@@ -992,7 +986,7 @@ static int find_joinfree_vertical_seam(const struct connector *join,
 	bool *disallowed;
 
 	assert(range >= 0);
-	disallowed = mem_zalloc((range + range + 1) * sizeof(*disallowed));
+	disallowed = gen_zalloc((range + range + 1) * sizeof(*disallowed));
 
 	/*
 	 * Scan the connections and record the columns that can't be in a
@@ -1027,7 +1021,7 @@ static int find_joinfree_vertical_seam(const struct connector *join,
 		}
 	}
 
-	mem_free(disallowed);
+	gen_arena_release(mark);
 
 	return result;
 }
@@ -1167,15 +1161,15 @@ struct chunk *classic_gen(struct player *p, int min_height, int min_width,
 	dun->col_blocks = c->width / dun->block_wid;
 
 	/* Initialize the room table */
-	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
+	dun->room_map = gen_zalloc(dun->row_blocks * sizeof(bool*));
 	for (i = 0; i < dun->row_blocks; i++)
-		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+		dun->room_map[i] = gen_zalloc(dun->col_blocks * sizeof(bool));
 
 	/* Initialize the block table */
-	blocks_tried = mem_zalloc(dun->row_blocks * sizeof(bool*));
+	blocks_tried = gen_zalloc(dun->row_blocks * sizeof(bool*));
 
 	for (i = 0; i < dun->row_blocks; i++)
-		blocks_tried[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+		blocks_tried[i] = gen_zalloc(dun->col_blocks * sizeof(bool));
 
 	/* No rooms yet, pits or otherwise. */
 	dun->pit_num = 0;
@@ -1249,13 +1243,6 @@ struct chunk *classic_gen(struct player *p, int min_height, int min_width,
 		}
 	}
 
-	for (i = 0; i < dun->row_blocks; i++){
-		mem_free(blocks_tried[i]);
-		mem_free(dun->room_map[i]);
-	}
-	mem_free(blocks_tried);
-	mem_free(dun->room_map);
-
 	if (built < 2) {
 		uncreate_artifacts(c);
 		wipe_mon_list(c, p);
@@ -1407,12 +1394,15 @@ static struct chunk *labyrinth_chunk(struct player *p, int h, int w, bool lit,
 	/* 'walls' is a list of wall coordinates which we will randomize */
 	int *walls;
 
+	/* Where to give back the arrays */
+	struct gen_arena_mark mark = gen_arena_mark();
+
 	/* The labyrinth chunk */
 	struct chunk *c = cave_new(h + 2, w + 2);
 	c->depth = p->depth;
 	/* allocate our arrays */
-	sets = mem_zalloc(n * sizeof(int));
-	walls = mem_zalloc(n * sizeof(int));
+	sets = gen_zalloc(n * sizeof(int));
+	walls = gen_zalloc(n * sizeof(int));
 
 	/* Bound with perma-rock */
 	draw_rectangle(c, 0, 0, h + 1, w + 1, FEAT_PERM, SQUARE_NONE, true);
@@ -1436,7 +1426,7 @@ static struct chunk *labyrinth_chunk(struct player *p, int h, int w, bool lit,
 			struct loc diag = next_grid(grid, DIR_SE);
 			sets[k_local] = k_local;
 			square_set_feat(c, diag, FEAT_FLOOR);
-			if (lit) sqinfo_on(square(c, diag)->info, SQUARE_GLOW);
+			if (lit) sqinfo_on(square_info(c, diag), SQUARE_GLOW);
 		}
 	}
 
@@ -1467,7 +1457,7 @@ static struct chunk *labyrinth_chunk(struct player *p, int h, int w, bool lit,
 			int sb = sets[b];
 			square_set_feat(c, next_grid(grid, DIR_SE), FEAT_FLOOR);
 			if (lit) {
-				sqinfo_on(square(c, next_grid(grid, DIR_SE))->info, SQUARE_GLOW);
+				sqinfo_on(square_info(c, next_grid(grid, DIR_SE)), SQUARE_GLOW);
 			}
 			for (k = 0; k < n; k++) {
 				if (sets[k] == sb) sets[k] = sa;
@@ -1476,8 +1466,7 @@ static struct chunk *labyrinth_chunk(struct player *p, int h, int w, bool lit,
 	}
 
 	/* Deallocate our lists */
-	mem_free(sets);
-	mem_free(walls);
+	gen_arena_release(mark);
 
 	/* Generate a door for every 100 squares in the labyrinth */
 	find_state = cave_find_init(loc(1, 1),
@@ -1700,7 +1689,8 @@ static void mutate_cavern(struct chunk *c) {
 	int h = c->height;
 	int w = c->width;
 
-	int *temp = mem_zalloc(h * w * sizeof(int));
+	struct gen_arena_mark mark = gen_arena_mark();
+	int *temp = gen_zalloc(h * w * sizeof(int));
 
 	for (grid.y = 1; grid.y < h - 1; grid.y++) {
 		for (grid.x = 1; grid.x < w - 1; grid.x++) {
@@ -1709,14 +1699,14 @@ static void mutate_cavern(struct chunk *c) {
 			if (square_isstairs(c, grid) ||
 					square_isperm(c, grid)) {
 				temp[grid_to_i(grid, w)] =
-					square(c, grid)->feat;
+					square_fidx(c, grid);
 			} else if (count > 5) {
 				temp[grid_to_i(grid, w)] = FEAT_GRANITE;
 			} else if (count < 4) {
 				temp[grid_to_i(grid, w)] = FEAT_FLOOR;
 			} else {
 				temp[grid_to_i(grid, w)] =
-					square(c, grid)->feat;
+					square_fidx(c, grid);
 			}
 		}
 	}
@@ -1730,7 +1720,7 @@ static void mutate_cavern(struct chunk *c) {
 		}
 	}
 
-	mem_free(temp);
+	gen_arena_release(mark);
 }
 
 /**
@@ -1761,58 +1751,36 @@ static int ignore_point(struct chunk *c, int colors[], struct loc grid) {
 }
 
 /**
- * Color a particular point, and all adjacent points.
- * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param stairs If not NULL, stairs is an array with the same number of
- * elements as counts.  At exit, stairs[i] will indicate whether the region
- * with color i includes a staircase.
- * \param grid is the location
- * \param color is the color we are coloring
- * \param diagonal controls whether we can progress diagonally
+ * Find the representative of a set in a union-find forest, halving the path
+ * on the way.
+ * \param parent is the forest; parent[i] == i for a representative
+ * \param i is the member to look up
  */
-static void build_color_point(struct chunk *c, int colors[], int counts[],
-		bool *stairs, struct loc grid, int color, bool diagonal) {
-	int h = c->height;
-	int w = c->width;
-	int size = h * w;
-	struct queue *queue = q_new(size);
-
-	int *added = mem_zalloc(size * sizeof(int));
-
-	array_filler(added, 0, size);
-
-	q_push_int(queue, grid_to_i(grid, w));
-
-	counts[color] = 0;
-
-	while (q_len(queue) > 0) {
-		int i;
-		struct loc grid1;
-		int n1 = q_pop_int(queue);
-
-		i_to_grid(n1, w, &grid1);
-
-		if (ignore_point(c, colors, grid1)) continue;
-
-		colors[n1] = color;
-		counts[color]++;
-		if (stairs && square_isstairs(c, grid1)) stairs[color] = true;
-
-		for (i = 0; i < (diagonal ? 8 : 4); i++) {
-			struct loc grid2 = loc_sum(grid1, ddgrid_ddd[i]);
-			int n2 = grid_to_i(grid2, w);
-			if (ignore_point(c, colors, grid2)) continue;
-			if (added[n2]) continue;
-
-			q_push_int(queue, n2);
-			added[n2] = 1;
-		}
+static int uf_find(int parent[], int i)
+{
+	while (parent[i] != i) {
+		parent[i] = parent[parent[i]];
+		i = parent[i];
 	}
+	return i;
+}
 
-	mem_free(added);
-	q_free(queue);
+/**
+ * Merge two sets in a union-find forest; the smaller representative is kept
+ * so results don't depend on the order of merging.
+ * \return whether the sets were different
+ */
+static bool uf_union(int parent[], int i, int j)
+{
+	i = uf_find(parent, i);
+	j = uf_find(parent, j);
+	if (i == j) return false;
+	if (i < j) {
+		parent[j] = i;
+	} else {
+		parent[i] = j;
+	}
+	return true;
 }
 
 /**
@@ -1824,23 +1792,68 @@ static void build_color_point(struct chunk *c, int colors[], int counts[],
  * elements as counts.  At exit, stairs[i] will indicate whether the region
  * with color i includes a staircase.
  * \param diagonal controls whether we can progress diagonally
+ *
+ * This is a two pass scan:  the first joins each open grid to the open
+ * neighbours already passed in a union-find forest, and the second numbers
+ * the regions in the order their first grids are met.
  */
 static void build_colors(struct chunk *c, int colors[], int counts[],
 		bool *stairs, bool diagonal)
 {
-	int y, x;
+	/* The neighbours which come earlier in the scan; diagonals last */
+	static const struct loc before[] = {
+		{ -1, 0 }, { 0, -1 }, { -1, -1 }, { 1, -1 }
+	};
 	int h = c->height;
 	int w = c->width;
+	int size = h * w;
 	int color = 1;
+	struct gen_arena_mark mark = gen_arena_mark();
+	int *parent = gen_alloc(size * sizeof(*parent));
+	int *root_color = gen_zalloc(size * sizeof(*root_color));
+	struct loc grid;
 
-	for (y = 0; y < h; y++) {
-		for (x = 0; x < w; x++) {
-			if (ignore_point(c, colors, loc(x, y))) continue;
-			build_color_point(c, colors, counts, stairs,
-				loc(x, y), color, diagonal);
-			color++;
+	for (grid.y = 0; grid.y < h; grid.y++) {
+		for (grid.x = 0; grid.x < w; grid.x++) {
+			int n = grid_to_i(grid, w);
+			int i;
+
+			if (ignore_point(c, colors, grid)) {
+				parent[n] = -1;
+				continue;
+			}
+			parent[n] = n;
+			for (i = 0; i < (diagonal ? 4 : 2); i++) {
+				struct loc grid1 = loc_sum(grid, before[i]);
+
+				if (!square_in_bounds(c, grid1)) continue;
+				if (parent[grid_to_i(grid1, w)] < 0) continue;
+				uf_union(parent, n, grid_to_i(grid1, w));
+			}
+		}
+	}
+
+	for (grid.y = 0; grid.y < h; grid.y++) {
+		for (grid.x = 0; grid.x < w; grid.x++) {
+			int n = grid_to_i(grid, w);
+			int root;
+
+			if (parent[n] < 0) continue;
+			root = uf_find(parent, n);
+			if (!root_color[root]) {
+				root_color[root] = color;
+				counts[color] = 0;
+				color++;
+			}
+			colors[n] = root_color[root];
+			counts[colors[n]]++;
+			if (stairs && square_isstairs(c, grid)) {
+				stairs[colors[n]] = true;
+			}
 		}
 	}
+
+	gen_arena_release(mark);
 }
 
 /**
@@ -1860,7 +1873,8 @@ static void clear_small_regions(struct chunk *c, int colors[], int counts[],
 	int w = c->width;
 	int size = h * w;
 
-	int *deleted = mem_zalloc(size * sizeof(int));
+	struct gen_arena_mark mark = gen_arena_mark();
+	int *deleted = gen_zalloc(size * sizeof(int));
 	array_filler(deleted, 0, size);
 
 	for (i = 0; i < size; i++) {
@@ -1881,30 +1895,7 @@ static void clear_small_regions(struct chunk *c, int colors[], int counts[],
 			set_marked_granite(c, grid, SQUARE_WALL_SOLID);
 		}
 	}
-	mem_free(deleted);
-}
-
-/**
- * Return the number of colors which have active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
- */
-static int count_colors(int counts[], int size) {
-	int i;
-	int num = 0;
-	for (i = 0; i < size; i++) if (counts[i] > 0) num++;
-	return num;
-}
-
-/**
- * Return the first color which has one or more active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
- */
-static int first_color(int counts[], int size) {
-	int i;
-	for (i = 0; i < size; i++) if (counts[i] > 0) return i;
-	return -1;
+	gen_arena_release(mark);
 }
 
 /**
@@ -1942,12 +1933,13 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 	int size = h * w;
 
 	/* Allocate a processing queue */
-	struct queue *queue = q_new(size);
+	struct gen_arena_mark mark = gen_arena_mark();
+	struct queue *queue = gen_queue_new(size);
 
 	/* Allocate an array to keep track of handled squares, and which square
 	 * we reached them from.
 	 */
-	int *previous = mem_zalloc(size * sizeof(int));
+	int *previous = gen_zalloc(size * sizeof(int));
 	array_filler(previous, -1, size);
 
 	/* Push all squares of the given color onto the queue */
@@ -2025,35 +2017,162 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 	}
 
 	/* Free the memory we've allocated */
-	q_free(queue);
-	mem_free(previous);
+	gen_arena_release(mark);
 }
 
 
 /**
- * Start connecting regions, stopping when the cave is entirely connected.
+ * Turn the path back from a grid to its region, as recorded by
+ * join_regions(), into tunnel, marking it with a distance of -1.
+ */
+static void carve_region_path(struct chunk *c, const int previous[],
+		int dist[], int n)
+{
+	while (previous[n] != n) {
+		struct loc grid;
+
+		dist[n] = -1;
+		i_to_grid(n, c->width, &grid);
+		/* Don't break permanent walls or vaults.  Also don't override
+		 * terrain that already allows passage. */
+		if (!square_isperm(c, grid) && !square_isvault(c, grid) &&
+				!(square_ispassable(c, grid) ||
+				square_isdoor(c, grid))) {
+			square_set_feat(c, grid, FEAT_FLOOR);
+		}
+		n = previous[n];
+	}
+}
+
+/**
+ * Connect all the regions, as far as walls allow.
  * \param c is the current chunk
  * \param colors is the array of current point colors
  * \param counts is the array of current color counts
  * \param allow_vault_disconnect will, if true, allows vaults to be included in
  * path planning which can leave regions disconnected
+ *
+ * Every region grows outwards through the walls at once, breadth first, and
+ * each place two growing regions meet gives a possible tunnel whose length
+ * is the sum of their distances.  Going through those from shortest to
+ * longest and digging each one that joins regions not yet connected (a
+ * minimum spanning tree, in effect) connects everything in time linear in
+ * the size of the map.  At exit every connected region has one color.
  */
 static void join_regions(struct chunk *c, int colors[], int counts[],
 		bool allow_vault_disconnect) {
+	struct meeting {
+		int n1, n2;
+	};
 	int h = c->height;
 	int w = c->width;
 	int size = h * w;
-	int num = count_colors(counts, size);
+	struct gen_arena_mark mark = gen_arena_mark();
+	int *previous = gen_alloc(size * sizeof(*previous));
+	int *dist = gen_alloc(size * sizeof(*dist));
+	int *parent = gen_alloc((size + 1) * sizeof(*parent));
+	int *queue = gen_alloc(size * sizeof(*queue));
+	int *by_length = gen_zalloc((2 * size + 2) * sizeof(*by_length));
+	struct meeting *meetings, *sorted;
+	int head = 0, tail = 0, n_meetings = 0, max_meetings = 0;
+	int i;
 
-	/* While we have multiple colors (i.e. disconnected regions), join one
-	 * of the regions to another one.
-	 */
-	while (num > 1) {
-		int color = first_color(counts, size);
-		join_region(c, colors, counts, color, -1,
-			allow_vault_disconnect);
-		num--;
+	/* Every region's grids start off the search; parent is by color */
+	for (i = 0; i <= size; i++) {
+		parent[i] = i;
+	}
+	for (i = 0; i < size; i++) {
+		if (colors[i]) {
+			previous[i] = i;
+			dist[i] = 0;
+			queue[tail++] = i;
+		} else {
+			previous[i] = -1;
+		}
 	}
+	if (!tail) {
+		gen_arena_release(mark);
+		return;
+	}
+
+	/* Each grid can meet at most four others */
+	meetings = gen_alloc(4 * size * sizeof(*meetings));
+	while (head < tail) {
+		int n1 = queue[head++];
+		struct loc grid1;
+
+		i_to_grid(n1, w, &grid1);
+		for (i = 0; i < 4; i++) {
+			struct loc grid2 = loc_sum(grid1, ddgrid_ddd[i]);
+			int n2;
+
+			if (!square_in_bounds(c, grid2)) continue;
+			n2 = grid_to_i(grid2, w);
+			if (previous[n2] >= 0) {
+				/* Somebody else got here first */
+				if (colors[n2] != colors[n1]) {
+					int length = dist[n1] + dist[n2];
+
+					meetings[n_meetings].n1 = n1;
+					meetings[n_meetings].n2 = n2;
+					n_meetings++;
+					by_length[length + 1]++;
+					max_meetings = MAX(max_meetings, length + 1);
+				}
+				continue;
+			}
+			if (square_isperm(c, grid2)) continue;
+			if (square_isvault(c, grid2) && !allow_vault_disconnect)
+				continue;
+
+			/* The region grows; unclaimed grids have color zero */
+			previous[n2] = n1;
+			dist[n2] = dist[n1] + 1;
+			colors[n2] = colors[n1];
+			queue[tail++] = n2;
+		}
+	}
+
+	/* Sort the meetings by length, keeping the order they were found in */
+	for (i = 1; i <= max_meetings; i++) {
+		by_length[i] += by_length[i - 1];
+	}
+	sorted = gen_alloc(MAX(n_meetings, 1) * sizeof(*sorted));
+	for (i = 0; i < n_meetings; i++) {
+		int length = dist[meetings[i].n1] + dist[meetings[i].n2];
+
+		sorted[by_length[length]++] = meetings[i];
+	}
+
+	/* Dig the tunnels which connect something new */
+	for (i = 0; i < n_meetings; i++) {
+		int n1 = sorted[i].n1, n2 = sorted[i].n2;
+
+		if (!uf_union(parent, colors[n1], colors[n2])) continue;
+		carve_region_path(c, previous, dist, n1);
+		carve_region_path(c, previous, dist, n2);
+	}
+
+	/* Recolor: region grids and tunnels take their set's color */
+	for (i = 0; i < size; i++) {
+		if (previous[i] < 0) continue;
+		if (previous[i] == i) {
+			int color = uf_find(parent, colors[i]);
+
+			if (color != colors[i]) {
+				--counts[colors[i]];
+				++counts[color];
+				colors[i] = color;
+			}
+		} else if (dist[i] < 0) {
+			colors[i] = uf_find(parent, colors[i]);
+			++counts[colors[i]];
+		} else {
+			colors[i] = 0;
+		}
+	}
+
+	gen_arena_release(mark);
 }
 
 
@@ -2068,14 +2187,14 @@ static void join_regions(struct chunk *c, int colors[], int counts[],
  */
 void ensure_connectedness(struct chunk *c, bool allow_vault_disconnect) {
 	int size = c->height * c->width;
-	int *colors = mem_zalloc(size * sizeof(int));
-	int *counts = mem_zalloc(size * sizeof(int));
+	struct gen_arena_mark mark = gen_arena_mark();
+	int *colors = gen_zalloc(size * sizeof(int));
+	int *counts = gen_zalloc(size * sizeof(int));
 
 	build_colors(c, colors, counts, NULL, true);
 	join_regions(c, colors, counts, allow_vault_disconnect);
 
-	mem_free(colors);
-	mem_free(counts);
+	gen_arena_release(mark);
 }
 
 
@@ -2099,9 +2218,10 @@ static struct chunk *cavern_chunk(struct player *p, int h, int w,
 	int density = rand_range(25, 40);
 	int times = rand_range(3, 6);
 
-	int *colors = mem_zalloc(size * sizeof(int));
-	int *counts = mem_zalloc(size * sizeof(int));
-	bool *stairs = (join) ? mem_zalloc(size * sizeof(*stairs)) : NULL;
+	struct gen_arena_mark mark = gen_arena_mark();
+	int *colors = gen_zalloc(size * sizeof(int));
+	int *counts = gen_zalloc(size * sizeof(int));
+	bool *stairs = (join) ? gen_zalloc(size * sizeof(*stairs)) : NULL;
 	int tries;
 
 	struct chunk *c = cave_new(h, w);
@@ -2127,9 +2247,7 @@ static struct chunk *cavern_chunk(struct player *p, int h, int w,
 
 	/* If we couldn't make a big enough cavern then fail */
 	if (tries == MAX_CAVERN_TRIES) {
-		mem_free(colors);
-		mem_free(counts);
-		mem_free(stairs);
+		gen_arena_release(mark);
 		cave_free(c);
 		return NULL;
 	}
@@ -2150,9 +2268,7 @@ static struct chunk *cavern_chunk(struct player *p, int h, int w,
 		join = join->next;
 	}
 
-	mem_free(colors);
-	mem_free(counts);
-	mem_free(stairs);
+	gen_arena_release(mark);
 
 	return c;
 }
@@ -2305,7 +2421,7 @@ static bool lot_has_shop(struct chunk *c, struct loc xroads, struct loc lot,
 
 	for (probe.x = nw_corner.x; probe.x <= se_corner.x; probe.x++) {
 		for (probe.y = nw_corner.y; probe.y <= se_corner.y; probe.y++) {
-			if (feat_is_shop(square(c, probe)->feat)) {
+			if (feat_is_shop(square_fidx(c, probe))) {
 				return true;
 			}
 		}
@@ -2668,7 +2784,7 @@ static void town_gen_layout(struct chunk *c, struct player *p, struct town *t)
 		/* Turn off room illumination flag */
 		for (grid.y = 1; grid.y < c->height - 1; grid.y++) {
 			for (grid.x = 1; grid.x < c->width - 1; grid.x++) {
-				sqinfo_off(square(c, grid)->info, SQUARE_ROOM);
+				sqinfo_off(square_info(c, grid), SQUARE_ROOM);
 				if (!square_isperm(c, grid) && !square_isfiery(c, grid) &&
 					!square_isfloor(c, grid)) {
 					square_set_feat(c, grid, FEAT_PERM);
@@ -2997,9 +3113,9 @@ static struct chunk *modified_chunk(struct player *p, int height, int width,
 	dun->col_blocks = c->width / dun->block_wid;
 
 	/* Initialize the room table */
-	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
+	dun->room_map = gen_zalloc(dun->row_blocks * sizeof(bool*));
 	for (i = 0; i < dun->row_blocks; i++)
-		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+		dun->room_map[i] = gen_zalloc(dun->col_blocks * sizeof(bool));
 
 	/* No rooms yet, pits or otherwise. */
 	dun->pit_num = 0;
@@ -3066,10 +3182,6 @@ static struct chunk *modified_chunk(struct player *p, int height, int width,
 		}
 	}
 
-	for (i = 0; i < dun->row_blocks; i++)
-		mem_free(dun->room_map[i]);
-	mem_free(dun->room_map);
-
 	/* Connect all the rooms together */
 	do_traditional_tunneling(c);
 	ensure_connectedness(c, true);
@@ -3243,9 +3355,9 @@ static struct chunk *moria_chunk(struct player *p, int height,
 	dun->col_blocks = c->width / dun->block_wid;
 
 	/* Initialize the room table */
-	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
+	dun->room_map = gen_zalloc(dun->row_blocks * sizeof(bool*));
 	for (i = 0; i < dun->row_blocks; i++)
-		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+		dun->room_map[i] = gen_zalloc(dun->col_blocks * sizeof(bool));
 
 	/* No rooms yet, pits or otherwise. */
 	dun->pit_num = 0;
@@ -3313,10 +3425,6 @@ static struct chunk *moria_chunk(struct player *p, int height,
 		}
 	}
 
-	for (i = 0; i < dun->row_blocks; i++)
-		mem_free(dun->room_map[i]);
-	mem_free(dun->room_map);
-
 	/* Connect all the rooms together */
 	do_traditional_tunneling(c);
 	ensure_connectedness(c, true);
@@ -3490,8 +3598,9 @@ static void connect_caverns(struct chunk *c, struct loc floor[])
 {
 	int i;
 	int size = c->height * c->width;
-	int *colors = mem_zalloc(size * sizeof(int));
-	int *counts = mem_zalloc(size * sizeof(int));
+	struct gen_arena_mark mark = gen_arena_mark();
+	int *colors = gen_zalloc(size * sizeof(int));
+	int *counts = gen_zalloc(size * sizeof(int));
 	int color_of_floor[4];
 
 	/* Color the regions, find which cavern is which color */
@@ -3515,8 +3624,7 @@ static void connect_caverns(struct chunk *c, struct loc floor[])
 	join_region(c, colors, counts, color_of_floor[1], color_of_floor[2],
 		false);
 
-	mem_free(colors);
-	mem_free(counts);
+	gen_arena_release(mark);
 }
 /**
  * Generate a hard centre level - a greater vault surrounded by caverns
@@ -31,12 +31,383 @@
 #include "mon-group.h"
 #include "mon-make.h"
 #include "obj-util.h"
+#include "player-path.h"
 #include "trap.h"
 
 #define CHUNK_LIST_INCR 10
 struct chunk **chunk_list;     /**< list of pointers to saved chunks */
 uint16_t chunk_list_max = 0;   /**< current max actual chunk index */
 
+/**
+ * Bookkeeping for the stored chunks.
+ *
+ * Chunks are found by name through an open addressing table of list
+ * indices (plus one), which is rebuilt whenever entries move and checked
+ * against the list on lookup, so code which empties the list directly only
+ * leaves harmless stale entries.
+ *
+ * Only the most recently used z_info->stored_expanded chunks keep their
+ * per-grid arrays; the rest have them packed away, and once the packed
+ * grids take up more than z_info->stored_memory kilobytes the oldest are
+ * spilled to files in the user directory.  Anything which looks at the grids
+ * of a chunk in the list must call chunk_expand() first; chunk_find_name()
+ * does so itself.  Finding a chunk never packs others, so chunks found while
+ * changing level stay usable until prepare_next_level() trims the list.
+ */
+static int *store_table;
+static int store_table_size;
+static int store_table_used;
+static uint32_t store_clock;
+static size_t store_packed_bytes;
+static uint32_t store_spills;
+static time_t store_stamp;
+
+/**
+ * ------------------------------------------------------------------------
+ * Packing stored chunks
+ * ------------------------------------------------------------------------ */
+struct pack_buf {
+	uint8_t *data;
+	size_t len;
+	size_t size;
+};
+
+struct grid_array {
+	void **data;
+	size_t elem_size;
+};
+
+/**
+ * Get the per-grid arrays of a chunk, returning how many there are
+ */
+static int chunk_grid_arrays(struct chunk *c, struct grid_array *arrays)
+{
+	int n = 0;
+
+	arrays[n].data = (void **) &c->sq_feat;
+	arrays[n++].elem_size = sizeof(*c->sq_feat);
+	arrays[n].data = (void **) &c->sq_pred;
+	arrays[n++].elem_size = sizeof(*c->sq_pred);
+	arrays[n].data = (void **) &c->sq_info;
+	arrays[n++].elem_size = SQUARE_SIZE * sizeof(*c->sq_info);
+	arrays[n].data = (void **) &c->sq_light;
+	arrays[n++].elem_size = sizeof(*c->sq_light);
+	arrays[n].data = (void **) &c->sq_mon;
+	arrays[n++].elem_size = sizeof(*c->sq_mon);
+	arrays[n].data = (void **) &c->sq_obj;
+	arrays[n++].elem_size = sizeof(*c->sq_obj);
+	arrays[n].data = (void **) &c->sq_trap;
+	arrays[n++].elem_size = sizeof(*c->sq_trap);
+	arrays[n].data = (void **) &c->noise.grids[0];
+	arrays[n++].elem_size = sizeof(**c->noise.grids);
+	arrays[n].data = (void **) &c->scent.grids[0];
+	arrays[n++].elem_size = sizeof(**c->scent.grids);
+	return n;
+}
+
+static void pack_run(struct pack_buf *buf, uint8_t count, uint8_t value)
+{
+	if (buf->len + 2 > buf->size) {
+		buf->size = MAX(buf->size * 2, 1024);
+		buf->data = mem_realloc(buf->data, buf->size);
+	}
+	buf->data[buf->len++] = count;
+	buf->data[buf->len++] = value;
+}
+
+/**
+ * Run length encode an array one byte plane at a time, so that runs of
+ * similar multi-byte values (such as null pointers) stay runs
+ */
+static void pack_array(struct pack_buf *buf, const uint8_t *src, int n,
+		size_t elem_size)
+{
+	size_t k;
+	int i;
+
+	for (k = 0; k < elem_size; k++) {
+		uint8_t count = 1, value = src[k];
+
+		for (i = 1; i < n; i++) {
+			uint8_t next = src[i * elem_size + k];
+
+			if (next != value || count == UCHAR_MAX) {
+				pack_run(buf, count, value);
+				value = next;
+				count = 1;
+			} else {
+				count++;
+			}
+		}
+		pack_run(buf, count, value);
+	}
+}
+
+static const uint8_t *unpack_array(const uint8_t *src, uint8_t *dest, int n,
+		size_t elem_size)
+{
+	size_t k;
+
+	for (k = 0; k < elem_size; k++) {
+		int i = 0;
+
+		while (i < n) {
+			uint8_t count = *src++, value = *src++;
+
+			assert(i + count <= n);
+			while (count--) {
+				dest[i++ * elem_size + k] = value;
+			}
+		}
+	}
+	return src;
+}
+
+static bool chunk_is_live(struct chunk *c)
+{
+	return c == cave || (player && c == player->cave);
+}
+
+/**
+ * Drop the scratch space a chunk keeps between searches; it is made again
+ * when the chunk is next searched
+ */
+static void chunk_free_scratch(struct chunk *c)
+{
+	mem_free(c->flow_queue);
+	c->flow_queue = NULL;
+	path_workspace_free(c->path_work);
+	c->path_work = NULL;
+}
+
+/**
+ * Replace the per-grid arrays of a stored chunk by a packed copy
+ */
+static void chunk_pack(struct chunk *c)
+{
+	struct grid_array arrays[9];
+	struct pack_buf buf = { NULL, 0, 0 };
+	int i, num = chunk_grid_arrays(c, arrays);
+
+	assert(!c->packed && !c->spill_file);
+	chunk_free_scratch(c);
+	for (i = 0; i < num; i++) {
+		pack_array(&buf, *arrays[i].data, c->height * c->width,
+			arrays[i].elem_size);
+		mem_free(*arrays[i].data);
+		*arrays[i].data = NULL;
+	}
+	c->packed = mem_realloc(buf.data, buf.len);
+	c->packed_size = buf.len;
+	store_packed_bytes += buf.len;
+}
+
+/**
+ * Move a packed chunk's grids out to a file
+ */
+static void chunk_spill(struct chunk *c)
+{
+	char path[1024];
+	ang_file *f;
+
+	/* Keep different games' files apart */
+	if (!store_stamp) {
+		store_stamp = time(NULL);
+	}
+	path_build(path, sizeof(path), ANGBAND_DIR_USER,
+		format("stored-%lu-%lu.tmp", (unsigned long) store_stamp,
+		(unsigned long) store_spills++));
+	f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!f) return;
+	if (!file_write(f, (char *) c->packed, c->packed_size)) {
+		file_close(f);
+		file_delete(path);
+		return;
+	}
+	if (!file_close(f)) {
+		file_delete(path);
+		return;
+	}
+	store_packed_bytes -= c->packed_size;
+	mem_free(c->packed);
+	c->packed = NULL;
+	c->spill_file = string_make(path);
+}
+
+/**
+ * Bring a spilled chunk's packed grids back into memory
+ */
+static void chunk_reload(struct chunk *c)
+{
+	ang_file *f = file_open(c->spill_file, MODE_READ, FTYPE_RAW);
+
+	c->packed = mem_alloc(c->packed_size);
+	if (!f || file_read(f, (char *) c->packed, c->packed_size)
+			!= (int) c->packed_size) {
+		quit_fmt("Couldn't reload stored level %s!", c->name);
+	}
+	file_close(f);
+	file_delete(c->spill_file);
+	string_free(c->spill_file);
+	c->spill_file = NULL;
+	store_packed_bytes += c->packed_size;
+}
+
+/**
+ * Make sure a chunk has its per-grid arrays
+ * \param c the chunk, which need not be in the list
+ */
+void chunk_expand(struct chunk *c)
+{
+	struct grid_array arrays[9];
+	const uint8_t *src;
+	int i, num;
+
+	if (c->spill_file) {
+		chunk_reload(c);
+	}
+	if (!c->packed) return;
+
+	num = chunk_grid_arrays(c, arrays);
+	src = c->packed;
+	for (i = 0; i < num; i++) {
+		*arrays[i].data = mem_alloc(c->height * c->width *
+			arrays[i].elem_size);
+		src = unpack_array(src, *arrays[i].data, c->height * c->width,
+			arrays[i].elem_size);
+	}
+	assert(src == c->packed + c->packed_size);
+
+	/* The heatmaps' rows point into the grids */
+	for (i = 1; i < c->height; i++) {
+		c->noise.grids[i] = c->noise.grids[0] + i * c->width;
+		c->scent.grids[i] = c->scent.grids[0] + i * c->width;
+	}
+
+	store_packed_bytes -= c->packed_size;
+	mem_free(c->packed);
+	c->packed = NULL;
+	c->packed_size = 0;
+}
+
+/**
+ * Pack the least recently used chunks beyond the number kept expanded, and
+ * spill the oldest packed ones beyond the memory budget
+ */
+void chunk_list_trim(void)
+{
+	int i, expanded = 0;
+
+	for (i = 0; i < chunk_list_max; i++) {
+		struct chunk *c = chunk_list[i];
+
+		if (!c->packed && !c->spill_file && !chunk_is_live(c)) {
+			expanded++;
+		}
+	}
+	while (expanded > z_info->stored_expanded) {
+		struct chunk *oldest = NULL;
+
+		for (i = 0; i < chunk_list_max; i++) {
+			struct chunk *c = chunk_list[i];
+
+			if (c->packed || c->spill_file || chunk_is_live(c)) continue;
+			if (!oldest || c->store_used < oldest->store_used) {
+				oldest = c;
+			}
+		}
+		chunk_pack(oldest);
+		expanded--;
+	}
+	while (store_packed_bytes > (size_t) z_info->stored_memory * 1024) {
+		struct chunk *oldest = NULL;
+
+		for (i = 0; i < chunk_list_max; i++) {
+			struct chunk *c = chunk_list[i];
+
+			if (!c->packed) continue;
+			if (!oldest || c->store_used < oldest->store_used) {
+				oldest = c;
+			}
+		}
+		if (!oldest) break;
+		chunk_spill(oldest);
+
+		/* Give up if the files can't be written */
+		if (oldest->packed) break;
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * The chunk list
+ * ------------------------------------------------------------------------ */
+/**
+ * Put a list entry in the name table
+ */
+static void chunk_table_insert(int idx)
+{
+	uint32_t mask = store_table_size - 1;
+	uint32_t h = djb2_hash(chunk_list[idx]->name) & mask;
+
+	while (store_table[h]) {
+		h = (h + 1) & mask;
+	}
+	store_table[h] = idx + 1;
+	store_table_used++;
+}
+
+/**
+ * Remake the name table from the list, with room for extra more entries
+ */
+static void chunk_table_rebuild(int extra)
+{
+	int i;
+
+	store_table_size = 16;
+	while (store_table_size < 2 * (chunk_list_max + extra)) {
+		store_table_size *= 2;
+	}
+	mem_free(store_table);
+	store_table = mem_zalloc(store_table_size * sizeof(*store_table));
+	store_table_used = 0;
+	for (i = 0; i < chunk_list_max; i++) {
+		chunk_table_insert(i);
+	}
+}
+
+/**
+ * Get the list index of a chunk, or -1 if it isn't there
+ */
+static int chunk_list_index(const char *name)
+{
+	uint32_t mask = store_table_size - 1, h;
+
+	if (!store_table || !name) return -1;
+	h = djb2_hash(name) & mask;
+	while (store_table[h]) {
+		int i = store_table[h] - 1;
+
+		if (i < chunk_list_max && chunk_list[i]
+				&& streq(name, chunk_list[i]->name)) {
+			return i;
+		}
+		h = (h + 1) & mask;
+	}
+	return -1;
+}
+
+/**
+ * Free the name table, once the chunks themselves are gone
+ */
+void chunk_list_cleanup(void)
+{
+	mem_free(store_table);
+	store_table = NULL;
+	store_table_size = 0;
+	store_table_used = 0;
+}
+
 /**
  * Write the terrain info of a chunk to memory and return a pointer to it
  *
@@ -45,22 +416,29 @@ uint16_t chunk_list_max = 0;   /**< current max actual chunk index */
  */
 struct chunk *chunk_write(struct chunk *c)
 {
-	int x, y;
-
 	struct chunk *new = cave_new(c->height, c->width);
+	int n = c->height * c->width;
 
-	/* Write the location stuff */
-	for (y = 0; y < new->height; y++) {
-		for (x = 0; x < new->width; x++) {
-			/* Terrain */
-			new->squares[y][x].feat = square(c, loc(x, y))->feat;
-			sqinfo_copy(square(new, loc(x, y))->info, square(c, loc(x, y))->info);
-		}
-	}
+	/* Write the location stuff (terrain and square info) */
+	memcpy(new->sq_feat, c->sq_feat, n * sizeof(*c->sq_feat));
+	memcpy(new->sq_pred, c->sq_pred, n * sizeof(*c->sq_pred));
+	memcpy(new->sq_info, c->sq_info, n * SQUARE_SIZE * sizeof(*c->sq_info));
 
 	return new;
 }
 
+/**
+ * Note that a chunk has changed, so any savefile record kept for it is stale
+ * \param c the chunk which changed
+ */
+static void chunk_touch(struct chunk *c)
+{
+	c->gen++;
+	mem_free(c->save_record);
+	c->save_record = NULL;
+	c->save_record_size = 0;
+}
+
 /**
  * Add an entry to the chunk list - any problems with the length of this will
  * be more in the memory used by the chunks themselves rather than the list
@@ -74,8 +452,17 @@ void chunk_list_add(struct chunk *c)
 	if ((chunk_list_max % CHUNK_LIST_INCR) == 0)
 		chunk_list = (struct chunk **) mem_realloc(chunk_list, newsize);
 
-	/* Add the new one */
+	/* Add the new one, without scratch space it won't use while stored */
+	chunk_free_scratch(c);
+	chunk_touch(c);
+	c->store_used = ++store_clock;
 	chunk_list[chunk_list_max++] = c;
+	if (2 * (store_table_used + 1) > store_table_size) {
+		chunk_table_rebuild(CHUNK_LIST_INCR);
+	} else {
+		chunk_table_insert(chunk_list_max - 1);
+	}
+	chunk_list_trim();
 }
 
 /**
@@ -85,41 +472,37 @@ void chunk_list_add(struct chunk *c)
  */
 bool chunk_list_remove(const char *name)
 {
-	int i;
+	int i = chunk_list_index(name), j;
 
-	/* Find the match */
-	for (i = 0; i < chunk_list_max; i++) {
-		if (streq(name, chunk_list[i]->name)) {
-			/* Copy all the succeeding chunks back one */
-			int j;
-			for (j = i + 1; j < chunk_list_max; j++) {
-				chunk_list[j - 1] = chunk_list[j];
-			}
+	if (i < 0) return false;
 
-			/* Shorten the list and return */
-			chunk_list_max--;
-			chunk_list[chunk_list_max] = NULL;
-			return true;
-		}
+	/* Copy all the succeeding chunks back one */
+	chunk_expand(chunk_list[i]);
+	chunk_touch(chunk_list[i]);
+	for (j = i + 1; j < chunk_list_max; j++) {
+		chunk_list[j - 1] = chunk_list[j];
 	}
 
-	return false;
+	/* Shorten the list */
+	chunk_list_max--;
+	chunk_list[chunk_list_max] = NULL;
+	chunk_table_rebuild(0);
+	return true;
 }
 
 /**
- * Find a chunk by name
+ * Find a chunk by name, making sure its grids are ready for use
  * \param name the name of the chunk being sought
  * \return the pointer to the chunk
  */
 struct chunk *chunk_find_name(const char *name)
 {
-	int i;
-
-	for (i = 0; i < chunk_list_max; i++)
-		if (streq(name, chunk_list[i]->name))
-			return chunk_list[i];
+	int i = chunk_list_index(name);
 
-	return NULL;
+	if (i < 0) return NULL;
+	chunk_list[i]->store_used = ++store_clock;
+	chunk_expand(chunk_list[i]);
+	return chunk_list[i];
 }
 
 /**
@@ -369,6 +752,10 @@ bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
 			return false;
 	}
 
+	/* Whatever dest's view was based on is about to be replaced */
+	view_state_free(dest->view);
+	dest->view = NULL;
+
 	/* Write the location stuff (terrain, objects, traps) */
 	for (grid.y = 0; grid.y < h; grid.y++) {
 		for (grid.x = 0; grid.x < w; grid.x++) {
@@ -377,28 +764,30 @@ bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
 			symmetry_transform(&dest_grid, y0, x0, h, w, rotate, reflect);
 
 			/* Terrain */
-			dest->squares[dest_grid.y][dest_grid.x].feat =
-				square(source, grid)->feat;
-			sqinfo_copy(square(dest, dest_grid)->info,
-						square(source, grid)->info);
+			dest->sq_feat[square_index(dest, dest_grid)] =
+				square_fidx(source, grid);
+			dest->sq_pred[square_index(dest, dest_grid)] =
+				source->sq_pred[square_index(source, grid)];
+			sqinfo_copy(square_info(dest, dest_grid),
+						square_info(source, grid));
 
 			/* Dungeon objects */
 			if (square_object(source, grid)) {
 				struct object *obj;
-				dest->squares[dest_grid.y][dest_grid.x].obj =
-					square_object(source, grid);
+				square_set_obj(dest, dest_grid,
+					square_object(source, grid));
 
 				for (obj = square_object(source, grid); obj; obj = obj->next) {
 					/* Adjust position */
 					obj->grid = dest_grid;
 				}
-				source->squares[grid.y][grid.x].obj = NULL;
+				square_set_obj(source, grid, NULL);
 			}
 
 			/* Traps */
-			if (square(source, grid)->trap) {
-				struct trap *trap = square(source, grid)->trap;
-				dest->squares[dest_grid.y][dest_grid.x].trap = trap;
+			if (square_trap(source, grid)) {
+				struct trap *trap = square_trap(source, grid);
+				square_set_trap(dest, dest_grid, trap);
 
 				/* Traverse the trap list */
 				while (trap) {
@@ -406,12 +795,12 @@ bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
 					trap->grid = dest_grid;
 					trap = trap->next;
 				}
-				source->squares[grid.y][grid.x].trap = NULL;
+				square_set_trap(source, grid, NULL);
 			}
 
 			/* Player */
-			if (square(source, grid)->mon == -1) {
-				dest->squares[dest_grid.y][dest_grid.x].mon = -1;
+			if (square_midx(source, grid) == -1) {
+				square_set_mon(dest, dest_grid, -1);
 				p->grid = dest_grid;
 			}
 		}
@@ -456,9 +845,14 @@ bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
 		/* Adjust monster index */
 		dest_mon->midx += mon_skip;
 
+		/* Noise and scent are the size of the source; drop them */
+		flow_field_free(source, source_mon->flow);
+		source_mon->flow = NULL;
+		dest_mon->flow = NULL;
+
 		/* Move grid */
 		symmetry_transform(&dest_mon->grid, y0, x0, h, w, rotate, reflect);
-		dest->squares[dest_mon->grid.y][dest_mon->grid.x].mon = dest_mon->midx;
+		square_set_mon(dest, dest_mon->grid, dest_mon->midx);
 
 		/* Held or mimicked objects */
 		if (source_mon->held_obj) {
@@ -517,6 +911,17 @@ bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
 		source->objects[i] = NULL;
 	}
 	dest->obj_max += source->obj_max + 1;
+
+	/* Traps and objects have moved, so count them again when needed */
+	mem_free(dest->trap_timers);
+	dest->trap_timers = NULL;
+	dest->trap_timer_count = dest->trap_timer_size = 0;
+	mem_free(dest->charging);
+	dest->charging = NULL;
+	dest->charging_count = dest->charging_size = 0;
+	mem_free(source->charging);
+	source->charging = NULL;
+	source->charging_count = source->charging_size = 0;
 	source->obj_max = 1;
 	object_lists_check_integrity(dest, NULL);
 
@@ -573,7 +978,7 @@ void chunk_validate_objects(struct chunk *c) {
 			struct loc grid = loc(x, y);
 			for (obj = square_object(c, grid); obj; obj = obj->next)
 				assert(obj->tval != 0);
-			if (square(c, grid)->mon > 0) {
+			if (square_midx(c, grid) > 0) {
 				struct monster *mon = square_monster(c, grid);
 				if (mon->held_obj)
 					for (obj = mon->held_obj; obj; obj = obj->next)
@@ -148,6 +148,150 @@ void shuffle(int *arr, int n)
 }
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Scratch memory for level generation
+ * ------------------------------------------------------------------------ */
+/**
+ * The blocks the generation arena hands out memory from.  Allocation bumps
+ * the used count of the current block, moving on to the next one (made or
+ * enlarged as needed) when it is full; nothing is freed on its own, but
+ * gen_arena_release() winds everything back to a mark and keeps the blocks
+ * for the next level.
+ */
+struct gen_arena_block {
+	uint8_t *data;
+	size_t size;
+	size_t used;
+};
+
+#define GEN_ARENA_BLOCK_SIZE (1024 * 1024)
+#define GEN_ARENA_ALIGN 16
+
+static struct gen_arena_block *gen_arena_blocks;
+static int gen_arena_count;
+static int gen_arena_current;
+
+/**
+ * Allocate len bytes of scratch memory for level generation.  The memory is
+ * good until the enclosing gen_arena_release() and must not be passed to
+ * mem_free().
+ */
+void *gen_alloc(size_t len)
+{
+	struct gen_arena_block *block;
+	size_t need = (len + GEN_ARENA_ALIGN - 1) & ~((size_t) GEN_ARENA_ALIGN - 1);
+	void *result;
+
+	if (!need) need = GEN_ARENA_ALIGN;
+	block = gen_arena_count ? &gen_arena_blocks[gen_arena_current] : NULL;
+	if (!block || block->size - block->used < need) {
+		/* Move on to the next block, making it big enough */
+		if (block) gen_arena_current++;
+		if (gen_arena_current == gen_arena_count) {
+			gen_arena_blocks = mem_realloc(gen_arena_blocks,
+				(gen_arena_count + 1) * sizeof(*gen_arena_blocks));
+			block = &gen_arena_blocks[gen_arena_count++];
+			block->size = MAX(need, (size_t) GEN_ARENA_BLOCK_SIZE);
+			block->data = mem_alloc(block->size);
+		} else {
+			block = &gen_arena_blocks[gen_arena_current];
+			if (block->size < need) {
+				mem_free(block->data);
+				block->size = need;
+				block->data = mem_alloc(block->size);
+			}
+		}
+		block->used = 0;
+	}
+	result = block->data + block->used;
+	block->used += need;
+	return result;
+}
+
+/**
+ * Allocate len bytes of zeroed scratch memory for level generation.
+ */
+void *gen_zalloc(size_t len)
+{
+	void *result = gen_alloc(len);
+
+	memset(result, 0, len);
+	return result;
+}
+
+/**
+ * Grow scratch memory from gen_alloc(), which was old_len bytes long, to
+ * len bytes; the old memory is simply left until the arena is released.
+ */
+void *gen_realloc(void *p, size_t old_len, size_t len)
+{
+	void *result = gen_alloc(len);
+
+	if (p) memcpy(result, p, MIN(old_len, len));
+	return result;
+}
+
+/**
+ * Make an integer queue able to hold size entries in scratch memory; it
+ * should not be resized or passed to q_free().
+ */
+struct queue *gen_queue_new(size_t size)
+{
+	struct queue *q = gen_alloc(sizeof(*q));
+
+	q->data = gen_alloc((size + 1) * sizeof(*q->data));
+	q->size = size + 1;
+	q->head = 0;
+	q->tail = 0;
+	return q;
+}
+
+/**
+ * Remember how much scratch memory is in use, to go back to later.
+ */
+struct gen_arena_mark gen_arena_mark(void)
+{
+	struct gen_arena_mark mark;
+
+	mark.block = gen_arena_current;
+	mark.used = gen_arena_count ?
+		gen_arena_blocks[gen_arena_current].used : 0;
+	return mark;
+}
+
+/**
+ * Give back all scratch memory allocated since the mark was made.
+ */
+void gen_arena_release(struct gen_arena_mark mark)
+{
+	int i;
+
+	if (!gen_arena_count) return;
+	for (i = mark.block + 1; i <= gen_arena_current; i++) {
+		gen_arena_blocks[i].used = 0;
+	}
+	gen_arena_current = mark.block;
+	gen_arena_blocks[mark.block].used = mark.used;
+}
+
+/**
+ * Free the arena's blocks altogether.
+ */
+void gen_arena_free(void)
+{
+	int i;
+
+	for (i = 0; i < gen_arena_count; i++) {
+		mem_free(gen_arena_blocks[i].data);
+	}
+	mem_free(gen_arena_blocks);
+	gen_arena_blocks = NULL;
+	gen_arena_count = 0;
+	gen_arena_current = 0;
+}
+
+
 /**
  * Set up to locate a square in a rectangular region of a chunk.
  *
@@ -351,7 +351,7 @@ static void alloc_paths(struct chunk *c, struct player *p, int place,
 	/* Mark all the roads, so we know not to overwrite them */
 	for (grid.y = 0; grid.y < c->height; grid.y++) {
 		for (grid.x = 0; grid.x < c->width; grid.x++) {
-			if (square(c, grid)->feat == FEAT_ROAD) {
+			if (square_fidx(c, grid) == FEAT_ROAD) {
 				square_mark(c, grid);
 			}
 		}
@@ -543,7 +543,7 @@ static bool check_vault_space(struct chunk *c, struct loc avoid,
 			if (square_ispath(c, grid)) return false;
 			if (distance(grid, avoid) < 20) return false;
 			if (square_ismark(c, grid)) return false;
-			if (square(c, grid)->mon) return false;
+			if (square_midx(c, grid)) return false;
 			if (square_isplayertrap(c, grid)) return false;
 			if (square_object(c, grid)) return false;
 			if (square_iswebbed(c, grid)) return false;
@@ -604,7 +604,7 @@ static int make_formation(struct chunk *c, struct player *p, struct loc grid,
 						  const char *name, int prob)
 {
 	int step, j, jj, i = 0, total = 0;
-	int *all_feat = mem_zalloc(prob * sizeof(*all_feat));
+	int *all_feat = gen_zalloc(prob * sizeof(*all_feat));
 	struct loc tgrid = grid;
 
 	/* Need to make some wilderness vaults */
@@ -633,7 +633,6 @@ static int make_formation(struct chunk *c, struct player *p, struct loc grid,
 			if (good_place) {
 				/* Build the vault (never lit, icky) */
 				if (!build_vault(c, grid, v)) {
-					mem_free(all_feat);
 					return 0;
 				}
 
@@ -648,7 +647,6 @@ static int make_formation(struct chunk *c, struct player *p, struct loc grid,
 				num_wild_vaults--;
 
 				/* Takes up some space */
-				mem_free(all_feat);
 				return (v->hgt * v->wid);
 			}
 		}
@@ -711,7 +709,6 @@ static int make_formation(struct chunk *c, struct player *p, struct loc grid,
 		i = randint0(prob);
 	}
 
-	mem_free(all_feat);
 	return (total);
 }
 
@@ -791,7 +788,7 @@ static bool verify_level(struct chunk *c)
 			if ((grid.y == 0 || grid.x == 0
 					|| grid.y == c->height - 1
 					|| grid.x == c->width - 1)
-					&& square(c, grid)->feat != FEAT_PERM) {
+					&& square_fidx(c, grid) != FEAT_PERM) {
 				++broken_bnd;
 				last_bad_bnd = grid;
 			}
@@ -814,15 +811,15 @@ static bool verify_level(struct chunk *c)
 		if (broken_bnd) {
 			title = format("Broken Wilderness:  %d Bounding Walls; Last at (x=%d,y=%d) with Feature=%d",
 				broken_bnd, last_bad_bnd.x, last_bad_bnd.y,
-				(int) square(c, last_bad_bnd)->feat);
+				(int) square_fidx(c, last_bad_bnd));
 		} else if (broken_mon) {
 			title = format("Broken Monster:  %d Embedded in Terrain; Last at (x=%d,y=%d) with Terrain=%d",
 				broken_mon, last_bad_mon.x, last_bad_mon.y,
-				(int) square(c, last_bad_mon)->feat);
+				(int) square_fidx(c, last_bad_mon));
 		} else {
 			title = format("Broken Object:  %d Embedded in Terrain; Last at (x=%d,y=%d) with Terrain=%d",
 				broken_obj, last_bad_obj.x, last_bad_obj.y,
-				(int) square(c, last_bad_obj)->feat);
+				(int) square_fidx(c, last_bad_obj));
 		}
 		dump_level_simple(NULL, title, c);
 		msg("Restarting wilderness generation; bad level in dumpedlevel.html");
@@ -1840,7 +1837,7 @@ struct chunk *river_gen(struct player *p, int height, int width,
 
 	/* Place the river, start in the middle third */
 	i = c->width / 3 + randint0(c->width / 3);
-	mid = mem_zalloc(c->height * sizeof(int));
+	mid = gen_zalloc(c->height * sizeof(int));
 	for (grid.y = 1; grid.y < c->height - 1; grid.y++) {
 		/* Remember the midpoint */
 		mid[grid.y] = i;
@@ -1949,8 +1946,6 @@ struct chunk *river_gen(struct player *p, int height, int width,
 	/* Place objects, traps and monsters */
 	(void) populate(c, false);
 
-	mem_free(mid);
-
 	if (!verify_level(c)) {
 		wipe_mon_list(c, p);
 		cave_free(c);
@@ -56,6 +56,11 @@ static struct cave_profile *cave_profiles;
 struct dun_data *dun;
 struct room_template *room_templates;
 
+/**
+ * Private generator for level generation, or NULL to use Rand_current.
+ */
+static struct rng_state *gen_rng;
+
 static const struct {
 	const char *name;
 	cave_builder builder;
@@ -746,7 +751,7 @@ static void run_template_parser(void) {
 
 
 /**
- * Free the template arrays
+ * Free the template arrays and the generation arena
  */
 static void cleanup_template_parser(void)
 {
@@ -754,6 +759,7 @@ static void cleanup_template_parser(void)
 	cleanup_parser(&room_parser);
 	cleanup_parser(&vault_parser);
 	cleanup_parser(&themed_parser);
+	gen_arena_free();
 }
 
 
@@ -784,7 +790,7 @@ static void place_feeling(struct chunk *c)
 				continue;
 
 			/* Set the cave square appropriately */
-			sqinfo_on(square(c, grid)->info, SQUARE_FEEL);
+			sqinfo_on(square_info(c, grid), SQUARE_FEEL);
 			
 			break;
 		}
@@ -1348,6 +1354,9 @@ static void sanitize_player_loc(struct chunk *c, struct player *p)
 static void cave_store(struct chunk *c, char *name, bool known, bool keep_all)
 {
 	struct chunk *stored;
+
+	/* Monsters' energy must be up to date to be stored */
+	monster_schedule_flush(c);
 	if (keep_all) {
 		stored = c;
 	} else {
@@ -1429,7 +1438,7 @@ static void leave_arena(struct chunk *c, struct player *p)
 		for (y = 0; y < cave->height; y++) {
 			for (x = 0; x < cave->width; x++) {
 				struct loc grid = loc(x, y);
-				if (square(cave, grid)->mon == -1) {
+				if (square_midx(cave, grid) == -1) {
 					p->grid = grid;
 					found = true;
 					break;
@@ -1472,29 +1481,14 @@ static void leave_arena(struct chunk *c, struct player *p)
 
 /**
  * Release the dynamically allocated resources in a dun_data structure.
+ * Everything but the connectors is scratch memory, so goes back in one go.
  */
 static void cleanup_dun_data(struct dun_data *dd)
 {
-	int i;
-
-	cave_connectors_free(dun->join);
-	cave_connectors_free(dun->one_off_above);
-	cave_connectors_free(dun->one_off_below);
-	mem_free(dun->cent);
-	mem_free(dun->ent_n);
-	for (i = 0; i < z_info->level_room_max; ++i) {
-		mem_free(dun->ent[i]);
-	}
-	mem_free(dun->ent);
-	if (dun->ent2room) {
-		for (i = 0; dun->ent2room[i]; ++i) {
-			mem_free(dun->ent2room[i]);
-		}
-		mem_free(dun->ent2room);
-	}
-	mem_free(dun->door);
-	mem_free(dun->wall);
-	mem_free(dun->tunn);
+	cave_connectors_free(dd->join);
+	cave_connectors_free(dd->one_off_above);
+	cave_connectors_free(dd->one_off_below);
+	gen_arena_release(dd->arena_mark);
 }
 
 
@@ -1502,6 +1496,18 @@ static void cleanup_dun_data(struct dun_data *dd)
  * ------------------------------------------------------------------------
  * Main level generation functions
  * ------------------------------------------------------------------------ */
+/**
+ * Make level generation draw from the given generator rather than the
+ * game's, so levels can be generated (for instance in advance, or for
+ * statistics) without disturbing the game's random sequence.
+ *
+ * \param rng is the generator to use, or NULL to go back to Rand_current.
+ */
+void generate_set_rng(struct rng_state *rng)
+{
+	gen_rng = rng;
+}
+
 /**
  * Generate a random level.
  *
@@ -1511,7 +1517,8 @@ static void cleanup_dun_data(struct dun_data *dd)
  * \param width is the minimum width, in grids, for the level
  * \return a pointer to the new level
  */
-static struct chunk *cave_generate(struct player *p, int height, int width)
+static struct chunk *cave_generate_aux(struct player *p, int height,
+		int width)
 {
 	const char *error = "no generation";
 	int i, tries = 0;
@@ -1558,13 +1565,14 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 
 		/* Allocate global data (will be freed when we leave the loop) */
 		dun = &dun_body;
-		dun->cent = mem_zalloc(z_info->level_room_max * sizeof(struct loc));
-		dun->ent_n = mem_zalloc(z_info->level_room_max * sizeof(*dun->ent_n));
-		dun->ent = mem_zalloc(z_info->level_room_max * sizeof(*dun->ent));
+		dun->arena_mark = gen_arena_mark();
+		dun->cent = gen_zalloc(z_info->level_room_max * sizeof(struct loc));
+		dun->ent_n = gen_zalloc(z_info->level_room_max * sizeof(*dun->ent_n));
+		dun->ent = gen_zalloc(z_info->level_room_max * sizeof(*dun->ent));
 		dun->ent2room = NULL;
-		dun->door = mem_zalloc(z_info->level_door_max * sizeof(struct loc));
-		dun->wall = mem_zalloc(z_info->wall_pierce_max * sizeof(struct loc));
-		dun->tunn = mem_zalloc(z_info->tunn_grid_max * sizeof(struct loc));
+		dun->door = gen_zalloc(z_info->level_door_max * sizeof(struct loc));
+		dun->wall = gen_zalloc(z_info->wall_pierce_max * sizeof(struct loc));
+		dun->tunn = gen_zalloc(z_info->tunn_grid_max * sizeof(struct loc));
 		dun->join = NULL;
 		dun->one_off_above = NULL;
 		dun->one_off_below = NULL;
@@ -1614,10 +1622,10 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 			for (x = 0; x < chunk->width; x++) {
 				struct loc grid = loc(x, y);
 
-				sqinfo_off(square(chunk, grid)->info, SQUARE_WALL_INNER);
-				sqinfo_off(square(chunk, grid)->info, SQUARE_WALL_OUTER);
-				sqinfo_off(square(chunk, grid)->info, SQUARE_WALL_SOLID);
-				sqinfo_off(square(chunk, grid)->info, SQUARE_MON_RESTRICT);
+				sqinfo_off(square_info(chunk, grid), SQUARE_WALL_INNER);
+				sqinfo_off(square_info(chunk, grid), SQUARE_WALL_OUTER);
+				sqinfo_off(square_info(chunk, grid), SQUARE_WALL_SOLID);
+				sqinfo_off(square_info(chunk, grid), SQUARE_MON_RESTRICT);
 
 				if (square_isstairs(chunk, grid)) {
 					size_t n;
@@ -1626,7 +1634,7 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 					new->feat = square_feat(chunk, grid)->fidx;
 					new->info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
 					for (n = 0; n < SQUARE_SIZE; n++) {
-						new->info[n] = square(chunk, grid)->info[n];
+						new->info[n] = square_info(chunk, grid)[n];
 					}
 					new->next = chunk->join;
 					chunk->join = new;
@@ -1691,6 +1699,18 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 	return chunk;
 }
 
+/**
+ * Generate a random level with the generation RNG, if one has been set.
+ */
+static struct chunk *cave_generate(struct player *p, int height, int width)
+{
+	struct rng_state *old = gen_rng ? Rand_use(gen_rng) : NULL;
+	struct chunk *chunk = cave_generate_aux(p, height, width);
+
+	if (old) Rand_use(old);
+	return chunk;
+}
+
 /**
  * Prepare the level the player is about to enter, either by generating
  * or reloading
@@ -1847,6 +1867,12 @@ void prepare_next_level(struct player *p)
 
 	/* The dungeon is ready */
 	character_dungeon = true;
+
+	/*
+	 * Only now pack away stored levels, since those found above may
+	 * still be in use until the new level is live
+	 */
+	chunk_list_trim();
 }
 
 /**
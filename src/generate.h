@@ -117,6 +117,14 @@ struct pit_profile {
 extern struct pit_profile *pit_info;
 
 
+/**
+ * A point in the generation arena's scratch memory to release back to
+ */
+struct gen_arena_mark {
+    int block;
+    size_t used;
+};
+
 /**
  * Structure to hold all "dungeon generation" data
  */
@@ -181,6 +189,9 @@ struct dun_data {
     /*!< The number of staircase rooms */
     int nstair_room;
 
+    /*!< Where the generation arena was before this attempt */
+    struct gen_arena_mark arena_mark;
+
     /*!< Whether or not  persistent levels are being used */
     bool persist;
 };
@@ -315,6 +326,7 @@ extern struct vault *themed_levels;
 extern struct room_template *room_templates;
 
 /* generate.c */
+void generate_set_rng(struct rng_state *rng);
 void prepare_next_level(struct player *p);
 int get_room_builder_count(void);
 int get_room_builder_index_from_name(const char *name);
@@ -365,6 +377,9 @@ struct chunk *valley_gen(struct player *p, int height, int width,
 						 const char **p_error);
 
 /* gen-chunk.c */
+void chunk_expand(struct chunk *c);
+void chunk_list_cleanup(void);
+void chunk_list_trim(void);
 struct chunk *chunk_write(struct chunk *c);
 void chunk_list_add(struct chunk *c);
 bool chunk_list_remove(const char *name);
@@ -432,6 +447,13 @@ extern uint8_t get_angle_to_grid[41][41];
 int grid_to_i(struct loc grid, int w);
 void i_to_grid(int i, int w, struct loc *grid);
 void shuffle(int *arr, int n);
+void *gen_alloc(size_t len);
+void *gen_zalloc(size_t len);
+void *gen_realloc(void *p, size_t old_len, size_t len);
+struct queue *gen_queue_new(size_t size);
+struct gen_arena_mark gen_arena_mark(void);
+void gen_arena_release(struct gen_arena_mark mark);
+void gen_arena_free(void);
 int *cave_find_init(struct loc top_left, struct loc bottom_right);
 void cave_find_reset(int *state);
 bool cave_find_get_grid(struct loc *grid, int *state);
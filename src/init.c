@@ -613,6 +613,14 @@ static enum parser_error parse_constants_world(struct parser *p) {
 		z->themed_dun = value;
 	else if (streq(label, "themed-wild"))
 		z->themed_wild = value;
+	else if (streq(label, "stored-expanded")) {
+		/* At least a level and its known version */
+		if (value < 2)
+			return PARSE_ERROR_INVALID_VALUE;
+		z->stored_expanded = value;
+	}
+	else if (streq(label, "stored-memory"))
+		z->stored_memory = value;
 	else
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 
@@ -1292,6 +1300,7 @@ static void cleanup_world(void)
 			string_free(map->towns[i].code);
 		}
 		mem_free(map->towns);
+		mem_free(map->name_table);
 		string_free(map->name);
 		string_free(map->help);
 		mem_free(map->levels);
@@ -2345,6 +2354,25 @@ static errr run_parse_feat(struct parser *p) {
 	return parse_file_quit_not_found(p, "terrain");
 }
 
+/**
+ * Fill in the flag word and grid predicate bits of a feature from its flags
+ */
+static void feat_set_predicates(struct feature *f)
+{
+	int flag;
+
+	assert(TF_MAX <= 64);
+	f->tf_bits = 0;
+	for (flag = flag_next(f->flags, TF_SIZE, FLAG_START); flag != FLAG_END;
+			flag = flag_next(f->flags, TF_SIZE, flag + 1)) {
+		f->tf_bits |= (uint64_t) 1 << flag;
+	}
+	f->sq_pred = 0;
+	if (tf_has(f->flags, TF_PASSABLE)) f->sq_pred |= SQUARE_PRED_PASSABLE;
+	if (tf_has(f->flags, TF_PROJECT)) f->sq_pred |= SQUARE_PRED_PROJECT;
+	if (tf_has(f->flags, TF_LOS)) f->sq_pred |= SQUARE_PRED_LOS;
+}
+
 static errr finish_parse_feat(struct parser *p) {
 	struct feature *f, *n;
 	int fidx;
@@ -2374,6 +2402,7 @@ static errr finish_parse_feat(struct parser *p) {
 				string_append(f_info[fidx].look_in_preposition, " ");
 		}
 		f_info[fidx].fidx = fidx;
+		feat_set_predicates(&f_info[fidx]);
 		n = f->next;
 		if (fidx < z_info->f_max - 1)
 			f_info[fidx].next = &f_info[fidx + 1];
@@ -4693,6 +4722,7 @@ static struct init_module arrays_module = {
 
 
 extern struct init_module z_quark_module;
+extern struct init_module view_module;
 extern struct init_module generate_module;
 extern struct init_module rune_module;
 extern struct init_module obj_make_module;
@@ -4710,6 +4740,7 @@ static struct init_module *modules[] = {
 	&messages_module,
 	&ui_visuals_module, /* This needs to load before monsters and objects. */
 	&arrays_module,
+	&view_module,
 	&player_module,
 	&generate_module,
 	&rune_module,
@@ -4773,11 +4804,13 @@ void cleanup_angband(void)
 
 	/* Free the chunk list */
 	for (i = 0; i < chunk_list_max; i++) {
+		chunk_expand(chunk_list[i]);
 		wipe_mon_list(chunk_list[i], player);
 		cave_free(chunk_list[i]);
 	}
 	mem_free(chunk_list);
 	chunk_list = NULL;
+	chunk_list_cleanup();
 
 	for (i = 0; modules[i]; i++)
 		if (modules[i]->cleanup)
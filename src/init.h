@@ -111,6 +111,8 @@ struct angband_constants
 	uint16_t move_energy;	/* Energy the player or monster needs to move */
 	uint16_t themed_dun;	/* !/Chance of a themed level in the dungeon */
 	uint16_t themed_wild;	/* !/Chance of a themed level in the wilderness */
+	uint16_t stored_expanded;	/* Stored levels kept ready for use */
+	uint16_t stored_memory;	/* Kilobytes of packed stored levels in memory */
 
 	/* Carrying capacity constants, read from constants.txt */
 	uint16_t pack_size;		/**< Maximum number of pack slots */
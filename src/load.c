@@ -419,13 +419,13 @@ int rd_randomizer(void)
 	uint32_t noop;
 
 	/* current value for the simple RNG */
-	rd_u32b(&Rand_value);
+	rd_u32b(&Rand_state.value);
 
 	/* state index */
-	rd_u32b(&state_i);
+	rd_u32b(&Rand_state.state_i);
 
 	/* for safety, make sure state_i < RAND_DEG */
-	state_i = state_i % RAND_DEG;
+	Rand_state.state_i = Rand_state.state_i % RAND_DEG;
     
 	/* NULL padding for compatibility with previous versions */
 	rd_u32b(&noop);
@@ -434,13 +434,13 @@ int rd_randomizer(void)
     
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		rd_u32b(&STATE[i]);
+		rd_u32b(&Rand_state.state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
 		rd_u32b(&noop);
 
-	Rand_quick = false;
+	Rand_state.quick = false;
 
 	return 0;
 }
@@ -1443,7 +1443,7 @@ static int rd_dungeon_aux(struct chunk **c)
 	c1 = cave_new(height, width);
 	c1->name = string_make(name);
 
-    /* Run length decoding of cave->squares[y][x].info */
+    /* Run length decoding of cave->sq_info */
 	for (n = 0; n < square_size; n++) {
 		/* Load the dungeon data */
 		for (x = y = 0; y < c1->height; ) {
@@ -1454,7 +1454,8 @@ static int rd_dungeon_aux(struct chunk **c)
 			/* Apply the RLE info */
 			for (i = count; i > 0; i--) {
 				/* Extract "info" */
-				c1->squares[y][x].info[n] = tmp8u;
+				c1->sq_info[(y * c1->width + x) * SQUARE_SIZE + n] =
+					tmp8u;
 
 				/* Advance/Wrap */
 				if (++x >= c1->width) {
@@ -1555,7 +1556,8 @@ static int rd_objects_aux(rd_item_t rd_item_version, struct chunk *c)
 #else
 		if (square_in_bounds_fully(c, obj->grid)) {
 #endif
-			pile_insert_end(&c->squares[obj->grid.y][obj->grid.x].obj, obj);
+			pile_insert_end(&c->sq_obj[square_index(c, obj->grid)],
+				obj);
 		}
 		assert(obj->oidx);
 		assert(c->objects[obj->oidx] == NULL);
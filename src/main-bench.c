@@ -0,0 +1,404 @@
+/**
+ * \file main-bench.c
+ * \brief Pseudo-UI for timing screen updates (borrows from main-test.c)
+ *
+ * Keystrokes are replayed from standard input, in the same format as the
+ * input files of the end-to-end tests, and drawn into memory as a real
+ * front end would draw them to the screen.  When the input ends, the time
+ * taken and where it went are reported.
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "buildid.h"
+#include "grafmode.h"
+#include "main.h"
+#include "ui-game.h"
+#include "ui-prefs.h"
+#include "z-rand.h"
+
+#ifdef USE_BENCH
+
+#include <time.h>
+
+/**
+ * Size in pixels of a character or tile on the pretend display
+ */
+#define BENCH_CELL_WID 8
+#define BENCH_CELL_HGT 16
+
+/**
+ * Tiles across and down the pretend tile sheet
+ */
+#define BENCH_SHEET_COLS 64
+#define BENCH_SHEET_ROWS 64
+
+struct term_data {
+	term t;
+	uint32_t *pixels;
+	int pix_wid;
+};
+
+static struct term_data data[ANGBAND_TERM_MAX];
+static uint32_t *tile_sheet;
+
+/* Options */
+static int num_terms = 1;
+static int term_cols = 80, term_rows = 24;
+static uint32_t seed = 1;
+
+/* The run */
+static int nextkey = 0;
+static bool started = false, reported = false;
+static clock_t start_time;
+static uint32_t start_allocs;
+static uint32_t keys = 0, frames = 0, cells = 0;
+
+/**
+ * ------------------------------------------------------------------------
+ * Drawing
+ * ------------------------------------------------------------------------ */
+static uint32_t bench_colour(int a)
+{
+	const uint8_t *rgb = angband_color_table[(a & 0x7F) % MAX_COLORS];
+
+	return ((uint32_t) rgb[1] << 16) | ((uint32_t) rgb[2] << 8) | rgb[3];
+}
+
+static uint32_t *cell_pixels(struct term_data *td, int x, int y)
+{
+	return td->pixels + y * BENCH_CELL_HGT * td->pix_wid
+		+ x * BENCH_CELL_WID;
+}
+
+/**
+ * Draw a character cell, making up a glyph for it as a font would have
+ */
+static void draw_glyph(struct term_data *td, int x, int y, uint32_t fg,
+		wchar_t c)
+{
+	uint32_t *row = cell_pixels(td, x, y);
+	uint32_t shape = (uint32_t) c * 2654435761u;
+	int i, j;
+
+	for (j = 0; j < BENCH_CELL_HGT; j++, row += td->pix_wid) {
+		uint32_t bits = shape >> (j & 15);
+
+		for (i = 0; i < BENCH_CELL_WID; i++) {
+			row[i] = ((bits >> i) & 1) ? fg : 0;
+		}
+	}
+}
+
+/**
+ * Copy a tile from the sheet into a cell; transparent pixels (zero) are
+ * skipped unless it is the bottom layer
+ */
+static void draw_tile(struct term_data *td, int x, int y, int a, wchar_t c,
+		bool under)
+{
+	int col = (c & 0xFF) % BENCH_SHEET_COLS;
+	int row = (a & 0x7F) % BENCH_SHEET_ROWS;
+	const uint32_t *src = tile_sheet + (row * BENCH_CELL_HGT
+		* BENCH_SHEET_COLS + col) * BENCH_CELL_WID;
+	uint32_t *dest = cell_pixels(td, x, y);
+	int i, j;
+
+	for (j = 0; j < BENCH_CELL_HGT; j++) {
+		for (i = 0; i < BENCH_CELL_WID; i++) {
+			if (under || src[i]) dest[i] = src[i];
+		}
+		src += BENCH_SHEET_COLS * BENCH_CELL_WID;
+		dest += td->pix_wid;
+	}
+}
+
+static void make_tile_sheet(void)
+{
+	size_t i, n = (size_t) BENCH_SHEET_COLS * BENCH_SHEET_ROWS
+		* BENCH_CELL_WID * BENCH_CELL_HGT;
+
+	tile_sheet = mem_alloc(n * sizeof(*tile_sheet));
+	for (i = 0; i < n; i++) {
+		/* About a third of each tile is see-through */
+		tile_sheet[i] = (i % 3) ? (uint32_t) (i * 2654435761u) >> 8 : 0;
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Replaying input and reporting
+ * ------------------------------------------------------------------------ */
+static void bench_report(void)
+{
+	static const char *names[TIMED_MAX] = {
+		"handle_stuff", "prt_map", "Term_fresh"
+	};
+	double seconds;
+	int i;
+
+	if (reported || !started) return;
+	reported = true;
+	seconds = (double) (clock() - start_time) / CLOCKS_PER_SEC;
+
+	printf("bench: %s\n", buildid);
+	printf("bench: %u keys, %u frames in %.3f s", keys, frames, seconds);
+	if (seconds > 0) printf(", %.1f frames/s", frames / seconds);
+	printf("\n");
+	printf("bench: %-14s %8s %10s %12s\n", "section", "calls", "seconds",
+		"us per call");
+	for (i = 0; i < TIMED_MAX; i++) {
+		const struct section_time *s = &section_times[i];
+
+		printf("bench: %-14s %8u %10.4f %12.2f\n", names[i], s->calls,
+			s->seconds, s->calls ? 1e6 * s->seconds / s->calls : 0.0);
+	}
+	printf("bench: %u cells drawn, %u allocations", cells,
+		mem_alloc_count - start_allocs);
+	if (frames) {
+		printf(" (%.1f per frame)",
+			(double) (mem_alloc_count - start_allocs) / frames);
+	}
+	printf("\n");
+	fflush(stdout);
+}
+
+static void c_key(char *rest) {
+	if (!rest) return;
+	if (streq(rest, "left")) {
+		nextkey = ARROW_LEFT;
+	} else if (streq(rest, "right")) {
+		nextkey = ARROW_RIGHT;
+	} else if (streq(rest, "up")) {
+		nextkey = ARROW_UP;
+	} else if (streq(rest, "down")) {
+		nextkey = ARROW_DOWN;
+	} else if (streq(rest, "space")) {
+		nextkey = ' ';
+	} else if (streq(rest, "enter")) {
+		nextkey = '\n';
+	} else if (streq(rest, "escape")) {
+		nextkey = ESCAPE;
+	} else if (rest[0] == 'C' && rest[1] == '-') {
+		nextkey = KTRL(rest[2]);
+	} else {
+		nextkey = rest[0];
+	}
+}
+
+static void c_quit(char *rest) {
+	bench_report();
+	quit(NULL);
+}
+
+/**
+ * Read and carry out one line of input; other commands of the test front
+ * end are ignored, so its input files can be replayed as they are
+ */
+static void bench_docmd(void) {
+	char buf[1024];
+	char *cmd, *rest;
+
+	if (!fgets(buf, sizeof(buf), stdin)) {
+		c_quit(NULL);
+		return;
+	}
+	if (strchr(buf, '\n')) {
+		*strchr(buf, '\n') = '\0';
+	}
+
+	cmd = strtok(buf, " ");
+	if (!cmd) return;
+	rest = strtok(NULL, "");
+	if (streq(cmd, "key")) {
+		c_key(rest);
+	} else if (streq(cmd, "quit")) {
+		c_quit(rest);
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Term hooks
+ * ------------------------------------------------------------------------ */
+static void term_nuke_bench(term *t) {
+	struct term_data *td = t->data;
+
+	if (td == &data[0]) {
+		bench_report();
+		mem_free(tile_sheet);
+		tile_sheet = NULL;
+		close_graphics_modes();
+	}
+	mem_free(td->pixels);
+	td->pixels = NULL;
+}
+
+static errr term_xtra_bench(int n, int v) {
+	switch (n) {
+		case TERM_XTRA_EVENT: {
+			/* Start the clock once everything is loaded */
+			if (!started) {
+				started = true;
+				Rand_state_init(seed);
+				section_timing = true;
+				start_allocs = mem_alloc_count;
+				start_time = clock();
+			}
+			if (nextkey) {
+				Term_keypress(nextkey, 0);
+				nextkey = 0;
+				keys++;
+			}
+			bench_docmd();
+			return 0;
+		}
+		case TERM_XTRA_CLEAR: {
+			struct term_data *td = Term->data;
+
+			memset(td->pixels, 0, (size_t) td->pix_wid
+				* Term->hgt * BENCH_CELL_HGT * sizeof(*td->pixels));
+			return 0;
+		}
+		case TERM_XTRA_FRESH: {
+			if (started && Term->data == &data[0]) frames++;
+			return 0;
+		}
+	}
+	return 0;
+}
+
+static errr term_curs_bench(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_bench(int x, int y, int n) {
+	struct term_data *td = Term->data;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		draw_glyph(td, x + i, y, 0, 0);
+	}
+	if (started) cells += n;
+	return 0;
+}
+
+static errr term_text_bench(int x, int y, int n, int a, const wchar_t *s) {
+	struct term_data *td = Term->data;
+	uint32_t fg = bench_colour(a);
+	int i;
+
+	for (i = 0; i < n; i++) {
+		draw_glyph(td, x + i, y, fg, s[i]);
+	}
+	if (started) cells += n;
+	return 0;
+}
+
+static errr term_pict_bench(int x, int y, int n, const int *ap,
+		const wchar_t *cp, const int *tap, const wchar_t *tcp) {
+	struct term_data *td = Term->data;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		draw_tile(td, x + i, y, tap[i], tcp[i], true);
+		if (ap[i] != tap[i] || cp[i] != tcp[i]) {
+			draw_tile(td, x + i, y, ap[i], cp[i], false);
+		}
+	}
+	if (started) cells += n;
+	return 0;
+}
+
+static void term_data_link(int i) {
+	struct term_data *td = &data[i];
+	term *t = &td->t;
+
+	term_init(t, term_cols, term_rows, 256);
+
+	t->nuke_hook = term_nuke_bench;
+	t->xtra_hook = term_xtra_bench;
+	t->curs_hook = term_curs_bench;
+	t->wipe_hook = term_wipe_bench;
+	t->text_hook = term_text_bench;
+	t->pict_hook = term_pict_bench;
+	t->higher_pict = (use_graphics != GRAPHICS_NONE);
+
+	td->pix_wid = term_cols * BENCH_CELL_WID;
+	td->pixels = mem_zalloc((size_t) td->pix_wid * term_rows
+		* BENCH_CELL_HGT * sizeof(*td->pixels));
+	t->data = td;
+
+	if (!i) Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+const char help_bench[] = "Benchmark mode, subopts\n"
+	"              -n<num>  Number of terms to use (default 1)\n"
+	"              -s<cols>x<rows> Size of every term (default 80x24)\n"
+	"              -S<seed> Random number seed (default 1)\n"
+	"              Use -g to draw tiles rather than characters";
+
+errr init_bench(int argc, char *argv[]) {
+	int i;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (prefix(argv[i], "-n")) {
+			num_terms = atoi(&argv[i][2]);
+			if (num_terms < 1) num_terms = 1;
+			if (num_terms > ANGBAND_TERM_MAX) {
+				num_terms = ANGBAND_TERM_MAX;
+			}
+			continue;
+		}
+		if (prefix(argv[i], "-s")) {
+			int cols, rows;
+
+			if (sscanf(&argv[i][2], "%dx%d", &cols, &rows) == 2
+					&& cols >= 80 && rows >= 24) {
+				term_cols = cols;
+				term_rows = rows;
+			} else {
+				printf("init-bench: bad size '%s'\n", &argv[i][2]);
+			}
+			continue;
+		}
+		if (prefix(argv[i], "-S")) {
+			seed = (uint32_t) strtoul(&argv[i][2], NULL, 10);
+			continue;
+		}
+		printf("init-bench: bad argument '%s'\n", argv[i]);
+	}
+
+	/* Use the tile set asked for with -g, if there is one */
+	if (arg_graphics && init_graphics_modes()) {
+		graphics_mode *mode = get_graphics_mode(arg_graphics);
+
+		if (mode && mode->grafID != GRAPHICS_NONE) {
+			use_graphics = mode->grafID;
+			current_graphics_mode = mode;
+		}
+	}
+	make_tile_sheet();
+
+	/* Don't let the run load or overwrite a real savefile */
+	savefile[0] = '\0';
+
+	for (i = num_terms - 1; i >= 0; i--) {
+		term_data_link(i);
+	}
+	return 0;
+}
+#endif /* USE_BENCH */
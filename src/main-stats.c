@@ -43,6 +43,11 @@
 #include "store.h"
 #include <stddef.h>
 #include <time.h>
+#ifdef UNIX
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #define OBJ_FEEL_MAX	 11
 #define MON_FEEL_MAX 	 10
@@ -138,7 +143,12 @@ static const char *chosen_class = NULL;
 static const char *chosen_race = NULL;
 static int no_selling = 0;
 static uint32_t num_runs = 1;
+static uint32_t num_workers = 1;
+static uint32_t seed_base = 0;
+static bool seed_set = false;
 static bool quiet = false;
+static struct rng_state run_rng;
+static struct rng_state level_rng;
 static int nextkey = 0;
 static int running_stats = 0;
 static char *ANGBAND_DIR_STATS;
@@ -494,18 +504,25 @@ static void generate_player_for_stats(void)
 	player->history = get_history(player->race->history);
 }
 
-static void initialize_character(void)
+/**
+ * Set up the character for a run.  Each run uses a private generator seeded
+ * from its run number, so repeating a sweep with the same -S and -j gives
+ * the same results.  Levels come from a second one, so the dungeons of a
+ * run don't depend on how many numbers the play in between drew.
+ */
+static void initialize_character(uint32_t run)
 {
-	uint32_t seed;
-
 	if (!quiet) {
 		printf(" [I  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
 
-	seed = (time(NULL));
-	Rand_quick = false;
-	Rand_state_init(seed);
+	run_rng.quick = false;
+	Rand_state_init_r(&run_rng, seed_base + run);
+	Rand_use(&run_rng);
+	level_rng.quick = false;
+	Rand_state_init_r(&level_rng, ~(seed_base + run));
+	generate_set_rng(&level_rng);
 
 	player_init(player);
 	generate_player_for_stats();
@@ -1181,6 +1198,11 @@ static int stats_dump_info(void)
 	err = stats_db_exec(sql_buf);
 	if (err) return err;
 
+	strnfmt(sql_buf, 256, "INSERT INTO metadata VALUES('seed',%lu);",
+		(unsigned long)seed_base);
+	err = stats_db_exec(sql_buf);
+	if (err) return err;
+
 	err = stats_dump_artifacts();
 	if (err) return err;
 
@@ -1709,6 +1731,22 @@ static void progress_bar(uint32_t run, time_t start) {
 
 static void stats_cleanup_angband_run(void)
 {
+	int i;
+
+	/*
+	 * Discard the stored levels, so the next run doesn't revisit this
+	 * run's town and wilderness.
+	 */
+	for (i = 0; i < chunk_list_max; i++) {
+		if (chunk_list[i] != cave && chunk_list[i] != player->cave) {
+			chunk_expand(chunk_list[i]);
+			wipe_mon_list(chunk_list[i], player);
+			cave_free(chunk_list[i]);
+		}
+		chunk_list[i] = NULL;
+	}
+	chunk_list_max = 0;
+
 	if (character_dungeon) {
 		wipe_mon_list(cave, player);
 		if (player->cave) {
@@ -1723,8 +1761,294 @@ static void stats_cleanup_angband_run(void)
 	}
 	mem_free(player->history);
 	player->history = NULL;
+	generate_set_rng(NULL);
+	Rand_use(&Rand_state);
+}
+
+/**
+ * Do one complete run through the dungeon.
+ */
+static void stats_do_run(uint32_t run)
+{
+	initialize_character(run);
+	unkill_uniques();
+	reset_artifacts();
+	descend_dungeon();
+	stats_cleanup_angband_run();
+}
+
+/**
+ * Write or merge a counter array of the per-worker aggregate.  Only the
+ * non-zero counts are written, as (index, count) pairs ending with
+ * UINT32_MAX.  When merging, the counts read are added to the array.
+ */
+static bool stats_xfer_uint32(ang_file *f, bool merge, uint32_t *a,
+		uint32_t n)
+{
+	uint32_t i = 0, v;
+
+	if (!merge) {
+		for (i = 0; i < n; i++) {
+			if (!a[i]) continue;
+			if (!file_write(f, (char*)&i, sizeof(i))
+					|| !file_write(f, (char*)&a[i],
+					sizeof(a[i]))) {
+				return false;
+			}
+		}
+		i = UINT32_MAX;
+		return file_write(f, (char*)&i, sizeof(i));
+	}
+
+	while (1) {
+		if (file_read(f, (char*)&i, sizeof(i)) != sizeof(i)) {
+			return false;
+		}
+		if (i == UINT32_MAX) return true;
+		if (i >= n || file_read(f, (char*)&v, sizeof(v))
+				!= sizeof(v)) {
+			return false;
+		}
+		a[i] += v;
+	}
+}
+
+/**
+ * As stats_xfer_uint32(), for the gold totals.
+ */
+static bool stats_xfer_long_long(ang_file *f, bool merge, long long *a,
+		uint32_t n)
+{
+	uint32_t i = 0;
+	long long v;
+
+	if (!merge) {
+		for (i = 0; i < n; i++) {
+			if (!a[i]) continue;
+			if (!file_write(f, (char*)&i, sizeof(i))
+					|| !file_write(f, (char*)&a[i],
+					sizeof(a[i]))) {
+				return false;
+			}
+		}
+		i = UINT32_MAX;
+		return file_write(f, (char*)&i, sizeof(i));
+	}
+
+	while (1) {
+		if (file_read(f, (char*)&i, sizeof(i)) != sizeof(i)) {
+			return false;
+		}
+		if (i == UINT32_MAX) return true;
+		if (i >= n || file_read(f, (char*)&v, sizeof(v))
+				!= sizeof(v)) {
+			return false;
+		}
+		a[i] += v;
+	}
+}
+
+/**
+ * Write all of level_data[] to a worker's aggregate file, or add the
+ * contents of such a file to level_data[].  Wearables which never appeared
+ * are skipped entirely.
+ */
+static bool stats_xfer_level_data(ang_file *f, bool merge)
+{
+	int level, j, l;
+
+	for (level = 0; level < LEVEL_MAX; level++) {
+		struct level_data *ld = &level_data[level];
+
+		if (!stats_xfer_uint32(f, merge, ld->monsters, z_info->r_max)
+				|| !stats_xfer_uint32(f, merge, ld->obj_feelings,
+				OBJ_FEEL_MAX)
+				|| !stats_xfer_uint32(f, merge, ld->mon_feelings,
+				MON_FEEL_MAX)
+				|| !stats_xfer_long_long(f, merge, ld->gold,
+				ORIGIN_STATS)) {
+			return false;
+		}
+
+		for (j = 0; j < ORIGIN_STATS; j++) {
+			uint32_t k = 0;
+
+			if (!stats_xfer_uint32(f, merge, ld->artifacts[j],
+					z_info->a_max)
+					|| !stats_xfer_uint32(f, merge,
+					ld->consumables[j],
+					consumable_count + 1)) {
+				return false;
+			}
+
+			while (1) {
+				struct wearables_data *w;
+
+				if (merge) {
+					if (file_read(f, (char*)&k, sizeof(k))
+							!= sizeof(k)) {
+						return false;
+					}
+					if (k == UINT32_MAX) break;
+					if (k >= (uint32_t)wearable_count + 1) {
+						return false;
+					}
+				} else {
+					while (k < (uint32_t)wearable_count + 1
+							&& !ld->wearables[j][k].count) {
+						k++;
+					}
+					if (k == (uint32_t)wearable_count + 1) {
+						k = UINT32_MAX;
+						if (!file_write(f, (char*)&k,
+								sizeof(k))) {
+							return false;
+						}
+						break;
+					}
+					if (!file_write(f, (char*)&k, sizeof(k))) {
+						return false;
+					}
+				}
+
+				w = &ld->wearables[j][k];
+				if (!stats_xfer_uint32(f, merge, &w->count, 1)
+						|| !stats_xfer_uint32(f, merge,
+						&w->dice[0][0],
+						TOP_DICE * TOP_SIDES)
+						|| !stats_xfer_uint32(f, merge, w->ac,
+						TOP_AC)
+						|| !stats_xfer_uint32(f, merge, w->hit,
+						TOP_PLUS)
+						|| !stats_xfer_uint32(f, merge, w->dam,
+						TOP_PLUS)
+						|| !stats_xfer_uint32(f, merge, w->egos,
+						z_info->e_max)
+						|| !stats_xfer_uint32(f, merge, w->flags,
+						OF_MAX)) {
+					return false;
+				}
+				for (l = 0; l < TOP_MOD; l++) {
+					if (!stats_xfer_uint32(f, merge,
+							w->modifiers[l],
+							OBJ_MOD_MAX + 1)) {
+						return false;
+					}
+				}
+				k++;
+			}
+		}
+	}
+
+	return true;
 }
 
+static void stats_worker_filename(char *buf, size_t len, uint32_t worker)
+{
+	char leaf[32];
+
+	strnfmt(leaf, sizeof(leaf), "worker-%lu.dat", (unsigned long)worker);
+	path_build(buf, len, ANGBAND_DIR_STATS, leaf);
+}
+
+#ifdef UNIX
+/**
+ * Do the runs with num_workers forked processes.  Worker w does a
+ * contiguous block of the runs, reports each finished run by writing a byte
+ * to a pipe and, when done, writes its counts to its own aggregate file.
+ * The parent shows the progress and then merges the aggregates, so the
+ * totals depend on the seeds and the number of workers but not on how the
+ * workers were scheduled.
+ */
+static void run_stats_parallel(time_t start)
+{
+	pid_t *pids = mem_zalloc(num_workers * sizeof(*pids));
+	int progress[2];
+	uint32_t w, done = 0;
+	char buf[1024];
+	bool failed = false;
+
+	if (pipe(progress)) quit("Couldn't create the progress pipe!");
+	fflush(stdout);
+
+	for (w = 0; w < num_workers; w++) {
+		uint32_t first = 1 + (uint32_t)(((uint64_t)w * num_runs)
+			/ num_workers);
+		uint32_t last = (uint32_t)(((uint64_t)(w + 1) * num_runs)
+			/ num_workers);
+
+		pids[w] = fork();
+		if (pids[w] < 0) quit("Couldn't start a stats worker!");
+		if (pids[w] == 0) {
+			ang_file *f;
+			uint32_t run;
+			bool ok;
+
+			close(progress[0]);
+			quiet = true;
+			for (run = first; run <= last; run++) {
+				char c = 0;
+
+				stats_do_run(run);
+				if (write(progress[1], &c, 1) != 1) _exit(1);
+			}
+
+			stats_worker_filename(buf, sizeof(buf), w);
+			f = file_open(buf, MODE_WRITE, FTYPE_RAW);
+			if (!f) _exit(1);
+			ok = stats_xfer_level_data(f, false);
+			ok = file_close(f) && ok;
+			_exit(ok ? 0 : 1);
+		}
+	}
+
+	close(progress[1]);
+	while (1) {
+		char chunk[64];
+		ssize_t n = read(progress[0], chunk, sizeof(chunk));
+
+		if (n <= 0) break;
+		done += (uint32_t)n;
+		if (!quiet) {
+			progress_bar(done, start);
+		} else if (done / 1000 != (done - n) / 1000) {
+			printf("Finished %d runs.\n", (done / 1000) * 1000);
+			fflush(stdout);
+		}
+	}
+	close(progress[0]);
+
+	for (w = 0; w < num_workers; w++) {
+		int status;
+
+		if (waitpid(pids[w], &status, 0) != pids[w]
+				|| !WIFEXITED(status) || WEXITSTATUS(status)) {
+			failed = true;
+		}
+	}
+	mem_free(pids);
+
+	for (w = 0; w < num_workers; w++) {
+		ang_file *f;
+
+		stats_worker_filename(buf, sizeof(buf), w);
+		if (!failed) {
+			f = file_open(buf, MODE_READ, FTYPE_RAW);
+			if (!f || !stats_xfer_level_data(f, true)) {
+				failed = true;
+			}
+			if (f) file_close(f);
+		}
+		file_delete(buf);
+	}
+
+	if (failed || done != num_runs) {
+		stats_db_close();
+		quit("A stats worker failed!");
+	}
+}
+#endif
+
 static errr run_stats(void)
 {
 	uint32_t run;
@@ -1737,6 +2061,8 @@ static errr run_stats(void)
 	create_indices();
 	alloc_memory();
 
+	if (!seed_set) seed_base = (uint32_t)time(NULL);
+
 	if (!quiet) printf("Creating the database and dumping info...\n");
 	status = stats_prep_db();
 	if (!status) quit("Couldn't prepare database!");
@@ -1747,14 +2073,15 @@ static errr run_stats(void)
 	}
 
 	start = time(NULL);
+#ifdef UNIX
+	if (num_workers > 1) {
+		run_stats_parallel(start);
+	} else
+#endif
 	for (run = 1; run <= num_runs; run++) {
 		if (!quiet) progress_bar(run - 1, start);
 
-		initialize_character();
-		unkill_uniques();
-		reset_artifacts();
-		descend_dungeon();
-		stats_cleanup_angband_run();
+		stats_do_run(run);
 
 		/* Checkpoint every so many runs */
 		if (run % RUNS_PER_CHECKPOINT == 0) {
@@ -1778,7 +2105,7 @@ static errr run_stats(void)
 		fflush(stdout);
 	}
 
-	err = stats_write_db(run);
+	err = stats_write_db(num_runs);
 	stats_db_close();
 	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
 
@@ -1910,15 +2237,20 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling) -C(class name) -R(race name)";
+const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -j(# of workers) -S(seed) -s(no selling) -C(class name) -R(race name)";
 
 /**
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * angband -mstats -- [-q] [-r] [-nNNNN] [-jNN] [-SNNNN] [-s]
  *
  *   -q      Quiet mode (turn off progress messages)
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
+ *   -jNN    Split the runs between NN worker processes (default: 1).  The
+ *           database is only written once all the workers are done, so
+ *           there are no checkpoints.  Only available on UNIX.
+ *   -SNNNN  Seed run n with NNNN + n, so the results can be reproduced
+ *           (default: the time at startup)
  *   -s      Turn on no-selling
  *   -Cname  Use name, case-insensitive, as the player's class.  When not set,
  *           the player's class is the first class in lib/gamedata/class.txt.
@@ -1939,6 +2271,15 @@ errr init_stats(int argc, char *argv[]) {
 			num_runs = atoi(&argv[i][2]);
 			continue;
 		}
+		if (prefix(argv[i], "-j")) {
+			num_workers = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
+		if (prefix(argv[i], "-S")) {
+			seed_base = strtoul(&argv[i][2], NULL, 10);
+			seed_set = true;
+			continue;
+		}
 		if (prefix(argv[i], "-s")) {
 			no_selling = 1;
 			continue;
@@ -1954,6 +2295,14 @@ errr init_stats(int argc, char *argv[]) {
 		printf("init-stats: bad argument '%s'\n", argv[i]);
 	}
 
+	num_workers = MIN(num_workers, MAX(num_runs, 1));
+#ifndef UNIX
+	if (num_workers > 1) {
+		printf("init-stats: -j is not supported here; using one process\n");
+		num_workers = 1;
+	}
+#endif
+
 	term_data_link(0);
 	return 0;
 }
@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "buildid.h"
+#include "datafile.h"
 #include "init.h"
 #include "savefile.h"
 #include "ui-birth.h"
@@ -84,6 +85,10 @@ static const struct module modules[] =
 	{ "test", help_test, init_test, false, true },
 #endif /* !USE_TEST */
 
+#ifdef USE_BENCH
+	{ "bench", help_bench, init_bench, false, true },
+#endif /* USE_BENCH */
+
 #ifdef USE_STATS
 	{ "stats", help_stats, init_stats, false, true },
 #endif /* USE_STATS */
@@ -335,6 +340,30 @@ static void list_saves(void)
 	cleanup_savefile_getter(g);
 }
 
+/**
+ * Time the parsing of each game data file, report and exit.
+ */
+static void bench_init(void)
+{
+	double total = 0.0;
+	unsigned int lines = 0;
+	int i;
+
+	parse_timing = true;
+	init_angband();
+	printf("%-24s %8s %10s\n", "File", "Lines", "Seconds");
+	for (i = 0; i < parse_times_num; i++) {
+		printf("%-24s %8u %10.4f\n", parse_times[i].name,
+			parse_times[i].lines, parse_times[i].seconds);
+		lines += parse_times[i].lines;
+		total += parse_times[i].seconds;
+	}
+	printf("%-24s %8u %10.4f\n", "Total", lines, total);
+	parse_times_free();
+	cleanup_angband();
+	exit(0);
+}
+
 /**
  * Simple "main" function for multiple platforms.
  *
@@ -346,7 +375,7 @@ int main(int argc, char *argv[])
 {
 	int i;
 	bool new_game = false, select_game = false;
-	bool done = false;
+	bool done = false, bench = false;
 
 	const char *mstr = NULL;
 	bool args = true;
@@ -454,6 +483,10 @@ int main(int argc, char *argv[])
 				continue;
 
 			case '-':
+				if (streq(arg, "bench-init")) {
+					bench = true;
+					continue;
+				}
 				argv[i] = argv[0];
 				argc = argc - i;
 				argv = argv + i;
@@ -466,6 +499,7 @@ int main(int argc, char *argv[])
 				puts("  -c             Select savefile with a menu; overrides -n");
 				puts("  -n             Start a new character (WARNING: overwrites default savefile without -u)");
 				puts("  -l             Lists all savefiles you can play");
+				puts("  --bench-init   Report the time taken to parse each game data file");
 				puts("  -w             Resurrect dead character (marks savefile)");
 				puts("  -g             Request graphics mode");
 				puts("  -u<who>        Use your <who> savefile");
@@ -532,6 +566,9 @@ int main(int argc, char *argv[])
 
 #endif /* UNIX */
 
+	/* Time the data files instead of playing, if asked */
+	if (bench) bench_init();
+
 	/* Try the modules in the order specified by modules[] */
 	for (i = 0; i < (int)N_ELEMENTS(modules); i++) {
 		/* User requested a specific module? */
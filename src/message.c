@@ -34,11 +34,19 @@
 #include "init.h"
 #include "player.h"
 
+/**
+ * Message text, shared by every message in the log with the same text
+ */
+typedef struct _msgtext_t
+{
+	uint32_t hash;
+	uint32_t refs;
+	char str[];
+} msgtext_t;
+
 typedef struct _message_t
 {
-	char *str;
-	struct _message_t *newer;
-	struct _message_t *older;
+	msgtext_t *text;
 	uint16_t type;
 	uint16_t count;
 } message_t;
@@ -50,10 +58,17 @@ typedef struct _msgcolor_t
 	struct _msgcolor_t *next;
 } msgcolor_t;
 
+/**
+ * The log is a ring of `max` messages, the newest at `head`; the texts in
+ * use are in an open addressing hash table of `text_size` slots, a power
+ * of two which is at least twice `max`.
+ */
 typedef struct _msgqueue_t
 {
-	message_t *head;
-	message_t *tail;
+	message_t *ring;
+	uint32_t head;
+	msgtext_t **texts;
+	uint32_t text_size;
 	msgcolor_t *colors;
 	uint32_t count;
 	uint32_t max;
@@ -61,6 +76,77 @@ typedef struct _msgqueue_t
 
 static msgqueue_t *messages = NULL;
 
+/**
+ * ------------------------------------------------------------------------
+ * Shared message text
+ * ------------------------------------------------------------------------ */
+/**
+ * Find the table slot holding `str`, or the empty slot where it would go.
+ */
+static uint32_t message_text_slot(const char *str, uint32_t hash)
+{
+	uint32_t mask = messages->text_size - 1;
+	uint32_t i = hash & mask;
+
+	while (messages->texts[i]) {
+		msgtext_t *t = messages->texts[i];
+
+		if (t->hash == hash && streq(t->str, str)) break;
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/**
+ * Get a reference to the shared copy of `str`, making it if need be.
+ */
+static msgtext_t *message_text_get(const char *str)
+{
+	uint32_t hash = djb2_hash(str);
+	uint32_t i = message_text_slot(str, hash);
+	msgtext_t *t = messages->texts[i];
+
+	if (!t) {
+		size_t len = strlen(str);
+
+		t = mem_alloc(sizeof(*t) + len + 1);
+		t->hash = hash;
+		t->refs = 0;
+		memcpy(t->str, str, len + 1);
+		messages->texts[i] = t;
+	}
+	t->refs++;
+	return t;
+}
+
+/**
+ * Drop a reference to shared text, freeing it when it is no longer used.
+ *
+ * Later entries in the same probe run are shifted back over the hole, so
+ * no lookup ever stops short of what it is looking for.
+ */
+static void message_text_release(msgtext_t *t)
+{
+	uint32_t mask = messages->text_size - 1;
+	uint32_t hole, i;
+
+	if (--t->refs) return;
+
+	hole = message_text_slot(t->str, t->hash);
+	mem_free(t);
+	messages->texts[hole] = NULL;
+	for (i = (hole + 1) & mask; messages->texts[i]; i = (i + 1) & mask) {
+		uint32_t home = messages->texts[i]->hash & mask;
+
+		/* Move the entry if its home is not between the hole and it */
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			messages->texts[hole] = messages->texts[i];
+			messages->texts[i] = NULL;
+			hole = i;
+		}
+	}
+}
+
 /**
  * ------------------------------------------------------------------------
  * Functions operating on the entire list
@@ -73,6 +159,12 @@ void messages_init(void)
 {
 	messages = mem_zalloc(sizeof(msgqueue_t));
 	messages->max = 2048;
+	messages->ring = mem_zalloc(messages->max * sizeof(message_t));
+	messages->text_size = 1;
+	while (messages->text_size < 2 * messages->max) {
+		messages->text_size *= 2;
+	}
+	messages->texts = mem_zalloc(messages->text_size * sizeof(msgtext_t*));
 }
 
 /**
@@ -82,15 +174,13 @@ void messages_free(void)
 {
 	msgcolor_t *c = messages->colors;
 	msgcolor_t *nextc;
-	message_t *m = messages->head;
-	message_t *nextm;
-
-	while (m) {
-		nextm = m->older;
-		mem_free(m->str);
-		mem_free(m);
-		m = nextm;
+	uint32_t i;
+
+	for (i = 0; i < messages->text_size; i++) {
+		mem_free(messages->texts[i]);
 	}
+	mem_free(messages->texts);
+	mem_free(messages->ring);
 
 	while (c) {
 		nextc = c->next;
@@ -113,6 +203,16 @@ uint16_t messages_num(void)
  * ------------------------------------------------------------------------
  * Functions for individual messages
  * ------------------------------------------------------------------------ */
+/**
+ * Returns the message of age `age`.
+ */
+static message_t *message_get(uint16_t age)
+{
+	if (age >= messages->count) return NULL;
+	return &messages->ring[(messages->head + messages->max - age)
+		% messages->max];
+}
+
 /**
  * Save a new message into the memory buffer, with text `str` and type `type`.
  * The type should be one of the MSG_ constants defined in message.h.
@@ -123,58 +223,32 @@ uint16_t messages_num(void)
  */
 void message_add(const char *str, uint16_t type)
 {
-	message_t *m;
-
-	if (messages->head &&
-	    messages->head->type == type &&
-	    streq(messages->head->str, str) &&
-	    messages->head->count != (uint16_t)-1) {
-		messages->head->count++;
+	message_t *m = message_get(0);
+	msgtext_t *text;
+
+	if (m &&
+	    m->type == type &&
+	    streq(m->text->str, str) &&
+	    m->count != (uint16_t)-1) {
+		m->count++;
 		return;
 	}
 
-	m = mem_zalloc(sizeof(message_t));
-	m->str = string_make(str);
-	m->type = type;
-	m->count = 1;
-	m->older = messages->head;
-
-	if (messages->head)
-		messages->head->newer = m;
-
-	messages->head = m;
-	messages->count++;
-
-	if (!messages->tail)
-		messages->tail = m;
-
-	if (messages->count > messages->max) {
-		message_t *old_tail = messages->tail;
-
-		messages->tail = old_tail->newer;
-		messages->tail->older = NULL;
-		mem_free(old_tail->str);
-		mem_free(old_tail);
-		messages->count--;
-	}
-}
-
-/**
- * Returns the message of age `age`.
- */
-static message_t *message_get(uint16_t age)
-{
-	message_t *m = messages->head;
-
-	while (m && age) {
-		age--;
-		m = m->older;
+	/* Take the next slot, losing the oldest message if the log is full */
+	text = message_text_get(str);
+	messages->head = (messages->head + 1) % messages->max;
+	m = &messages->ring[messages->head];
+	if (messages->count == messages->max) {
+		message_text_release(m->text);
+	} else {
+		messages->count++;
 	}
 
-	return m;
+	m->text = text;
+	m->type = type;
+	m->count = 1;
 }
 
-
 /**
  * Returns the text of the message of age `age`.  The age of the most recently
  * saved message is 0, the one before that is of age 1, etc.
@@ -185,7 +259,7 @@ static message_t *message_get(uint16_t age)
 const char *message_str(uint16_t age)
 {
 	message_t *m = message_get(age);
-	return (m ? m->str : "");
+	return (m ? m->text->str : "");
 }
 
 /**
@@ -41,6 +41,7 @@ struct monster_pain *pain_messages;
 struct monster_spell *monster_spells;
 struct monster_base *rb_info;
 struct monster_race *r_info;
+int r_light_max;
 struct ghost *ghosts;
 const struct monster_race *ref_race = NULL;
 struct monster_lore *l_list;
@@ -1751,14 +1752,16 @@ static errr finish_parse_monster(struct parser *p) {
 	errr result = PARSE_ERROR_NONE;
 	int maxe = get_parser_error_limit(), counte = 0;
 
-	/* Scan the list for the max id and max blows */
+	/* Scan the list for the max id, max blows and brightest light */
 	z_info->r_max = 0;
 	z_info->mon_blows_max = 0;
+	r_light_max = 0;
 	r = parser_priv(p);
 	while (r) {
 		int max_blows = 0;
 		struct monster_blow *b = r->blow;
 		z_info->r_max++;
+		r_light_max = MAX(r_light_max, ABS(r->light));
 		while (b) {
 			b = b->next;
 			max_blows++;
@@ -1946,6 +1949,7 @@ static void cleanup_monster(void)
 	mem_free(r_info[z_info->r_max - 1].blow);
 
 	mem_free(r_info);
+	mon_lookup_cleanup();
 }
 
 struct file_parser monster_parser = {
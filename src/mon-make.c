@@ -23,6 +23,7 @@
 #include "mon-group.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-predicate.h"
 #include "mon-spell.h"
 #include "mon-timed.h"
@@ -49,13 +50,54 @@ int **race_prob;
  * - prob2 is calculated by get_mon_num_prep(), which decides whether a
  *         monster is appropriate based on a secondary function; prob2 is
  *         always either prob1 or 0.
- * - prob3 is calculated by get_mon_num(), which checks whether universal
- *         restrictions apply (for example, unique monsters can only appear
- *         once on a given level); prob3 is always either prob2 or 0.
+ * - prob3 is the chance get_mon_num() gives the race, after checking
+ *         whether universal restrictions apply (for example, unique monsters
+ *         can only appear once on a given level) and adjusting for locality
+ *         and topography; it is kept in get_mon_num()'s cached samplers
+ *         rather than the table.
  * ------------------------------------------------------------------------ */
 static int16_t alloc_race_size;
 static struct alloc_entry *alloc_race_table;
 
+/**
+ * Which entries of the allocation table get_mon_num_prep() last allowed,
+ * one bit per entry
+ */
+static uint8_t *alloc_race_allowed;
+
+/**
+ * Cached samplers for get_mon_num().
+ *
+ * The races get_mon_num() can choose, and their chances, are fixed by the
+ * entries get_mon_num_prep() allowed, the level the monster is generated
+ * for, the player's place and depth, and whether it is Christmas.  The only
+ * exception is uniques which are all in play, and those are turned down
+ * when drawn and drawn again.  Each combination in use gets a Walker alias
+ * table, so that a draw takes constant time.
+ */
+#define MON_SAMPLER_MAX 8
+
+struct mon_sampler {
+	/* What the sampler was made for */
+	uint8_t *allowed;
+	int level;
+	struct level_map *map;
+	int place;
+	int depth;
+	bool seasonal;
+
+	uint32_t used;			/**< when this sampler was last used */
+	int num;			/**< number of races that can be chosen */
+	struct monster_race **races;
+	int32_t *weight;		/**< the prob3 each race would have had */
+	int32_t total;			/**< sum of the weights */
+	uint32_t *cut;			/**< out of total, chance to keep race */
+	int *alias;			/**< otherwise take this one instead */
+};
+
+static struct mon_sampler mon_samplers[MON_SAMPLER_MAX];
+static uint32_t mon_sampler_clock;
+
 /**
  * Initialize monster allocation info
  */
@@ -137,9 +179,30 @@ static void init_race_allocs(void) {
 	}
 	mem_free(already_counted);
 	mem_free(num);
+
+	/* Everything is allowed until get_mon_num_prep() says otherwise */
+	alloc_race_allowed = mem_alloc((alloc_race_size + 7) / 8);
+	memset(alloc_race_allowed, 0xff, (alloc_race_size + 7) / 8);
+}
+
+static void mon_sampler_free(struct mon_sampler *sampler)
+{
+	mem_free(sampler->allowed);
+	mem_free(sampler->races);
+	mem_free(sampler->weight);
+	mem_free(sampler->cut);
+	mem_free(sampler->alias);
+	memset(sampler, 0, sizeof(*sampler));
 }
 
 static void cleanup_race_allocs(void) {
+	int i;
+
+	for (i = 0; i < MON_SAMPLER_MAX; i++) {
+		mon_sampler_free(&mon_samplers[i]);
+	}
+	mem_free(alloc_race_allowed);
+	alloc_race_allowed = NULL;
 	mem_free(alloc_race_table);
 }
 
@@ -162,31 +225,25 @@ void get_mon_num_prep(bool (*get_mon_num_hook)(struct monster_race *race))
 		if (!get_mon_num_hook || (*get_mon_num_hook)(&r_info[entry->index])) {
 			/* Accept this monster */
 			entry->prob2 = entry->prob1;
-
+			alloc_race_allowed[i / 8] |= 1 << (i % 8);
 		} else {
 			/* Do not use this monster */
 			entry->prob2 = 0;
+			alloc_race_allowed[i / 8] &= ~(1 << (i % 8));
 		}
 	}
 }
 
 /**
  * Helper function for get_mon_num(). Excludes monsters from selection
- * based on time, uniqueness, depth, locality, or topography
+ * based on time, depth, locality, or topography
  */
-static bool get_mon_forbidden(struct monster_race *race)
+static bool get_mon_forbidden(struct monster_race *race, bool seasonal)
 {
-	time_t cur_time = time(NULL);
-	struct tm *date = localtime(&cur_time);
 	struct level *lev = &world->levels[player->place];
 
 	/* No seasonal monsters outside of Christmas */
-	if (rf_has(race->flags, RF_SEASONAL) &&
-		!(date->tm_mon == 11 && date->tm_mday >= 24 && date->tm_mday <= 26))
-		return true;
-
-	/* Only one copy of a a unique must be around at the same time */
-	if (rf_has(race->flags, RF_UNIQUE) && (race->cur_num >= race->max_num))
+	if (rf_has(race->flags, RF_SEASONAL) && !seasonal)
 		return true;
 
 	/* Some monsters never appear out of depth */
@@ -286,28 +343,180 @@ static int get_mon_adjust(int prob, struct monster_race *race)
 }
 
 /**
- * Helper function for get_mon_num(). Scans the prepared monster allocation
- * table and picks a random monster. Returns the index of a monster in
- * `table`.
+ * Only one copy of a unique must be around at the same time
  */
-static struct monster_race *get_mon_race_aux(long total,
-											 const alloc_entry *table)
+static bool get_mon_used_up(const struct monster_race *race)
 {
+	return rf_has(race->flags, RF_UNIQUE) && race->cur_num >= race->max_num;
+}
+
+/**
+ * Fill in a sampler's races and weights from the allocation table, then
+ * make its alias table
+ */
+static void mon_sampler_build(struct mon_sampler *sampler)
+{
+	const alloc_entry *table = alloc_race_table;
+	uint64_t *scaled;
+	int *work, i, small = 0, large;
+
+	sampler->races = mem_alloc(alloc_race_size * sizeof(*sampler->races));
+	sampler->weight = mem_alloc(alloc_race_size * sizeof(*sampler->weight));
+	sampler->num = 0;
+	sampler->total = 0;
+	for (i = 0; i < alloc_race_size; i++) {
+		struct monster_race *race;
+		int prob;
+
+		/* Monsters are sorted by depth */
+		if (table[i].level > sampler->level) break;
+
+		/* No town monsters in dungeon */
+		if (sampler->level > 0 && table[i].level <= 0) continue;
+		if (!table[i].prob2) continue;
+
+		/* Some monsters will not be allowed on the current level */
+		race = &r_info[table[i].index];
+		if (get_mon_forbidden(race, sampler->seasonal)) continue;
+
+		/* Adjust for locality and topography */
+		prob = get_mon_adjust(table[i].prob2, race);
+		if (prob <= 0) continue;
+		sampler->races[sampler->num] = race;
+		sampler->weight[sampler->num++] = prob;
+		sampler->total += prob;
+	}
+
+	/*
+	 * Vose's construction, in integers so the chances are exact: each of
+	 * the num columns holds total, split between at most two races
+	 */
+	sampler->cut = mem_alloc(MAX(sampler->num, 1) * sizeof(*sampler->cut));
+	sampler->alias = mem_alloc(MAX(sampler->num, 1) *
+		sizeof(*sampler->alias));
+	scaled = mem_alloc(MAX(sampler->num, 1) * sizeof(*scaled));
+	work = mem_alloc(MAX(sampler->num, 1) * sizeof(*work));
+	large = sampler->num;
+	for (i = 0; i < sampler->num; i++) {
+		scaled[i] = (uint64_t) sampler->weight[i] * sampler->num;
+		if (scaled[i] < (uint64_t) sampler->total) {
+			work[small++] = i;
+		} else {
+			work[--large] = i;
+		}
+	}
+	while (small && large < sampler->num) {
+		int s = work[--small], l = work[large];
+
+		sampler->cut[s] = scaled[s];
+		sampler->alias[s] = l;
+		scaled[l] -= sampler->total - scaled[s];
+		if (scaled[l] < (uint64_t) sampler->total) {
+			large++;
+			work[small++] = l;
+		}
+	}
+	while (small) {
+		i = work[--small];
+		sampler->cut[i] = sampler->total;
+		sampler->alias[i] = i;
+	}
+	while (large < sampler->num) {
+		i = work[large++];
+		sampler->cut[i] = sampler->total;
+		sampler->alias[i] = i;
+	}
+	mem_free(work);
+	mem_free(scaled);
+}
+
+/**
+ * Get the sampler for the current allocation table, the given level and
+ * the player's situation, making it if need be
+ */
+static struct mon_sampler *mon_sampler_get(int level)
+{
+	time_t cur_time = time(NULL);
+	struct tm *date = localtime(&cur_time);
+	bool seasonal = date->tm_mon == 11 && date->tm_mday >= 24
+		&& date->tm_mday <= 26;
+	size_t allowed_size = (alloc_race_size + 7) / 8;
+	struct mon_sampler *sampler = NULL;
 	int i;
 
-	/* Pick a monster */
-	long value = randint0(total);
+	for (i = 0; i < MON_SAMPLER_MAX; i++) {
+		struct mon_sampler *check = &mon_samplers[i];
+
+		if (check->allowed && check->level == level
+				&& check->map == world
+				&& check->place == player->place
+				&& check->depth == player->depth
+				&& check->seasonal == seasonal
+				&& !memcmp(check->allowed, alloc_race_allowed,
+				allowed_size)) {
+			check->used = ++mon_sampler_clock;
+			return check;
+		}
 
-	/* Find the monster */
-	for (i = 0; i < alloc_race_size; i++) {
-		/* Found the entry */
-		if (value < table[i].prob3) break;
+		/* Remember the empty or least recently used one */
+		if (!sampler || (sampler->allowed && (!check->allowed
+				|| check->used < sampler->used))) {
+			sampler = check;
+		}
+	}
+
+	mon_sampler_free(sampler);
+	sampler->allowed = mem_alloc(allowed_size);
+	memcpy(sampler->allowed, alloc_race_allowed, allowed_size);
+	sampler->level = level;
+	sampler->map = world;
+	sampler->place = player->place;
+	sampler->depth = player->depth;
+	sampler->seasonal = seasonal;
+	sampler->used = ++mon_sampler_clock;
+	mon_sampler_build(sampler);
+	return sampler;
+}
 
-		/* Decrement */
-		value -= table[i].prob3;
+/**
+ * Helper function for get_mon_num(). Picks a random monster from a sampler,
+ * or returns NULL if there is none to pick.
+ */
+static struct monster_race *get_mon_race_aux(const struct mon_sampler *sampler)
+{
+	int32_t value;
+	int i, tries;
+
+	if (sampler->total <= 0) return NULL;
+
+	/* Draw from the alias table, turning down used up uniques */
+	for (tries = 0; tries < 100; tries++) {
+		struct monster_race *race;
+
+		i = randint0(sampler->num);
+		if ((uint32_t) randint0(sampler->total) < sampler->cut[i]) {
+			race = sampler->races[i];
+		} else {
+			race = sampler->races[sampler->alias[i]];
+		}
+		if (!get_mon_used_up(race)) return race;
 	}
 
-	return &r_info[table[i].index];
+	/* Nearly everything is used up, so look through what's left */
+	value = 0;
+	for (i = 0; i < sampler->num; i++) {
+		if (!get_mon_used_up(sampler->races[i])) {
+			value += sampler->weight[i];
+		}
+	}
+	if (value <= 0) return NULL;
+	value = randint0(value);
+	for (i = 0; i < sampler->num; i++) {
+		if (get_mon_used_up(sampler->races[i])) continue;
+		if (value < sampler->weight[i]) break;
+		value -= sampler->weight[i];
+	}
+	return sampler->races[i];
 }
 
 /**
@@ -318,9 +527,10 @@ static struct monster_race *get_mon_race_aux(long total,
  * for checks on an out-of-depth monster.
  *
  * This function uses the "prob2" field of the monster allocation table,
- * and various local information, to calculate the "prob3" field of the
- * same table, which is then used to choose an appropriate monster, in
- * a relatively efficient manner.
+ * and various local information, to work out the chance of each monster,
+ * as the "prob3" field of the table would have it; the results are cached
+ * (see mon_sampler_get()), so an appropriate monster is chosen in constant
+ * time.
  *
  * Note that town monsters will *only* be created in the town, and
  * "normal" monsters will *never* be created in the town, unless the
@@ -338,50 +548,19 @@ static struct monster_race *get_mon_race_aux(long total,
  */
 struct monster_race *get_mon_num(int generated_level, int current_level)
 {
-	int i, p;
-	long total;
+	int p;
 	struct monster_race *race;
-	alloc_entry *table = alloc_race_table;
+	struct mon_sampler *sampler;
 
 	/* Occasionally produce a nastier monster in the dungeon */
 	if (generated_level > 0 && one_in_(z_info->ood_monster_chance))
 		generated_level += MIN(generated_level / 4 + 2,
 			z_info->ood_monster_amount);
 
-	total = 0L;
-
-	/* Process probabilities */
-	for (i = 0; i < alloc_race_size; i++) {
-		/* Monsters are sorted by depth */
-		if (table[i].level > generated_level) break;
-
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* No town monsters in dungeon */
-		if (generated_level > 0 && table[i].level <= 0) continue;
-
-		/* Get the chosen monster */
-		race = &r_info[table[i].index];
-
-		/* Some monsters will not be allowed on the current level */
-		if (get_mon_forbidden(race)) continue;
-
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
-
-		/* Adjust for locality and topography */
-		table[i].prob3 = get_mon_adjust(table[i].prob3, race);
-
-		/* Total */
-		total += table[i].prob3;
-	}
-
-	/* No legal monsters */
-	if (total <= 0) return NULL;
-
-	/* Pick a monster */
-	race = get_mon_race_aux(total, table);
+	/* Pick a monster, if there are any legal ones */
+	sampler = mon_sampler_get(generated_level);
+	race = get_mon_race_aux(sampler);
+	if (!race) return NULL;
 
 	/* Try for a "harder" monster once (50%) or twice (10%) */
 	p = randint0(100);
@@ -390,7 +569,7 @@ struct monster_race *get_mon_num(int generated_level, int current_level)
 		struct monster_race *old = race;
 
 		/* Pick a new monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(sampler);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -401,7 +580,7 @@ struct monster_race *get_mon_num(int generated_level, int current_level)
 		struct monster_race *old = race;
 
 		/* Pick a monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(sampler);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -943,13 +1122,12 @@ void delete_monster_idx(struct chunk *c, int m_idx)
 	monster_remove_from_groups(c, mon);
 	monster_remove_from_targets(c, mon);
 
-	/* Free any heatmaps */
-	if (mon->noise.grids) {
-		heatmap_free(c, mon->noise);
-	}
-	if (mon->scent.grids) {
-		heatmap_free(c, mon->scent);
-	}
+	/* Free any noise and scent */
+	flow_field_free(c, mon->flow);
+	mon->flow = NULL;
+
+	/* No more turns */
+	monster_schedule_remove(c, mon);
 
 	/* Delete objects */
 	struct object *obj = mon->held_obj;
@@ -1024,8 +1202,8 @@ void delete_monster(struct chunk *c, struct loc grid)
 	assert(square_in_bounds(c, grid));
 
 	/* Delete the monster (if any) */
-	if (square(c, grid)->mon > 0)
-		delete_monster_idx(c, square(c, grid)->mon);
+	if (square_midx(c, grid) > 0)
+		delete_monster_idx(c, square_midx(c, grid));
 }
 
 
@@ -1046,6 +1224,10 @@ void monster_index_move(struct chunk *c, int i1, int i2)
 	mon = cave_monster(c, i1);
 	if (!mon) return;
 
+	/* Take it off the schedule under its old index */
+	monster_schedule_wake(c, mon);
+	monster_schedule_remove(c, mon);
+
 	/* Update the cave */
 	square_set_mon(c, mon->grid, i2);
 
@@ -1081,6 +1263,9 @@ void monster_index_move(struct chunk *c, int i1, int i2)
 
 	/* Wipe hole */
 	memset(cave_monster(c, i1), 0, sizeof(struct monster));
+
+	/* Put it back on the schedule */
+	monster_schedule_add(c, cave_monster(c, i2));
 }
 
 
@@ -1219,6 +1404,10 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 		if (mon->original_race) mon->original_race->cur_num--;
 		else mon->race->cur_num--;
 
+		/* Free any noise and scent */
+		flow_field_free(c, mon->flow);
+		mon->flow = NULL;
+
 		/* Monster is gone from square */
 		square_set_mon(c, mon->grid, 0);
 
@@ -1245,6 +1434,10 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 		memset(mon, 0, sizeof(struct monster));
 	}
 
+	/* Forget the monster schedule */
+	monster_schedule_free(c->mon_sched);
+	c->mon_sched = NULL;
+
 	/* Delete the player ghost record completely */
 	mem_free(r_info[PLAYER_GHOST_RACE].blow);
 	memset(&r_info[PLAYER_GHOST_RACE], 0, sizeof(struct monster_race));
@@ -1755,6 +1948,9 @@ int16_t place_monster(struct chunk *c, struct loc grid, struct monster *mon,
 	/* Assign monster to its monster group, or update its entry */
 	monster_group_assign(c, new_mon, info, loading);
 
+	/* Give it turns */
+	monster_schedule_add(c, new_mon);
+
 	update_mon(new_mon, c, true);
 
 	/* Count the number of "reproducers" */
@@ -113,7 +113,10 @@ static bool monster_can_hear(struct monster *mon)
 		noise_map = cave->noise;
 		hearing -= player->state.skills[SKILL_STEALTH] / 3;
 	} else if (mon->target.midx > 0) {
-		noise_map = cave_monster(cave, mon->target.midx)->noise;
+		struct flow_field *flow = cave_monster(cave, mon->target.midx)->flow;
+
+		if (!flow) return false;
+		noise_map = flow->noise;
 	} else {
 		return false;
 	}
@@ -136,7 +139,10 @@ static bool monster_can_smell(struct monster *mon)
 	if (mon->target.midx == -1) {
 		scent_map = cave->scent;
 	} else if (mon->target.midx > 0) {
-		scent_map = cave_monster(cave, mon->target.midx)->scent;
+		struct flow_field *flow = cave_monster(cave, mon->target.midx)->flow;
+
+		if (!flow) return false;
+		scent_map = flow->scent;
 	} else {
 		return false;
 	}
@@ -461,7 +467,12 @@ static bool get_move_advance(struct monster *mon, bool *track)
 		hearing -= player->state.skills[SKILL_STEALTH] / 3;
 	} else if (mon->target.midx > 0) {
 		/* Monster */
-		noise_map = cave_monster(cave, mon->target.midx)->noise;
+		struct flow_field *flow = cave_monster(cave, mon->target.midx)->flow;
+
+		if (flow) {
+			noise_map = flow->noise;
+			scent_map = flow->scent;
+		}
 	} else {
 		/* Location */
 		best_grid = target;
@@ -1094,7 +1105,7 @@ static bool monster_turn_multiply(struct monster *mon)
 	/* Count the adjacent monsters */
 	for (y = mon->grid.y - 1; y <= mon->grid.y + 1; y++)
 		for (x = mon->grid.x - 1; x <= mon->grid.x + 1; x++)
-			if (square(cave, loc(x, y))->mon > 0) k++;
+			if (square_midx(cave, loc(x, y)) > 0) k++;
 
 	/* Multiply slower in crowded areas */
 	if ((k < 4) && (k == 0 || one_in_(k * z_info->repro_monster_rate))) {
@@ -2076,6 +2087,321 @@ static void regen_monster(struct monster *mon, int num)
 }
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Monster turn scheduling
+ * ------------------------------------------------------------------------ */
+/**
+ * Monsters which are doing nothing but gathering energy are parked in a
+ * queue ordered by the turn on which they will next have enough energy to
+ * move, and only the rest (the "hot" monsters) are visited each game turn.
+ *
+ * A parked monster's energy is as it was at the start of turn `since`; it is
+ * brought up to date when the monster is woken, either because its turn to
+ * move has come round or because something has happened to it.  Since a
+ * monster is only parked when it is passive and unhurt, and anything which
+ * changes its speed, health or energy wakes it first, the energy it gains
+ * while parked is a whole number of turns' worth at a fixed rate.
+ *
+ * Turns here are counted by reset_monsters(), so are only relative; monster
+ * processing for turn `now` is under way or yet to happen.
+ */
+struct monster_parked {
+	int32_t wake;
+	int32_t since;
+	int midx;
+};
+
+struct monster_schedule {
+	uint32_t *hot;
+	struct monster_parked *queue;
+	int queued;
+	int32_t now;
+	int cursor;
+};
+
+/**
+ * Energy a monster gains each game turn at its current speed
+ */
+static int monster_turn_energy(const struct monster *mon)
+{
+	int mspeed = mon->mspeed;
+
+	if (mon->m_timed[MON_TMD_FAST])
+		mspeed += 10;
+	if (mon->m_timed[MON_TMD_SLOW]) {
+		int slow_level = monster_effect_level(mon, MON_TMD_SLOW);
+		mspeed -= (2 * slow_level);
+	}
+	return turn_energy(mspeed);
+}
+
+static void schedule_hot_on(struct monster_schedule *s, int midx)
+{
+	s->hot[midx / 32] |= 1U << (midx % 32);
+}
+
+static void schedule_hot_off(struct monster_schedule *s, int midx)
+{
+	s->hot[midx / 32] &= ~(1U << (midx % 32));
+}
+
+/**
+ * Find the highest numbered hot monster with index no more than `midx`,
+ * or 0 if there are none.
+ */
+static int schedule_next_hot(const struct monster_schedule *s, int midx)
+{
+	while (midx > 0) {
+		int base = midx - (midx % 32);
+		uint32_t bits = s->hot[midx / 32]
+			& (0xFFFFFFFFU >> (31 - (midx % 32)));
+
+		if (bits) {
+			int b = 31;
+
+			while (!(bits & (1U << b))) b--;
+			return base + b;
+		}
+		midx = base - 1;
+	}
+	return 0;
+}
+
+/**
+ * Order parked monsters by waking turn, then index
+ */
+static bool schedule_before(const struct monster_parked *a,
+		const struct monster_parked *b)
+{
+	if (a->wake != b->wake) return a->wake < b->wake;
+	return a->midx < b->midx;
+}
+
+/**
+ * Put a queue entry into slot `pos`, keeping its monster's note of the slot
+ */
+static void schedule_put(struct chunk *c, struct monster_schedule *s,
+		int pos, struct monster_parked entry)
+{
+	s->queue[pos] = entry;
+	cave_monster(c, entry.midx)->sched_pos = pos;
+}
+
+/**
+ * Move the entry in slot `pos` up or down the queue to its proper place
+ */
+static void schedule_sift(struct chunk *c, struct monster_schedule *s,
+		int pos)
+{
+	struct monster_parked entry = s->queue[pos];
+
+	while (pos > 1 && schedule_before(&entry, &s->queue[pos / 2])) {
+		schedule_put(c, s, pos, s->queue[pos / 2]);
+		pos /= 2;
+	}
+	while (2 * pos <= s->queued) {
+		int child = 2 * pos;
+
+		if (child < s->queued
+				&& schedule_before(&s->queue[child + 1], &s->queue[child]))
+			child++;
+		if (!schedule_before(&s->queue[child], &entry)) break;
+		schedule_put(c, s, pos, s->queue[child]);
+		pos = child;
+	}
+	schedule_put(c, s, pos, entry);
+}
+
+/**
+ * Take a monster out of the parked queue, returning its entry
+ */
+static struct monster_parked schedule_unpark(struct chunk *c,
+		struct monster_schedule *s, struct monster *mon)
+{
+	int pos = mon->sched_pos;
+	struct monster_parked entry = s->queue[pos];
+
+	mon->sched_pos = 0;
+	if (pos < s->queued) {
+		s->queue[pos] = s->queue[s->queued];
+		s->queued--;
+		schedule_sift(c, s, pos);
+	} else {
+		s->queued--;
+	}
+	return entry;
+}
+
+/**
+ * Whether a monster is parked in the given chunk's queue
+ */
+static bool schedule_is_parked(struct chunk *c, const struct monster *mon)
+{
+	const struct monster_schedule *s = c->mon_sched;
+
+	return s && mon->sched_pos > 0 && mon->sched_pos <= s->queued
+		&& s->queue[mon->sched_pos].midx == mon->midx
+		&& cave_monster(c, mon->midx) == mon;
+}
+
+/**
+ * Park a monster which has just had its move, until its next move is due
+ */
+static void schedule_park(struct chunk *c, struct monster_schedule *s,
+		struct monster *mon)
+{
+	int energy = monster_turn_energy(mon);
+	struct monster_parked entry;
+
+	/* Only passive, unhurt monsters which will move again are parked */
+	if (energy <= 0 || mon->hp < mon->maxhp) return;
+
+	entry.midx = mon->midx;
+	entry.since = s->now + 1;
+	entry.wake = entry.since;
+	if (mon->energy < z_info->move_energy) {
+		entry.wake += (z_info->move_energy - mon->energy + energy - 1)
+			/ energy;
+	}
+
+	schedule_hot_off(s, mon->midx);
+	s->queued++;
+	s->queue[s->queued] = entry;
+	schedule_sift(c, s, s->queued);
+}
+
+/**
+ * Get the monster schedule for a chunk, making one with every monster hot
+ * if there is none
+ */
+static struct monster_schedule *schedule_get(struct chunk *c)
+{
+	struct monster_schedule *s = c->mon_sched;
+	int i;
+
+	if (s) return s;
+	s = mem_zalloc(sizeof(*s));
+	s->hot = mem_zalloc(((z_info->level_monster_max + 31) / 32)
+		* sizeof(uint32_t));
+	s->queue = mem_zalloc((z_info->level_monster_max + 1)
+		* sizeof(struct monster_parked));
+	s->cursor = z_info->level_monster_max;
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+
+		mon->sched_pos = 0;
+		if (mon->race) schedule_hot_on(s, i);
+	}
+	c->mon_sched = s;
+	return s;
+}
+
+/**
+ * Add a newly placed monster to its chunk's hot list
+ */
+void monster_schedule_add(struct chunk *c, struct monster *mon)
+{
+	mon->sched_pos = 0;
+	if (c->mon_sched) schedule_hot_on(c->mon_sched, mon->midx);
+}
+
+/**
+ * Remove a monster from its chunk's schedule altogether
+ */
+void monster_schedule_remove(struct chunk *c, struct monster *mon)
+{
+	if (!c->mon_sched) return;
+	if (schedule_is_parked(c, mon)) {
+		(void) schedule_unpark(c, c->mon_sched, mon);
+	}
+	schedule_hot_off(c->mon_sched, mon->midx);
+}
+
+/**
+ * Return a parked monster to the hot list, bringing its energy up to date.
+ *
+ * This must be called before anything changes a monster's speed, health or
+ * energy; it does nothing to monsters which are not parked.
+ */
+void monster_schedule_wake(struct chunk *c, struct monster *mon)
+{
+	struct monster_schedule *s = c->mon_sched;
+	struct monster_parked entry;
+	int32_t until = s ? s->now : 0;
+
+	if (!schedule_is_parked(c, mon)) return;
+	entry = schedule_unpark(c, s, mon);
+
+	if (entry.since > s->now) {
+		/* Parked this turn, so already handled */
+		until = entry.since;
+	} else if (mon->midx > s->cursor) {
+		/* Passed over by the current sweep, so give it this turn too */
+		until = s->now + 1;
+	} else {
+		/* Still to have this turn */
+		mflag_off(mon->mflag, MFLAG_HANDLED);
+	}
+	mon->energy += (until - entry.since) * monster_turn_energy(mon);
+	schedule_hot_on(s, mon->midx);
+}
+
+/**
+ * Wake every parked monster and discard the schedule, so the chunk's
+ * monsters can be copied or saved
+ */
+void monster_schedule_flush(struct chunk *c)
+{
+	struct monster_schedule *s = c->mon_sched;
+
+	if (!s) return;
+	while (s->queued) {
+		monster_schedule_wake(c, cave_monster(c, s->queue[1].midx));
+	}
+	monster_schedule_free(s);
+	c->mon_sched = NULL;
+}
+
+/**
+ * Count the game turns, starting with the coming one, for which
+ * process_monsters() and reset_monsters() would only move the clock on:  no
+ * monster may be hot, and none parked may be due to wake.  Returns INT32_MAX
+ * if no monster will ever need processing.
+ */
+int32_t monster_schedule_quiet_turns(struct chunk *c)
+{
+	struct monster_schedule *s = schedule_get(c);
+
+	if (schedule_next_hot(s, cave_monster_max(c) - 1)) return 0;
+	if (!s->queued) return INT32_MAX;
+	return MAX(s->queue[1].wake - s->now, 0);
+}
+
+/**
+ * Move the schedule on by a number of quiet turns, as that many calls to
+ * reset_monsters() would
+ */
+void monster_schedule_skip(struct chunk *c, int32_t turns)
+{
+	struct monster_schedule *s = schedule_get(c);
+
+	assert(turns <= monster_schedule_quiet_turns(c));
+	s->now += turns;
+}
+
+/**
+ * Free a monster schedule
+ */
+void monster_schedule_free(struct monster_schedule *s)
+{
+	if (!s) return;
+	mem_free(s->hot);
+	mem_free(s->queue);
+	mem_free(s);
+}
+
+
 /**
  * ------------------------------------------------------------------------
  * Monster processing routines to be called by the main game loop
@@ -2083,9 +2409,11 @@ static void regen_monster(struct monster *mon, int num)
 /**
  * Process all the "live" monsters, once per game turn.
  *
- * During each game turn, we scan through the list of all the "live" monsters,
+ * During each game turn, we scan through the list of all the "hot" monsters,
  * (backwards, so we can excise any "freshly dead" monsters), energizing each
  * monster, and allowing fully energized monsters to move, attack, pass, etc.
+ * Monsters parked by an earlier turn are first returned to the hot list if
+ * they have enough energy to move this turn.
  *
  * This function and its children are responsible for a considerable fraction
  * of the processor time in normal situations, greater if the character is
@@ -2093,8 +2421,8 @@ static void regen_monster(struct monster *mon, int num)
  */
 void process_monsters(int minimum_energy)
 {
+	struct monster_schedule *sched = schedule_get(cave);
 	int i;
-	int mspeed;
 
 	/* Only process some things every so often */
 	bool regen = false;
@@ -2103,14 +2431,25 @@ void process_monsters(int minimum_energy)
 	if (turn % 100 == 0)
 		regen = true;
 
+	/* Wake the parked monsters whose move is due */
+	while (sched->queued && (sched->queue[1].wake <= sched->now)) {
+		monster_schedule_wake(cave, cave_monster(cave,
+			sched->queue[1].midx));
+	}
+
 	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
+	for (i = schedule_next_hot(sched, cave_monster_max(cave) - 1); i >= 1;
+			i = schedule_next_hot(sched, i - 1)) {
 		struct monster *mon;
 		bool moving;
 
 		/* Handle "leaving" */
 		if (player->is_dead || player->upkeep->generate_level) break;
 
+		/* Note how far a sweep of every monster has got */
+		if (!minimum_energy)
+			sched->cursor = i;
+
 		/* Get a 'live' monster */
 		mon = cave_monster(cave, i);
 		if (!mon->race) continue;
@@ -2132,17 +2471,8 @@ void process_monsters(int minimum_energy)
 		if (regen)
 			regen_monster(mon, 1);
 
-		/* Calculate the net speed */
-		mspeed = mon->mspeed;
-		if (mon->m_timed[MON_TMD_FAST])
-			mspeed += 10;
-		if (mon->m_timed[MON_TMD_SLOW]) {
-			int slow_level = monster_effect_level(mon, MON_TMD_SLOW);
-			mspeed -= (2 * slow_level);
-		}
-
 		/* Give this monster some energy */
-		mon->energy += turn_energy(mspeed);
+		mon->energy += monster_turn_energy(mon);
 
 		/* End the turn of monsters without enough energy to move */
 		if (!moving)
@@ -2152,7 +2482,10 @@ void process_monsters(int minimum_energy)
 		mon->energy -= z_info->move_energy;
 
 		/* Mimics lie in wait */
-		if (monster_is_mimicking(mon)) continue;
+		if (monster_is_mimicking(mon)) {
+			schedule_park(cave, sched, mon);
+			continue;
+		}
 
 		/* Check if the monster is active */
 		if (monster_check_active(mon)) {
@@ -2181,8 +2514,12 @@ void process_monsters(int minimum_energy)
 
 			/* Monster is no longer current */
 			cave->mon_current = -1;
+		} else {
+			/* Nothing to do until its next move */
+			schedule_park(cave, sched, mon);
 		}
 	}
+	sched->cursor = z_info->level_monster_max;
 
 	/* Update monster visibility after this */
 	/* XXX This may not be necessary */
@@ -2192,21 +2529,22 @@ void process_monsters(int minimum_energy)
 /**
  * Clear 'moved' status from all monsters.
  *
- * Clear noise if appropriate.
+ * Parked monsters keep theirs until they are woken.
  */
 void reset_monsters(void)
 {
+	struct monster_schedule *sched = schedule_get(cave);
 	int i;
-	struct monster *mon;
 
 	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
-		/* Access the monster */
-		mon = cave_monster(cave, i);
-
+	for (i = schedule_next_hot(sched, cave_monster_max(cave) - 1); i >= 1;
+			i = schedule_next_hot(sched, i - 1)) {
 		/* Monster is ready to go again */
-		mflag_off(mon->mflag, MFLAG_HANDLED);
+		mflag_off(cave_monster(cave, i)->mflag, MFLAG_HANDLED);
 	}
+
+	/* On to the next turn */
+	sched->now++;
 }
 
 /**
@@ -25,6 +25,13 @@ enum monster_stagger {
 	 INNATE_STAGGER = 2
 };
 
+void monster_schedule_add(struct chunk *c, struct monster *mon);
+void monster_schedule_remove(struct chunk *c, struct monster *mon);
+void monster_schedule_wake(struct chunk *c, struct monster *mon);
+void monster_schedule_flush(struct chunk *c);
+int32_t monster_schedule_quiet_turns(struct chunk *c);
+void monster_schedule_skip(struct chunk *c, int32_t turns);
+void monster_schedule_free(struct monster_schedule *s);
 bool multiply_monster(const struct monster *mon);
 void process_monsters(int minimum_energy);
 void reset_monsters(void);
@@ -23,6 +23,7 @@
 #include "init.h"
 #include "mon-group.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-summon.h"
 #include "mon-util.h"
 #include "parser.h"
@@ -377,6 +378,7 @@ static int call_monster(struct loc grid)
 	monster_wake(mon, false, 100);
 
 	/* Set it's energy to 0 */
+	monster_schedule_wake(cave, mon);
 	mon->energy = 0;
 
 	return (mon->race->level);
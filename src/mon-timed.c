@@ -19,6 +19,7 @@
 #include "angband.h"
 #include "mon-desc.h"
 #include "mon-lore.h"
+#include "mon-move.h"
 #include "mon-msg.h"
 #include "mon-predicate.h"
 #include "mon-spell.h"
@@ -155,6 +156,9 @@ static bool mon_set_timed(struct monster *mon,
 		timer = effect->max_timer;
 	}
 
+	/* Bring a parked monster up to date before its speed can change */
+	monster_schedule_wake(cave, mon);
+
 	/* No change */
 	if (old_timer == timer) {
 		return false;
@@ -25,6 +25,7 @@
 #include "mon-list.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-msg.h"
 #include "mon-predicate.h"
 #include "mon-spell.h"
@@ -111,37 +112,134 @@ void create_mon_flag_mask(bitflag *f, ...)
  * ------------------------------------------------------------------------
  * Lookup utilities
  * ------------------------------------------------------------------------ */
+/**
+ * Hash tables behind lookup_monster(): race_by_name gives the first race with
+ * a name, race_by_near the last with a name equal ignoring case.  Slots hold
+ * an index into r_info plus one, or zero when empty.  The ghost race at the
+ * end of r_info is left out, since it changes as ghosts come and go, and is
+ * checked directly.  The tables are made on first use and dropped by
+ * mon_lookup_cleanup() along with r_info.
+ */
+static const struct monster_race *race_index_info;
+static int race_index_max;
+static uint32_t race_index_size;
+static int *race_by_name;
+static int *race_by_near;
+
+/**
+ * Free the race lookup tables
+ */
+void mon_lookup_cleanup(void)
+{
+	mem_free(race_by_name);
+	mem_free(race_by_near);
+	race_by_name = NULL;
+	race_by_near = NULL;
+	race_index_info = NULL;
+	race_index_max = 0;
+	race_index_size = 0;
+}
+
+/**
+ * Make sure the race lookup tables cover r_info as it is now; false if
+ * there is nothing to look in yet
+ */
+static bool race_index_ready(void)
+{
+	uint32_t mask;
+	int r;
+
+	if (!r_info || z_info->r_max <= 1) return false;
+	if (race_index_info == r_info && race_index_max == z_info->r_max) {
+		return true;
+	}
+
+	mon_lookup_cleanup();
+	race_index_info = r_info;
+	race_index_max = z_info->r_max;
+	race_index_size = 16;
+	while (race_index_size < 2 * (uint32_t) race_index_max) {
+		race_index_size *= 2;
+	}
+	mask = race_index_size - 1;
+	race_by_name = mem_zalloc(race_index_size * sizeof(*race_by_name));
+	race_by_near = mem_zalloc(race_index_size * sizeof(*race_by_near));
+
+	for (r = 0; r < race_index_max - 1; r++) {
+		const char *name = r_info[r].name;
+		uint32_t i;
+
+		if (!name) continue;
+
+		/* Keep the first exact match */
+		i = djb2_hash(name) & mask;
+		while (race_by_name[i]
+				&& !streq(r_info[race_by_name[i] - 1].name, name)) {
+			i = (i + 1) & mask;
+		}
+		if (!race_by_name[i]) race_by_name[i] = r + 1;
+
+		/* Keep the last near match */
+		i = djb2_hash_nocase(name) & mask;
+		while (race_by_near[i]
+				&& my_stricmp(r_info[race_by_near[i] - 1].name, name)) {
+			i = (i + 1) & mask;
+		}
+		race_by_near[i] = r + 1;
+	}
+
+	return true;
+}
+
 /**
  * Returns the monster with the given name. If no monster has the exact name
- * given, returns the first monster with the given name as a (case-insensitive)
+ * given, returns the last monster with the name ignoring case, or failing
+ * that the first monster with the given name as a (case-insensitive)
  * substring.
  */
 struct monster_race *lookup_monster(const char *name)
 {
-	int i;
-	struct monster_race *closest = NULL;
+	struct monster_race *ghost;
+	uint32_t mask, i;
+	int r;
 
-	/* Look for it */
-	for (i = 0; i < z_info->r_max; i++) {
-		struct monster_race *race = &r_info[i];
-		if (!race->name)
-			continue;
+	if (!race_index_ready()) return NULL;
+	ghost = &r_info[z_info->r_max - 1];
+	mask = race_index_size - 1;
+
+	/* Test for equality */
+	i = djb2_hash(name) & mask;
+	while (race_by_name[i]) {
+		struct monster_race *race = &r_info[race_by_name[i] - 1];
 
-		/* Test for equality */
 		if (streq(name, race->name))
 			return race;
+		i = (i + 1) & mask;
+	}
+	if (ghost->name && streq(name, ghost->name))
+		return ghost;
+
+	/* Test for near equality */
+	if (ghost->name && my_stricmp(name, ghost->name) == 0)
+		return ghost;
+	i = djb2_hash_nocase(name) & mask;
+	while (race_by_near[i]) {
+		struct monster_race *race = &r_info[race_by_near[i] - 1];
 
-		/* Test for near equality */
 		if (my_stricmp(name, race->name) == 0)
-			closest = race;
+			return race;
+		i = (i + 1) & mask;
+	}
+
+	/* Test for close matches */
+	for (r = 0; r < z_info->r_max; r++) {
+		struct monster_race *race = &r_info[r];
 
-		/* Test for close matches */
-		if (!closest && my_stristr(race->name, name))
-			closest = race;
+		if (race->name && my_stristr(race->name, name))
+			return race;
 	}
 
-	/* Return our best match */
-	return closest;
+	return NULL;
 }
 
 /**
@@ -240,7 +338,7 @@ static void path_analyse(struct chunk *c, struct loc grid)
 	for (i = 0; i < path_n - 1; ++i) {
 		/* Forget grids which would block los */
 		if (!square_allowslos(player->cave, path_g[i])) {
-			sqinfo_off(square(c, path_g[i])->info, SQUARE_SEEN);
+			sqinfo_off(square_info(c, path_g[i]), SQUARE_SEEN);
 			square_forget(c, path_g[i]);
 			square_light_spot(c, path_g[i]);
 		}
@@ -355,10 +453,8 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 		mon->cdis = d;
 
 		/* Heatmaps */
-		if (mon->noise.grids) {
+		if (mon->flow) {
 			make_noise(c, NULL, mon);
-		}
-		if (mon->scent.grids) {
 			update_scent(c, NULL, mon);
 		}
 	}
@@ -609,8 +705,8 @@ void monster_swap(struct loc grid1, struct loc grid2)
 	struct loc pgrid = player->grid;
 
 	/* Monsters */
-	m1 = cave->squares[grid1.y][grid1.x].mon;
-	m2 = cave->squares[grid2.y][grid2.x].mon;
+	m1 = square_midx(cave, grid1);
+	m2 = square_midx(cave, grid2);
 
 	/* Update grids */
 	square_set_mon(cave, grid1, m2);
@@ -725,6 +821,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 void monster_wake(struct monster *mon, bool notify, int aware_chance)
 {
 	int flag = notify ? MON_TMD_FLG_NOTIFY : MON_TMD_FLG_NOMESSAGE;
+	monster_schedule_wake(cave, mon);
 	mon_clear_timed(mon, MON_TMD_SLEEP, flag);
 	if (randint0(100) < aware_chance) {
 		mflag_on(mon->mflag, MFLAG_AWARE);
@@ -1746,6 +1843,7 @@ bool monster_change_shape(struct monster *mon)
 			assert(!mon->original_player_race);
 			mon->original_player_race = mon->player_race;
 		}
+		monster_schedule_wake(cave, mon);
 		mon->race = race;
 		if (rf_has(race->flags, RF_PLAYER)) {
 			mon->player_race = get_player_race();
@@ -1781,6 +1879,7 @@ bool monster_revert_shape(struct monster *mon)
 			player->upkeep->redraw |= (PR_MONLIST);
 			square_light_spot(cave, mon->grid);
 		}
+		monster_schedule_wake(cave, mon);
 		mon->mspeed += mon->original_race->speed - mon->race->speed;
 		mon->race = mon->original_race;
 		mon->original_race = NULL;
@@ -1828,15 +1927,13 @@ struct loc monster_target_loc(const struct monster *mon)
  * Create noise and scent heatmaps for a monster
  *
  * This function should be called when a monster becomes the long-term target
- * of another monster, to allow movement to work properly
+ * of another monster, to allow movement to work properly.  All the monsters
+ * tracking it share the one set of heatmaps.
  */
 void monster_make_heatmaps(struct chunk *c, struct monster *mon)
 {
-	if (!mon->noise.grids) {
-		mon->noise.grids = heatmap_new(c);
-	}
-	if (!mon->scent.grids) {
-		mon->scent.grids = heatmap_new(c);
+	if (!mon->flow) {
+		mon->flow = flow_field_new(c);
 	}
 }
 
@@ -24,6 +24,7 @@
 
 const char *describe_race_flag(int flag);
 void create_mon_flag_mask(bitflag *f, ...);
+void mon_lookup_cleanup(void);
 struct monster_race *lookup_monster(const char *name);
 struct monster_base *lookup_monster_base(const char *name);
 struct blow_effect *lookup_monster_blow_effect(const char *eff_name);
@@ -454,8 +454,8 @@ struct monster {
 	struct loc home;					/* Home for territorial monsters */
 
 	struct monster_group_info group_info[GROUP_MAX];/* Monster group details */
-	struct heatmap noise;				/* Monster noise heatmap */
-	struct heatmap scent;				/* Monster scent heatmap */
+	struct flow_field *flow;			/* Noise and scent, if tracked */
+	int sched_pos;				/* Slot in the parked queue, or 0 */
 
 	uint8_t min_range;			/* What is the closest we want to be? */
 	uint8_t best_range;			/* How close do we want to be? */
@@ -468,6 +468,7 @@ extern struct monster_spell *monster_spells;
 extern struct ghost *ghosts;
 extern struct monster_base *rb_info;
 extern struct monster_race *r_info;
+extern int r_light_max;
 extern const struct monster_race *ref_race;
 
 #endif /* !MONSTER_MONSTER_H */
@@ -2283,6 +2283,7 @@ static void cleanup_object(void)
 		}
 	}
 	mem_free(k_info);
+	obj_lookup_cleanup();
 }
 
 struct file_parser object_parser = {
@@ -2732,6 +2733,7 @@ static void cleanup_ego(void)
 		}
 	}
 	mem_free(e_info);
+	obj_lookup_cleanup();
 }
 
 struct file_parser ego_parser = {
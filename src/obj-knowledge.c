@@ -953,7 +953,7 @@ void object_sense(struct player *p, struct object *obj)
 
 		/* Attach it to the current floor pile */
 		new_obj->grid = grid;
-		pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, new_obj);
+		pile_insert_end(&p->cave->sq_obj[square_index(p->cave, grid)], new_obj);
 	}
 }
 
@@ -984,7 +984,7 @@ void object_see(struct player *p, struct object *obj)
 
 		/* Attach it to the current floor pile */
 		new_obj->grid = grid;
-		pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, new_obj);
+		pile_insert_end(&p->cave->sq_obj[square_index(p->cave, grid)], new_obj);
 	} else {
 		struct loc old = known_obj->grid;
 
@@ -1009,7 +1009,7 @@ void object_see(struct player *p, struct object *obj)
 			}
 
 			known_obj->grid = grid;
-			pile_insert_end(&p->cave->squares[grid.y][grid.x].obj, known_obj);
+			pile_insert_end(&p->cave->sq_obj[square_index(p->cave, grid)], known_obj);
 		}
 	}
 }
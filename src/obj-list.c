@@ -155,7 +155,7 @@ static bool object_list_should_ignore_object(const struct player *p,
  */
 void object_list_collect(object_list_t *list)
 {
-	int i;
+	int i, entry_index = 0;
 	struct loc pgrid = player->grid;
 
 	if (list == NULL || list->entries == NULL)
@@ -167,7 +167,6 @@ void object_list_collect(object_list_t *list)
 	/* Scan each object in the dungeon. */
 	for (i = 1; i < player->cave->obj_max; i++) {
 		object_list_entry_t *entry = NULL;
-		int entry_index;
 		int current_distance;
 		int entry_distance;
 		struct loc grid;
@@ -190,22 +189,23 @@ void object_list_collect(object_list_t *list)
 
 		if (object_list_should_ignore_object(player, obj)) continue;
 
-		/* Find or add a list entry. */
-		for (entry_index = 0; entry_index < (int)list->entries_size;
-			 entry_index++) {
+		/*
+		 * Add a list entry in the first empty slot; slots are only ever
+		 * filled here, so carry on looking from the last one used.
+		 */
+		while (entry_index < (int)list->entries_size
+				&& list->entries[entry_index].object) {
+			entry_index++;
+		}
+		if (entry_index < (int)list->entries_size) {
 			int j;
-			struct object *list_obj = list->entries[entry_index].object;
-
-			if (list_obj == NULL) {
-				/* We found an empty slot, so add this object here. */
-				list->entries[entry_index].object = obj;
-				for (j = 0; j < OBJECT_LIST_SECTION_MAX; j++)
-					list->entries[entry_index].count[j] = 0;
-				list->entries[entry_index].dy = grid.y - pgrid.y;
-				list->entries[entry_index].dx = grid.x - pgrid.x;
-				entry = &list->entries[entry_index];
-				break;
-			}
+
+			entry = &list->entries[entry_index];
+			entry->object = obj;
+			for (j = 0; j < OBJECT_LIST_SECTION_MAX; j++)
+				entry->count[j] = 0;
+			entry->dy = grid.y - pgrid.y;
+			entry->dx = grid.x - pgrid.x;
 		}
 
 		if (entry == NULL)
@@ -48,16 +48,27 @@ static uint32_t *obj_alloc;
 static uint32_t *obj_alloc_great;
 
 /**
- * Store the total allocation value for each tval by level.  The value at
- * ilv * TV_MAX + tval is the total for tval at the level, ilv.
+ * Object kinds grouped by tval, in k_info order within each tval; those with
+ * tval, tv, are obj_tval_kinds[obj_tval_start[tv]] up to but not including
+ * obj_tval_kinds[obj_tval_start[tv + 1]].
  */
-static uint32_t *obj_total_tval;
+static int obj_tval_start[TV_MAX + 1];
+static int *obj_tval_kinds;
 
 /**
- * Same layout and interpretation as obj_total_tval, but only items that are
+ * Cumulative probability distribution for each tval's kinds at each level,
+ * laid out like obj_alloc but with a run of obj_tval_start[tv + 1] -
+ * obj_tval_start[tv] + 1 entries for each tval in turn.  The run for tval, tv,
+ * at level, ilv, starts at ilv * (z_info->k_max + TV_MAX) + obj_tval_start[tv]
+ * + tv and its last entry is the total for the tval at that level.
+ */
+static uint32_t *obj_alloc_tval;
+
+/**
+ * Same layout and interpretation as obj_alloc_tval, but only items that are
  * good or better contribute.
  */
-static uint32_t *obj_total_tval_great;
+static uint32_t *obj_alloc_tval_great;
 
 static int16_t alloc_ego_size = 0;
 static alloc_entry *alloc_ego_table;
@@ -74,14 +85,34 @@ static int num_money_types;
  * Initialize object allocation info
  */
 static void alloc_init_objects(void) {
-	int item, lev;
+	int item, lev, tval;
 	int k_max = z_info->k_max;
+	int run = k_max + TV_MAX;
 
 	/* Allocate */
 	obj_alloc = mem_alloc_alt((z_info->max_obj_depth + 1) * (k_max + 1) * sizeof(*obj_alloc));
 	obj_alloc_great = mem_alloc_alt((z_info->max_obj_depth + 1) * (k_max + 1) * sizeof(*obj_alloc_great));
-	obj_total_tval = mem_zalloc_alt((z_info->max_obj_depth + 1) * TV_MAX * sizeof(*obj_total_tval));
-	obj_total_tval_great = mem_zalloc_alt((z_info->max_obj_depth + 1) * TV_MAX * sizeof(*obj_total_tval));
+	obj_alloc_tval = mem_alloc_alt((z_info->max_obj_depth + 1) * run * sizeof(*obj_alloc_tval));
+	obj_alloc_tval_great = mem_alloc_alt((z_info->max_obj_depth + 1) * run * sizeof(*obj_alloc_tval_great));
+	obj_tval_kinds = mem_zalloc(k_max * sizeof(*obj_tval_kinds));
+
+	/* Group the kinds by tval */
+	memset(obj_tval_start, 0, sizeof(obj_tval_start));
+	for (item = 0; item < k_max; item++) {
+		obj_tval_start[k_info[item].tval + 1]++;
+	}
+	for (tval = 1; tval <= TV_MAX; tval++) {
+		obj_tval_start[tval] += obj_tval_start[tval - 1];
+	}
+	for (tval = 0; tval < TV_MAX; tval++) {
+		int next = obj_tval_start[tval];
+
+		for (item = 0; item < k_max; item++) {
+			if (k_info[item].tval == tval) {
+				obj_tval_kinds[next++] = item;
+			}
+		}
+	}
 
 	/* The cumulative chance starts at zero for each level. */
 	for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
@@ -106,14 +137,36 @@ static void alloc_init_objects(void) {
 			obj_alloc[(lev * (k_max + 1)) + item + 1] =
 				obj_alloc[(lev * (k_max + 1)) + item] + rarity;
 
-			obj_total_tval[lev * TV_MAX + kind->tval] += rarity;
-
 			/* Add to the cumulative prob. in the "great" table */
 			if (!kind_is_good(kind)) rarity = 0;
 			obj_alloc_great[(lev * (k_max + 1)) + item + 1] =
 				obj_alloc_great[(lev * (k_max + 1)) + item] + rarity;
+		}
+	}
 
-			obj_total_tval_great[lev * TV_MAX + kind->tval] += rarity;
+	/* Fill the tables for each tval from the ones above */
+	for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
+		const uint32_t *all = obj_alloc + lev * (k_max + 1);
+		const uint32_t *all_great = obj_alloc_great + lev * (k_max + 1);
+
+		for (tval = 0; tval < TV_MAX; tval++) {
+			int first = lev * run + obj_tval_start[tval] + tval;
+			uint32_t *cum = obj_alloc_tval + first;
+			uint32_t *cum_great = obj_alloc_tval_great + first;
+			int i;
+
+			cum[0] = 0;
+			cum_great[0] = 0;
+			for (i = obj_tval_start[tval]; i < obj_tval_start[tval + 1];
+					i++) {
+				int k = obj_tval_kinds[i];
+
+				cum[1] = cum[0] + (all[k + 1] - all[k]);
+				cum_great[1] = cum_great[0]
+					+ (all_great[k + 1] - all_great[k]);
+				cum++;
+				cum_great++;
+			}
 		}
 	}
 }
@@ -217,8 +270,9 @@ static void cleanup_obj_make(void) {
 	}
 	mem_free(money_type);
 	mem_free(alloc_ego_table);
-	mem_free_alt(obj_total_tval_great);
-	mem_free_alt(obj_total_tval);
+	mem_free(obj_tval_kinds);
+	mem_free_alt(obj_alloc_tval_great);
+	mem_free_alt(obj_alloc_tval);
 	mem_free_alt(obj_alloc_great);
 	mem_free_alt(obj_alloc);
 }
@@ -1301,42 +1355,26 @@ bool kind_is_good(const struct object_kind *kind)
 static struct object_kind *get_obj_num_by_kind(int level, bool good, int tval)
 {
 	const uint32_t *objects;
-	uint32_t total, value;
+	int n = obj_tval_start[tval + 1] - obj_tval_start[tval];
+	uint32_t value;
 	int item;
 
 	assert(level >= 0 && level <= z_info->max_obj_depth);
 	assert(tval >= 0 && tval < TV_MAX);
-	if (good) {
-		objects = obj_alloc_great + level * (z_info->k_max + 1);
-		total = obj_total_tval_great[level * TV_MAX + tval];
-	} else {
-		objects = obj_alloc + level * (z_info->k_max + 1);
-		total = obj_total_tval[level * TV_MAX + tval];
-	}
+	objects = (good ? obj_alloc_tval_great : obj_alloc_tval) +
+		level * (z_info->k_max + TV_MAX) + obj_tval_start[tval] + tval;
 
 	/* No appropriate items of that tval */
-	if (!total) return NULL;
+	if (!objects[n]) return NULL;
 
 	/* Pick an object */
-	value = randint0(total);
+	value = randint0(objects[n]);
 
-	/*
-	 * Find it.  Having a loop to calculate the cumulative probability
-	 * here with only the tval and applying a binary search was slower
-	 * for a test of getting a TV_SWORD from 4.2's available objects.
-	 * So continue to use the O(N) search.
-	 */
-	for (item = 0; item < z_info->k_max; item++) {
-		if (objkind_byid(item)->tval == tval) {
-			uint32_t prob = objects[item + 1] - objects[item];
-
-			if (value < prob) break;
-			value -= prob;
-		}
-	}
+	/* Find it with a binary search over just that tval's kinds. */
+	item = binary_search_probtable(objects, n + 1, value);
 
 	/* Return the item index */
-	return objkind_byid(item);
+	return objkind_byid(obj_tval_kinds[obj_tval_start[tval] + item]);
 }
 
 /**
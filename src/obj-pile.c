@@ -598,8 +598,10 @@ static void object_absorb_merge(struct object *obj1, const struct object *obj2,
 
 	if (combine_charges_timeouts) {
 		/* Combine timeouts for rod stacking */
-		if (tval_can_have_timeout(obj1))
+		if (tval_can_have_timeout(obj1)) {
 			obj1->timeout += obj2->timeout;
+			if (cave) note_charging_object(cave, obj1);
+		}
 
 		/* Combine pvals for wands and staves */
 		if (tval_can_have_charges(obj1) || tval_is_money(obj1)) {
@@ -961,7 +963,7 @@ bool floor_carry(struct chunk *c, struct loc grid, struct object *drop,
 	drop->held_m_idx = 0;
 
 	/* Link to the first object in the pile */
-	pile_insert(&c->squares[grid.y][grid.x].obj, drop);
+	pile_insert(&c->sq_obj[square_index(c, grid)], drop);
 
 	/* Record in the level list */
 	list_object(c, drop);
@@ -1152,7 +1154,7 @@ void drop_near(struct chunk *c, struct object **dropped, int chance,
 	drop_find_grid(player, c, *dropped, prefer_pile, &best);
 	if (floor_carry(c, best, *dropped, &dont_ignore)) {
 		sound(MSG_DROP);
-		if (dont_ignore && (square(c, best)->mon < 0)) {
+		if (dont_ignore && (square_midx(c, best) < 0)) {
 			msg("You feel something roll beneath your feet.");
 		}
 	} else {
@@ -445,17 +445,204 @@ unsigned check_for_inscrip_with_int(const struct object *obj, const char *inscri
 /*** Object kind lookup functions ***/
 
 /**
- * Return the object kind with the given `tval` and `sval`, or NULL.
+ * Hash tables behind lookup_kind(), lookup_sval() and lookup_ego_item().
+ * Each slot holds an index into k_info or e_info plus one, or zero when
+ * empty.  They are made on first use and remade whenever the array they
+ * cover has been reallocated or grown, since extra kinds are added after
+ * object.txt is read; obj_lookup_cleanup() drops them with the arrays.
  */
-struct object_kind *lookup_kind(int tval, int sval)
+static const struct object_kind *kind_index_info;
+static int kind_index_max;
+static uint32_t kind_index_size;
+static int *kind_by_type;
+static int *kind_by_name;
+static char **kind_names;
+
+static const struct ego_item *ego_index_info;
+static int ego_index_max;
+static uint32_t ego_index_size;
+static int *ego_by_name;
+static int *ego_next_name;
+
+static uint32_t lookup_type_hash(int tval, int sval)
+{
+	return (((uint32_t) tval << 16) ^ (uint32_t) sval) * 2654435761u;
+}
+
+/**
+ * Table size for n entries: a power of two, at most half full
+ */
+static uint32_t lookup_table_size(int n)
+{
+	uint32_t size = 16;
+
+	while (size < 2 * (uint32_t) n) size *= 2;
+	return size;
+}
+
+static void kind_index_free(void)
 {
 	int k;
 
-	/* Look for it */
-	for (k = 0; k < z_info->k_max; k++) {
+	if (kind_names) {
+		for (k = 0; k < kind_index_max; k++) {
+			string_free(kind_names[k]);
+		}
+	}
+	mem_free(kind_names);
+	mem_free(kind_by_type);
+	mem_free(kind_by_name);
+	kind_names = NULL;
+	kind_by_type = NULL;
+	kind_by_name = NULL;
+	kind_index_info = NULL;
+	kind_index_max = 0;
+	kind_index_size = 0;
+}
+
+static void ego_index_free(void)
+{
+	mem_free(ego_by_name);
+	mem_free(ego_next_name);
+	ego_by_name = NULL;
+	ego_next_name = NULL;
+	ego_index_info = NULL;
+	ego_index_max = 0;
+	ego_index_size = 0;
+}
+
+/**
+ * Make sure the object kind tables cover k_info as it is now; false if there
+ * is nothing to look in yet
+ */
+static bool kind_index_ready(void)
+{
+	uint32_t mask;
+	int k;
+
+	if (!k_info || z_info->k_max <= 0) return false;
+	if (kind_index_info == k_info && kind_index_max == z_info->k_max) {
+		return true;
+	}
+
+	kind_index_free();
+	kind_index_info = k_info;
+	kind_index_max = z_info->k_max;
+	kind_index_size = lookup_table_size(kind_index_max);
+	mask = kind_index_size - 1;
+	kind_by_type = mem_zalloc(kind_index_size * sizeof(*kind_by_type));
+	kind_by_name = mem_zalloc(kind_index_size * sizeof(*kind_by_name));
+	kind_names = mem_zalloc(kind_index_max * sizeof(*kind_names));
+
+	for (k = 0; k < kind_index_max; k++) {
 		struct object_kind *kind = &k_info[k];
-		if (kind->tval == tval && kind->sval == sval)
-			return kind;
+		uint32_t i = lookup_type_hash(kind->tval, kind->sval) & mask;
+		bool seen = false;
+
+		/* The first kind with a given tval and sval wins */
+		while (kind_by_type[i]) {
+			struct object_kind *other = &k_info[kind_by_type[i] - 1];
+
+			if (other->tval == kind->tval && other->sval == kind->sval) {
+				seen = true;
+				break;
+			}
+			i = (i + 1) & mask;
+		}
+		if (!seen) kind_by_type[i] = k + 1;
+
+		/* Likewise for the formatted name within a tval */
+		if (kind->name) {
+			char cmp_name[1024];
+
+			obj_desc_name_format(cmp_name, sizeof cmp_name, 0,
+				kind->name, 0, false);
+			kind_names[k] = string_make(cmp_name);
+			i = djb2_hash_nocase(cmp_name) & mask;
+			seen = false;
+			while (kind_by_name[i]) {
+				int j = kind_by_name[i] - 1;
+
+				if (k_info[j].tval == kind->tval
+						&& !my_stricmp(kind_names[j], cmp_name)) {
+					seen = true;
+					break;
+				}
+				i = (i + 1) & mask;
+			}
+			if (!seen) kind_by_name[i] = k + 1;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Make sure the ego tables cover e_info as it is now; ego_next_name links
+ * each ego to the next one with the same name
+ */
+static bool ego_index_ready(void)
+{
+	uint32_t mask;
+	int e;
+
+	if (!e_info || z_info->e_max <= 0) return false;
+	if (ego_index_info == e_info && ego_index_max == z_info->e_max) {
+		return true;
+	}
+
+	ego_index_free();
+	ego_index_info = e_info;
+	ego_index_max = z_info->e_max;
+	ego_index_size = lookup_table_size(ego_index_max);
+	mask = ego_index_size - 1;
+	ego_by_name = mem_zalloc(ego_index_size * sizeof(*ego_by_name));
+	ego_next_name = mem_zalloc(ego_index_max * sizeof(*ego_next_name));
+
+	/* Go backwards so each chain runs in e_info order */
+	for (e = ego_index_max - 1; e >= 0; e--) {
+		struct ego_item *ego = &e_info[e];
+		uint32_t i;
+
+		if (!ego->name) continue;
+		i = djb2_hash(ego->name) & mask;
+		while (ego_by_name[i]
+				&& !streq(e_info[ego_by_name[i] - 1].name, ego->name)) {
+			i = (i + 1) & mask;
+		}
+		ego_next_name[e] = ego_by_name[i];
+		ego_by_name[i] = e + 1;
+	}
+
+	return true;
+}
+
+/**
+ * Free the lookup tables, when the arrays they cover go
+ */
+void obj_lookup_cleanup(void)
+{
+	kind_index_free();
+	ego_index_free();
+}
+
+/**
+ * Return the object kind with the given `tval` and `sval`, or NULL.
+ */
+struct object_kind *lookup_kind(int tval, int sval)
+{
+	/* Look for it */
+	if (kind_index_ready()) {
+		uint32_t mask = kind_index_size - 1;
+		uint32_t i = lookup_type_hash(tval, sval) & mask;
+
+		while (kind_by_type[i]) {
+			struct object_kind *kind = &k_info[kind_by_type[i] - 1];
+
+			if (kind->tval == tval && kind->sval == sval)
+				return kind;
+			i = (i + 1) & mask;
+		}
 	}
 
 	/* Failure */
@@ -507,19 +694,22 @@ const struct artifact *lookup_artifact_name(const char *name)
 struct ego_item *lookup_ego_item(const char *name, int tval, int sval)
 {
 	struct object_kind *kind = lookup_kind(tval, sval);
-	int i;
+	uint32_t mask, i;
+	int e;
 
 	/* Look for it */
-	if (!kind) return NULL;
-	for (i = 0; i < z_info->e_max; i++) {
-		struct ego_item *ego = &e_info[i];
-		struct poss_item *poss_item = ego->poss_items;
+	if (!kind || !ego_index_ready()) return NULL;
+	mask = ego_index_size - 1;
+	i = djb2_hash(name) & mask;
+	while (ego_by_name[i] && !streq(e_info[ego_by_name[i] - 1].name, name)) {
+		i = (i + 1) & mask;
+	}
 
-		/* Reject nameless and wrong names */
-		if (!ego->name) continue;
-		if (!streq(name, ego->name)) continue;
+	/* Check tval and sval for each ego with that name */
+	for (e = ego_by_name[i]; e; e = ego_next_name[e - 1]) {
+		struct ego_item *ego = &e_info[e - 1];
+		struct poss_item *poss_item = ego->poss_items;
 
-		/* Check tval and sval */
 		while (poss_item) {
 			if (kind->kidx == poss_item->kidx) {
 				return ego;
@@ -537,7 +727,6 @@ struct ego_item *lookup_ego_item(const char *name, int tval, int sval)
  */
 int lookup_sval(int tval, const char *name)
 {
-	int k;
 	char *pe;
 	unsigned long r = strtoul(name, &pe, 10);
 
@@ -546,17 +735,18 @@ int lookup_sval(int tval, const char *name)
 	}
 
 	/* Look for it */
-	for (k = 0; k < z_info->k_max; k++) {
-		struct object_kind *kind = &k_info[k];
-		char cmp_name[1024];
+	if (kind_index_ready()) {
+		uint32_t mask = kind_index_size - 1;
+		uint32_t i = djb2_hash_nocase(name) & mask;
 
-		if (!kind || !kind->name || kind->tval != tval) continue;
+		while (kind_by_name[i]) {
+			int k = kind_by_name[i] - 1;
 
-		obj_desc_name_format(cmp_name, sizeof cmp_name, 0, kind->name, 0,
-							 false);
-
-		/* Found a match */
-		if (!my_stricmp(cmp_name, name)) return kind->sval;
+			/* Found a match */
+			if (k_info[k].tval == tval && !my_stricmp(kind_names[k], name))
+				return k_info[k].sval;
+			i = (i + 1) & mask;
+		}
 	}
 
 	return -1;
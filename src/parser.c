@@ -78,16 +78,34 @@ struct parser_hook {
 	struct parser_hook *next;
 	enum parser_error (*func)(struct parser *p);
 	char *dir;
+	uint32_t hash;
+	int nspecs;
 	struct parser_spec *fhead;
 	struct parser_spec *ftail;
 };
 
+/**
+ * Directives are looked up in `table`, an open addressing hash table of the
+ * current hooks which is rebuilt after hooks are registered.  It is made
+ * large enough that, where possible, no two directives share a slot.
+ *
+ * Values for the current line live in `line` (a copy of the line, which is
+ * tokenised in place so string values point into it) and `values`; both
+ * are reused from line to line.
+ */
 struct parser {
 	enum parser_error error;
 	unsigned int lineno;
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
+	struct parser_hook **table;
+	uint32_t table_size;
+	bool table_stale;
+	char *line;
+	size_t line_size;
+	struct parser_value *values;
+	int values_size;
 	struct parser_value *fhead;
 	struct parser_value *ftail;
 	void *priv;
@@ -101,26 +119,79 @@ struct parser *parser_new(void) {
 	return p;
 }
 
-static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
-	while (h) {
-		if (streq(h->dir, dir))
+/**
+ * Put a hook in the table, unless a later one with its directive is there.
+ * Returns false if the hook could not go in its home slot.
+ */
+static bool table_add(struct parser *p, struct parser_hook *h) {
+	uint32_t mask = p->table_size - 1;
+	uint32_t i = h->hash & mask;
+	bool home = true;
+
+	while (p->table[i]) {
+		if (p->table[i]->hash == h->hash && streq(p->table[i]->dir, h->dir))
+			return true;
+		home = false;
+		i = (i + 1) & mask;
+	}
+	p->table[i] = h;
+	return home;
+}
+
+/**
+ * Rebuild the hook table, doubling its size (up to a limit) until every
+ * directive has a slot to itself.
+ */
+static void build_table(struct parser *p) {
+	struct parser_hook *h;
+	uint32_t count = 0, limit;
+
+	for (h = p->hooks; h; h = h->next)
+		count++;
+	p->table_size = 2;
+	while (p->table_size < 2 * count)
+		p->table_size *= 2;
+	limit = 64 * p->table_size;
+
+	while (1) {
+		bool perfect = true;
+
+		mem_free(p->table);
+		p->table = mem_zalloc(p->table_size * sizeof(*p->table));
+
+		/* Newest hooks first, so they supersede older ones */
+		for (h = p->hooks; h; h = h->next) {
+			if (!table_add(p, h))
+				perfect = false;
+		}
+		if (perfect || p->table_size >= limit)
 			break;
-		h = h->next;
+		p->table_size *= 2;
 	}
-	return h;
+	p->table_stale = false;
 }
 
-static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead) {
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
-		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
+static struct parser_hook *findhook(struct parser *p, const char *dir) {
+	uint32_t hash = djb2_hash(dir);
+	uint32_t mask, i;
+
+	if (p->table_stale)
+		build_table(p);
+	if (!p->table)
+		return NULL;
+	mask = p->table_size - 1;
+	for (i = hash & mask; p->table[i]; i = (i + 1) & mask) {
+		struct parser_hook *h = p->table[i];
+
+		if (h->hash == hash && streq(h->dir, dir))
+			return h;
 	}
+	return NULL;
+}
+
+static void parser_freeold(struct parser *p) {
+	p->fhead = NULL;
+	p->ftail = NULL;
 }
 
 static bool parse_random(const char *str, random_value *bonus) {
@@ -221,6 +292,7 @@ static bool parse_random(const char *str, random_value *bonus) {
 enum parser_error parser_parse(struct parser *p, const char *line) {
 	char *cline;
 	char *tok;
+	size_t len;
 	struct parser_hook *h;
 	struct parser_spec *s;
 	struct parser_value *v;
@@ -242,11 +314,17 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!*line || *line == '#')
 		return PARSE_ERROR_NONE;
 
-	cline = string_make(line);
+	/* Copy the line to be tokenised */
+	len = strlen(line) + 1;
+	if (len > p->line_size) {
+		p->line_size = MAX(len, 2 * p->line_size);
+		p->line = mem_realloc(p->line, p->line_size);
+	}
+	cline = p->line;
+	memcpy(cline, line, len);
 
 	tok = strtok(cline, ":");
 	if (!tok) {
-		mem_free(cline);
 		p->error = PARSE_ERROR_MISSING_FIELD;
 		return PARSE_ERROR_MISSING_FIELD;
 	}
@@ -255,10 +333,17 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!h) {
 		my_strcpy(p->errmsg, tok, sizeof(p->errmsg));
 		p->error = PARSE_ERROR_UNDEFINED_DIRECTIVE;
-		mem_free(cline);
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 	}
 
+	/* Make room for the values */
+	if (h->nspecs > p->values_size) {
+		p->values_size = h->nspecs;
+		p->values = mem_realloc(p->values,
+			p->values_size * sizeof(*p->values));
+	}
+	v = p->values;
+
 	/* There's a little bit of trickiness here to account for optional
 	 * types. The optional flag has a bit assigned to it in the spec's type
 	 * tag; we compute a temporary type for the spec with that flag removed
@@ -284,7 +369,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 						my_strcpy(p->errmsg, s->name,
 							sizeof(p->errmsg));
 						p->error = PARSE_ERROR_FIELD_TOO_LONG;
-						mem_free(cline);
 						return PARSE_ERROR_FIELD_TOO_LONG;
 					}
 				}
@@ -297,14 +381,12 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			if (!(s->type & PARSE_T_OPT)) {
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_MISSING_FIELD;
-				mem_free(cline);
 				return PARSE_ERROR_MISSING_FIELD;
 			}
 			break;
 		}
 
-		/* Allocate a value node. */
-		v = mem_alloc(sizeof *v);
+		/* Take the next value node. */
 		v->spec.next = NULL;
 		v->spec.type = s->type;
 		v->spec.name = s->name;
@@ -314,8 +396,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -324,8 +404,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-') {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -333,11 +411,9 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		} else if (t == PARSE_T_CHAR) {
 			text_mbstowcs(&v->u.cval, tok, 1);
 		} else if (t == PARSE_T_SYM || t == PARSE_T_STR) {
-			v->u.sval = string_make(tok);
+			v->u.sval = tok;
 		} else if (t == PARSE_T_RAND) {
 			if (!parse_random(tok, &v->u.rval)) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
 				return PARSE_ERROR_NOT_RANDOM;
@@ -350,10 +426,9 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		else
 			p->ftail->spec.next = &v->spec;
 		p->ftail = v;
+		v++;
 	}
 
-	mem_free(cline);
-
 	p->error = h->func(p);
 	return p->error;
 }
@@ -418,6 +493,9 @@ void parser_destroy(struct parser *p) {
 		mem_free(p->hooks);
 		p->hooks = h;
 	}
+	mem_free(p->table);
+	mem_free(p->line);
+	mem_free(p->values);
 	mem_free(p);
 }
 
@@ -434,6 +512,8 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 	if (!name)
 		return -EINVAL;
 	h->dir = string_make(name);
+	h->hash = djb2_hash(name);
+	h->nspecs = 0;
 	h->fhead = NULL;
 	h->ftail = NULL;
 	while (name) {
@@ -476,6 +556,7 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 		else
 			h->fhead = s;
 		h->ftail = s;
+		h->nspecs++;
 	}
 
 	return 0;
@@ -516,6 +597,7 @@ errr parser_reg(struct parser *p, const char *fmt,
 	}
 
 	p->hooks = h;
+	p->table_stale = true;
 	mem_free(cfmt);
 	return 0;
 }
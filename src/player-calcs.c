@@ -3144,7 +3144,9 @@ void redraw_stuff(struct player *p)
  */
 void handle_stuff(struct player *p)
 {
+	section_start(TIMED_HANDLE_STUFF);
 	if (p->upkeep->update) update_stuff(p);
 	if (p->upkeep->redraw) redraw_stuff(p);
+	section_stop(TIMED_HANDLE_STUFF);
 }
 
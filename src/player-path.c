@@ -58,15 +58,31 @@ struct pfdistances {
 };
 
 /**
- * This is a patched version (non-overlapping squares of patch_size by
- * patch_size; patch size is a power of 2) of pfdistances for use in
- * find_path().
+ * Scratch space for pathfinding, kept with a chunk between searches.  Each
+ * search takes a new stamp and a grid's distance only counts if its stamp
+ * matches, so nothing has to be cleared or allocated to start a search.
  */
-struct pfdistances_patched {
-	int ***patches;
-	int patch_size, patch_shift, patch_mask;
-	int npatchy, npatchx;
+struct path_workspace {
 	int height, width;
+	/** This is the stamp of the current search. */
+	uint32_t search;
+	/** These are the stamps of the last search to write each distance. */
+	uint32_t *stamp;
+	/** These are the distances; -1 marks a grid that can not be crossed. */
+	int *dist;
+	/** These are the stamps of the last search to make each grid a goal. */
+	uint32_t *goal;
+	/** These order goals reached in the same number of turns. */
+	int *goal_key;
+	/** This is the queue of grids to expand. */
+	struct priority_queue *pending;
+};
+
+/**
+ * Penalties, in scaled movement turns, for crossing some terrain
+ */
+struct pf_penalties {
+	int unlocked, locked, rubble, tree;
 };
 
 /**
@@ -646,155 +662,239 @@ void release_pfdistances(struct pfdistances *a)
 	}
 }
 
-static void initialize_patched_distances(struct pfdistances_patched *distances,
-		int height, int width)
+/**
+ * Release the pathfinding workspace of a chunk.
+ */
+void path_workspace_free(struct path_workspace *w)
 {
-	int i;
-
-	assert(height > 0 && width > 0);
-	distances->patch_shift = 4;
-	distances->patch_size = 1 << distances->patch_shift;
-	distances->patch_mask = distances->patch_size - 1;
-	distances->npatchy = height >> distances->patch_shift;
-	if (height & distances->patch_mask) {
-		++distances->npatchy;
+	if (w) {
+		mem_free(w->stamp);
+		mem_free(w->dist);
+		mem_free(w->goal);
+		mem_free(w->goal_key);
+		qp_free(w->pending, NULL);
+		mem_free(w);
 	}
-	distances->npatchx = width >> distances->patch_shift;
-	if (width & distances->patch_mask) {
-		++distances->npatchx;
+}
+
+/**
+ * Get the pathfinding workspace of a chunk, creating it if necessary, and
+ * start a new search in it.
+ */
+static struct path_workspace *path_workspace_begin(struct chunk *c)
+{
+	struct path_workspace *w = c->path_work;
+
+	if (!w) {
+		size_t n = (size_t) c->height * c->width;
+
+		w = mem_zalloc(sizeof(*w));
+		w->height = c->height;
+		w->width = c->width;
+		w->stamp = mem_zalloc(n * sizeof(*w->stamp));
+		w->dist = mem_alloc(n * sizeof(*w->dist));
+		w->goal = mem_zalloc(n * sizeof(*w->goal));
+		w->goal_key = mem_alloc(n * sizeof(*w->goal_key));
+		w->pending = qp_new(2 * (c->height + c->width));
+		c->path_work = w;
 	}
-	distances->height = height;
-	distances->width = width;
-	distances->patches = mem_alloc(distances->npatchy
-		* sizeof(*distances->patches));
-	for (i = 0; i < distances->npatchy; ++i) {
-		distances->patches[i] = mem_zalloc(distances->npatchx
-			* sizeof(**distances->patches));
+	assert(w->height == c->height && w->width == c->width);
+
+	qp_flush(w->pending, NULL);
+	if (++w->search == 0) {
+		/* The stamps wrapped around so old ones could look current. */
+		memset(w->stamp, 0, (size_t) w->height * w->width
+			* sizeof(*w->stamp));
+		memset(w->goal, 0, (size_t) w->height * w->width
+			* sizeof(*w->goal));
+		w->search = 1;
 	}
+	return w;
 }
 
-static void release_patched_distances(struct pfdistances_patched *distances)
+/**
+ * Get the distance to a grid in the current search, filling in the starting
+ * value (INT_MAX if it can be crossed, -1 if not) the first time it is seen.
+ */
+static int path_dist(struct path_workspace *w, struct player *p,
+		struct loc grid, bool only_known, bool forbid_traps)
 {
 	int i;
 
-	assert(distances->patches && distances->npatchy > 0
-		&& distances->npatchx > 0);
-	for (i = 0; i < distances->npatchy; ++i) {
-		int j;
-
-		assert(distances->patches[i]);
-		for (j = 0; j < distances->npatchx; ++j) {
-			mem_free(distances->patches[i][j]);
-		}
-		mem_free(distances->patches[i]);
+	if (!square_in_bounds(p->cave, grid)) {
+		return -1;
+	}
+	i = grid_to_i(grid, w->width);
+	if (w->stamp[i] != w->search) {
+		w->stamp[i] = w->search;
+		w->dist[i] = (square_in_bounds_fully(p->cave, grid)
+			&& is_valid_pf(p, grid, only_known, forbid_traps)) ?
+			INT_MAX : -1;
 	}
-	mem_free(distances->patches);
+	return w->dist[i];
 }
 
-static void clear_patched_distances(struct pfdistances_patched *distances)
+/**
+ * Set the distance to a grid that has already been seen in this search.
+ */
+static void set_path_dist(struct path_workspace *w, struct loc grid,
+		int distance)
 {
-	int i;
+	int i = grid_to_i(grid, w->width);
 
-	assert(distances->patches && distances->npatchy > 0
-		&& distances->npatchx > 0);
-	for (i = 0; i < distances->npatchy; ++i) {
-		int j;
+	assert(w->stamp[i] == w->search);
+	w->dist[i] = distance;
+}
 
-		assert(distances->patches[i]);
-		for (j = 0; j < distances->npatchx; ++j) {
-			mem_free(distances->patches[i][j]);
-			distances->patches[i][j] = NULL;
-		}
+/**
+ * Make a grid a goal for search_nearest_goal().  Where several grids share a
+ * goal, the first key given is kept.
+ */
+static void mark_path_goal(struct path_workspace *w, struct loc grid, int key)
+{
+	int i = grid_to_i(grid, w->width);
+
+	if (w->goal[i] != w->search) {
+		w->goal[i] = w->search;
+		w->goal_key[i] = key;
 	}
 }
 
-static void initialize_patch(struct pfdistances_patched *distances,
-		struct loc grid, struct player *p, bool only_known,
-		bool forbid_traps)
+/**
+ * Push a grid on to the pending queue, growing it if necessary; return false
+ * if that is not possible.
+ */
+static bool push_pending(struct path_workspace *w, int priority, int grid_i)
 {
-	int *block;
-	int patchy, patchx, i;
-	struct loc corner, cursor;
-
-	assert(grid.y >= 0 && grid.y < distances->height
-		&& grid.x >= 0 && grid.x < distances->width);
-	patchy = grid.y >> distances->patch_shift;
-	assert(patchy >= 0 && patchy < distances->npatchy);
-	patchx = grid.x >> distances->patch_shift;
-	assert(patchx >= 0 && patchx < distances->npatchx);
-	assert(!distances->patches[patchy][patchx]);
-	block = mem_alloc(distances->patch_size * distances->patch_size
-		* sizeof(*block));
-	distances->patches[patchy][patchx] = block;
-
-	corner.y = patchy << distances->patch_shift;
-	corner.x = patchx << distances->patch_shift;
-	for (cursor.y = corner.y, i = 0; cursor.y < corner.y
-			+ distances->patch_size; ++cursor.y) {
-		for (cursor.x = corner.x; cursor.x < corner.x
-				+ distances->patch_size; ++cursor.x, ++i) {
-			block[i] = (square_in_bounds_fully(p->cave, cursor)
-				&& is_valid_pf(p, cursor, only_known,
-				forbid_traps)) ? INT_MAX : -1;
+	if (qp_len(w->pending) == qp_size(w->pending)) {
+		assert(qp_size(w->pending) > 0);
+		if (qp_size(w->pending) > SIZE_MAX / 2
+				|| qp_resize(w->pending,
+				2 * qp_size(w->pending), NULL)) {
+			return false;
 		}
 	}
+	qp_push_int(w->pending, priority, grid_i);
+	return true;
 }
 
-static bool has_patched_distance(const struct pfdistances_patched *distances,
-		struct loc grid)
+/**
+ * Convert a scaled distance to the rounded number of movement turns.
+ */
+static int scaled_to_turns(int distance)
 {
-	int patchy, patchx;
-
-	assert(grid.y >= 0 && grid.y < distances->height
-		&& grid.x >= 0 && grid.x < distances->width);
-	patchy = grid.y >> distances->patch_shift;
-	assert(patchy >= 0 && patchy < distances->npatchy);
-	patchx = grid.x >> distances->patch_shift;
-	assert(patchx >= 0 && patchx < distances->npatchx);
-	return distances->patches[patchy][patchx];
+	return distance / PF_SCL
+		+ (((distance % PF_SCL) >= (PF_SCL + 1) / 2) ? 1 : 0);
 }
 
-static int get_patched_distance(const struct pfdistances_patched *distances,
-		struct loc grid)
+static void compute_penalties(struct player *p, struct pf_penalties *pen)
 {
-	int patchy, patchx, patchi;
-
-	assert(grid.y >= 0 && grid.y < distances->height
-		&& grid.x >= 0 && grid.x < distances->width);
-	patchy = grid.y >> distances->patch_shift;
-	assert(patchy >= 0 && patchy < distances->npatchy);
-	patchx = grid.x >> distances->patch_shift;
-	assert(patchx >= 0 && patchx < distances->npatchx);
-	assert(distances->patches[patchy][patchx]);
-	patchi = ((grid.y & distances->patch_mask) << distances->patch_shift)
-		+ (grid.x & distances->patch_mask);
-	assert(patchi >= 0 && patchi < distances->patch_size
-		* distances->patch_size);
-	return distances->patches[patchy][patchx][patchi];
+	/* We ignore slowing in water and speedups in trees for now. */
+	pen->unlocked = compute_unlocked_penalty(p);
+	pen->locked = compute_locked_penalty(p);
+	pen->rubble = compute_rubble_penalty(p);
+	pen->tree = compute_tree_penalty(p);
 }
 
-static void set_patched_distance(struct pfdistances_patched *distances,
-		struct loc grid, int distance)
+/**
+ * Help find_path() and search_nearest_goal():  return the penalty for
+ * stepping on to a grid, or -1 if it should be treated as impassable.
+ */
+static int step_penalty(struct player *p, struct loc grid,
+		const struct pf_penalties *pen)
 {
-	int patchy, patchx, patchi;
-
-	assert(grid.y >= 0 && grid.y < distances->height
-		&& grid.x >= 0 && grid.x < distances->width);
-	patchy = grid.y >> distances->patch_shift;
-	assert(patchy >= 0 && patchy < distances->npatchy);
-	patchx = grid.x >> distances->patch_shift;
-	assert(patchx >= 0 && patchx < distances->npatchx);
-	assert(distances->patches[patchy][patchx]);
-	patchi = ((grid.y & distances->patch_mask) << distances->patch_shift)
-		+ (grid.x & distances->patch_mask);
-	assert(patchi >= 0 && patchi < distances->patch_size
-		* distances->patch_size);
-	distances->patches[patchy][patchx][patchi] = distance;
+	if (!square_isknown(p->cave, grid)
+			|| square_ispassable(p->cave, grid)) {
+		return 0;
+	}
+	if (square_iscloseddoor(p->cave, grid)) {
+		return (square_islockeddoor(p->cave, grid)) ?
+			pen->locked : pen->unlocked;
+	}
+	if (square_isrubble(p->cave, grid)) {
+		return pen->rubble;
+	}
+	if (square_istree(p->cave, grid)) {
+		return pen->tree;
+	}
+	/* Should not happen, treat it as completely impassable. */
+	return -1;
 }
 
-static int patched_distances_to_path(const struct pfdistances_patched
-		*distances, struct loc start, struct loc dest,
-		int16_t **step_dirs)
+/**
+ * Search outward from start, in order of distance, for the goals marked in
+ * the current search.  Stop once the nearest goal is known:  the one with
+ * the fewest rounded movement turns and, among those, the lowest key.
+ *
+ * \return the index of that goal grid, or -1 if no goal can be reached.
+ */
+static int search_nearest_goal(struct player *p, struct path_workspace *w,
+		struct loc start, bool only_known, bool forbid_traps)
+{
+	struct pf_penalties pen;
+	int best = -1, best_turns = INT_MAX, best_key = INT_MAX;
+
+	if (!square_in_bounds_fully(p->cave, start)) {
+		return -1;
+	}
+	compute_penalties(p, &pen);
+	(void) path_dist(w, p, start, only_known, forbid_traps);
+	set_path_dist(w, start, 0);
+	if (!push_pending(w, 0, grid_to_i(start, w->width))) {
+		return -1;
+	}
+
+	while (qp_len(w->pending) > 0) {
+		int distance = w->pending->data[0].priority;
+		int i = qp_pop_int(w->pending), turns, k;
+		struct loc grid;
+
+		/* Skip grids since reached by a shorter path. */
+		if (distance > w->dist[i]) {
+			continue;
+		}
+		turns = scaled_to_turns(distance);
+		if (turns > best_turns) {
+			break;
+		}
+		if (w->goal[i] == w->search && turns > 0
+				&& w->goal_key[i] < best_key) {
+			best = i;
+			best_turns = turns;
+			best_key = w->goal_key[i];
+		}
+
+		i_to_grid(i, w->width, &grid);
+		for (k = 0; k < 8; ++k) {
+			struct loc next = loc_sum(grid, ddgrid_ddd[k]);
+			int stored = path_dist(w, p, next, only_known,
+				forbid_traps);
+			int penalty;
+
+			if (stored <= distance + PF_SCL) {
+				continue;
+			}
+			penalty = step_penalty(p, next, &pen);
+			if (penalty < 0 || distance + PF_SCL
+					>= INT_MAX - penalty
+					|| stored <= distance + PF_SCL + penalty) {
+				continue;
+			}
+			set_path_dist(w, next, distance + PF_SCL + penalty);
+			if (!push_pending(w, distance + PF_SCL + penalty,
+					grid_to_i(next, w->width))) {
+				return -1;
+			}
+		}
+	}
+	return best;
+}
+
+/**
+ * Work back from dest to start over the distances of the current search.
+ */
+static int path_workspace_to_path(const struct path_workspace *w,
+		struct loc start, struct loc dest, int16_t **step_dirs)
 {
 	int allocated, length, last_distance;
 	int16_t *steps;
@@ -811,12 +911,17 @@ static int patched_distances_to_path(const struct pfdistances_patched
 		/* Find the next step. */
 		for (k = 0; k < 8; ++k) {
 			struct loc next = loc_sum(dest, ddgrid_ddd[k]);
-			int try_distance;
+			int i, try_distance;
 
-			if (!has_patched_distance(distances, next)) {
+			if (next.y < 0 || next.y >= w->height || next.x < 0
+					|| next.x >= w->width) {
 				continue;
 			}
-			try_distance = get_patched_distance(distances, next);
+			i = grid_to_i(next, w->width);
+			if (w->stamp[i] != w->search) {
+				continue;
+			}
+			try_distance = w->dist[i];
 			if (try_distance >= 0 && last_distance > try_distance) {
 				last_distance = try_distance;
 				best_k = k;
@@ -825,8 +930,6 @@ static int patched_distances_to_path(const struct pfdistances_patched
 		}
 
 		assert(best_k >= 0);
-		assert(best_grid.y >= 0 && best_grid.y < distances->height
-			&& best_grid.x >= 0 && best_grid.x < distances->width);
 		dest = best_grid;
 		assert(length <= allocated && allocated > 0);
 		if (length == allocated) {
@@ -883,52 +986,43 @@ int path_nearest_known(struct player *p, struct loc start,
 	bool only_known = true, forbid_traps = true;
 
 	while (1) {
-		struct pfdistances *distances = NULL;
-		struct loc min_grid = loc(-1, -1);
-		int min_turns = INT_MAX;
+		struct path_workspace *w = path_workspace_begin(p->cave);
+		bool any_goal = false;
 		struct loc grid;
+		int goal = -1;
 
 		for (grid.y = 0; grid.y < p->cave->height; ++grid.y) {
 			for (grid.x = 0; grid.x < p->cave->width; ++grid.x) {
-
 				if (loc_eq(grid, start)) {
 					continue;
 				}
 				if (square_isknown(p->cave, grid)
 						&& (*pred)(p->cave, grid)) {
-					int turns;
-
-					if (!distances) {
-						distances = prepare_pfdistances(
-							p, start, only_known,
-							forbid_traps);
-					}
-					turns = pfdistances_to_turncount(
-						distances, grid);
-					if (turns > 0 && min_turns > turns) {
-						min_turns = turns;
-						min_grid = grid;
-					}
+					mark_path_goal(w, grid,
+						grid_to_i(grid, w->width));
+					any_goal = true;
 				}
 			}
 		}
 
-		if (min_turns < INT_MAX) {
+		if (any_goal) {
+			goal = search_nearest_goal(p, w, start, only_known,
+				forbid_traps);
+		}
+		if (goal >= 0) {
+			struct loc min_grid;
 			int path_length;
 
-			assert(distances
-				&& square_in_bounds(p->cave, min_grid));
+			i_to_grid(goal, w->width, &min_grid);
 			if (dest_grid) {
 				*dest_grid = min_grid;
 			}
-			path_length = pfdistances_to_path(distances,
+			path_length = path_workspace_to_path(w, start,
 				min_grid, step_dirs);
-			release_pfdistances(distances);
 			assert(path_length > 0);
 			return path_length;
 		}
 
-		release_pfdistances(distances);
 		/*
 		 * No destination was found.  Try looser constraints on the
 		 * grids that can be in the path.
@@ -980,15 +1074,14 @@ int path_nearest_unknown(struct player *p, struct loc start,
 	bool only_known = true, forbid_traps = true, passable = true;
 
 	while (1) {
-		struct pfdistances *distances = NULL;
-		struct loc min_grid = loc(-1, -1);
-		int min_turns = INT_MAX;
+		struct path_workspace *w = path_workspace_begin(p->cave);
+		bool any_goal = false;
 		struct loc grid;
+		int goal = -1;
 
 		for (grid.y = 0; grid.y < p->cave->height; ++grid.y) {
 			for (grid.x = 0; grid.x < p->cave->width; ++grid.x) {
 				struct loc test_grid;
-				int turns;
 
 				if (loc_eq(grid, start)
 						|| !square_isknown(p->cave,
@@ -1024,36 +1117,34 @@ int path_nearest_unknown(struct player *p, struct loc start,
 					}
 				}
 
-				if (!distances) {
-					distances = prepare_pfdistances(
-						p, start, only_known,
-						forbid_traps);
-				}
-				turns = pfdistances_to_turncount(distances,
-					test_grid);
-				if (turns > 0 && min_turns > turns) {
-					min_turns = turns;
-					min_grid = test_grid;
-				}
+				/*
+				 * Ties go to the grid found first, so key
+				 * the goal by where it was found.
+				 */
+				mark_path_goal(w, test_grid,
+					grid_to_i(grid, w->width));
+				any_goal = true;
 			}
 		}
 
-		if (min_turns < INT_MAX) {
+		if (any_goal) {
+			goal = search_nearest_goal(p, w, start, only_known,
+				forbid_traps);
+		}
+		if (goal >= 0) {
+			struct loc min_grid;
 			int path_length;
 
-			assert(distances
-				&& square_in_bounds(p->cave, min_grid));
+			i_to_grid(goal, w->width, &min_grid);
 			if (dest_grid) {
 				*dest_grid = min_grid;
 			}
-			path_length = pfdistances_to_path(distances,
+			path_length = path_workspace_to_path(w, start,
 				min_grid, step_dirs);
-			release_pfdistances(distances);
 			assert(path_length > 0);
 			return path_length;
 		}
 
-		release_pfdistances(distances);
 		/*
 		 * No destination was found.  Try looser constraints on the
 		 * grids that can be in the path.
@@ -1115,18 +1206,15 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 		int16_t **step_dirs)
 {
 	/*
-	 * Store the grid at the head of the path in the queue and have
-	 * separate storage for a distance array.  Initialize that distance
-	 * array in patches of patch_size by patch_size to limit overhead from
-	 * parts of the cave that are not traversed when moving to the
-	 * destination.
+	 * Store the grid at the head of the path in the queue and keep the
+	 * distances in the chunk's workspace.  Grids there are only set up
+	 * when the search first reaches them, limiting overhead from parts of
+	 * the cave that are not traversed when moving to the destination.
 	 */
-	struct pfdistances_patched distances;
-	struct priority_queue *pending;
+	struct path_workspace *w;
+	struct pf_penalties pen;
 	struct loc next;
 	int dist_next;
-	int unlocked_penalty, locked_penalty, rubble_penalty, prubble_penalty,
-		tree_penalty;
 	bool only_known, forbid_traps, hit_trap;
 
 	if (!p->cave || !square_in_bounds(p->cave, start)
@@ -1178,21 +1266,11 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 	hit_trap = false;
 
 	/* Precompute quantities to penalize traversing some terrain. */
-	unlocked_penalty = compute_unlocked_penalty(p);
-	locked_penalty = compute_locked_penalty(p);
-	rubble_penalty = compute_rubble_penalty(p);
-	prubble_penalty = compute_passable_rubble_penalty(p);
-	tree_penalty = compute_tree_penalty(p);
-
-	initialize_patched_distances(&distances, p->cave->height,
-		p->cave->width);
-
-	/* Set up the priority queue of feasible paths to consider. */
-	pending = qp_new(4 * (2 + MAX(ABS(start.y - dest.y),
-		ABS(start.x - dest.x))));
+	compute_penalties(p, &pen);
 
-	initialize_patch(&distances, start, p, only_known, forbid_traps);
-	set_patched_distance(&distances, start, 0);
+	w = path_workspace_begin(p->cave);
+	(void) path_dist(w, p, start, only_known, forbid_traps);
+	set_path_dist(w, start, 0);
 	next = start;
 	dist_next = 0;
 	while (1) {
@@ -1207,21 +1285,12 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 
 			if (loc_eq(this_grid, dest)) {
 				/* Reached the destination. */
-				int length = patched_distances_to_path(
-					&distances, start, dest,
+				return path_workspace_to_path(w, start, dest,
 					step_dirs);
-
-				release_patched_distances(&distances);
-				qp_free(pending, NULL);
-				return length;
 			}
 
-			if (!has_patched_distance(&distances, this_grid)) {
-				initialize_patch(&distances, this_grid,
-					p, only_known, forbid_traps);
-			}
-			dist_stored = get_patched_distance(&distances,
-				this_grid);
+			dist_stored = path_dist(w, p, this_grid, only_known,
+				forbid_traps);
 			if (dist_stored <= dist_this) {
 				/*
 				 * Since it is unreachable or already has been
@@ -1231,7 +1300,9 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 				 * visible trap, remember that there is at
 				 * least one trap that affects the pathfinding.
 				 */
-				if (forbid_traps && square_isknown(p->cave,
+				if (forbid_traps && square_in_bounds(p->cave,
+						this_grid)
+						&& square_isknown(p->cave,
 						this_grid)
 						&& square_isvisibletrap(
 						p->cave, this_grid)) {
@@ -1241,9 +1312,10 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 			}
 
 			/*
-			 * Use A* pathfinding:  add an estimate (in this case
-			 * the Chebyshev distance) to get from this_grid to
-			 * the destination.
+			 * Use A* pathfinding:  add an estimate to get from
+			 * this_grid to the destination.  A diagonal step costs
+			 * the same as any other, so the Chebyshev distance is
+			 * the tightest estimate that never overshoots.
 			 */
 			dist_remaining = MAX(ABS(dest.x - this_grid.x),
 				ABS(dest.y - this_grid.y));
@@ -1259,82 +1331,40 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 			}
 			dist_remaining *= PF_SCL;
 
-			if (square_isknown(p->cave, this_grid)
-					&& !square_ispassable(p->cave,
-					this_grid)) {
+			/* Penalize the distance for some hard terrain. */
+			penalty = step_penalty(p, this_grid, &pen);
+			if (penalty < 0 || (penalty > 0
+					&& (dist_this >= dist_stored - penalty
+					|| dist_this >= INT_MAX -
+					penalty - dist_remaining))) {
 				/*
-				 * Penalize the distance for some known but
-				 * impassable terrain.
+				 * The penalty makes this path
+				 * no shorter than what has already
+				 * reached this grid or puts the
+				 * destination out of reach.  Skip it.
 				 */
-				if (square_iscloseddoor(p->cave, this_grid)) {
-					penalty = (square_islockeddoor(p->cave,
-						this_grid)) ? locked_penalty :
-						unlocked_penalty;
-				} else if (square_isrubble(p->cave, this_grid)) {
-					if (square_ispassable(p->cave, this_grid)) {
-						penalty = prubble_penalty;
-					} else {
-						penalty = rubble_penalty;
-					}
-				} else if (square_istree(p->cave, this_grid)) {
-					penalty = tree_penalty;
-				} else {
-					/*
-					 * Should not happen, treat it as
-					 * completely impassable.
-					 */
-					penalty = INT_MAX;
-				}
-
-				if (dist_this >= dist_stored - penalty
-						|| dist_this >= INT_MAX -
-						penalty - dist_remaining) {
-					/*
-					 * The penalty makes this path
-					 * no shorter than what has already
-					 * reached this grid or puts the
-					 * destination out of reach.  Skip it.
-					 */
-					continue;
-				}
-			} else {
-				penalty = 0;
+				continue;
 			}
 
 			/* Push what is pending onto the queue. */
-			if (add_grid > 0) {
-				if (qp_len(pending) == qp_size(pending)) {
-					assert(qp_size(pending) > 0);
-					if (qp_size(pending) > SIZE_MAX / 2 ||
-							qp_resize(pending, 2
-							* qp_size(pending),
-							NULL)) {
-						/*
-						 * Could not resize so give
-						 * up.
-						 */
-						release_patched_distances(
-							&distances);
-						qp_free(pending, NULL);
-						if (step_dirs) {
-							*step_dirs = NULL;
-						}
-						return -1;
-					}
+			if (add_grid > 0 && !push_pending(w, add_priority,
+					add_grid)) {
+				/* Could not resize so give up. */
+				if (step_dirs) {
+					*step_dirs = NULL;
 				}
-				qp_push_int(pending, add_priority, add_grid);
+				return -1;
 			}
 			add_grid = grid_to_i(this_grid, p->cave->width);
 			add_priority = dist_this + penalty + dist_remaining;
-			set_patched_distance(&distances, this_grid,
-				dist_this + penalty);
+			set_path_dist(w, this_grid, dist_this + penalty);
 		}
 
 		if (add_grid >= 0) {
-			i_to_grid(qp_pushpop_int(pending, add_priority,
+			i_to_grid(qp_pushpop_int(w->pending, add_priority,
 				add_grid), p->cave->width, &next);
 		} else {
-			if (qp_len(pending) == 0) {
+			if (qp_len(w->pending) == 0) {
 				/*
 				 * Exhausted possible paths without reaching
 				 * the destination.
@@ -1346,16 +1376,7 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 					 * known visible traps.
 					 */
 					forbid_traps = false;
-					clear_patched_distances(&distances);
-					initialize_patch(&distances, start,
-						p, only_known, forbid_traps);
-					set_patched_distance(&distances,
-						start, 0);
-					next = start;
-					dist_next = 0;
-					continue;
-				}
-				if (only_known) {
+				} else if (only_known) {
 					/*
 					 * Retry but allow grids that are not
 					 * in the player's memory.
@@ -1367,28 +1388,26 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 						forbid_traps = false;
 					}
 					hit_trap = false;
-					clear_patched_distances(&distances);
-					initialize_patch(&distances, start,
-						p, only_known, forbid_traps);
-					set_patched_distance(&distances,
-						start, 0);
-					next = start;
-					dist_next = 0;
-					continue;
-				}
-				/* Nothing to retry so give up. */
-				release_patched_distances(&distances);
-				qp_free(pending, NULL);
-				if (step_dirs) {
-					*step_dirs = NULL;
+				} else {
+					/* Nothing to retry so give up. */
+					if (step_dirs) {
+						*step_dirs = NULL;
+					}
+					return -1;
 				}
-				return -1;
+				w = path_workspace_begin(p->cave);
+				(void) path_dist(w, p, start, only_known,
+					forbid_traps);
+				set_path_dist(w, start, 0);
+				next = start;
+				dist_next = 0;
+				continue;
 			}
-			i_to_grid(qp_pop_int(pending), p->cave->width, &next);
+			i_to_grid(qp_pop_int(w->pending), p->cave->width,
+				&next);
 		}
-		/* The relevant patch should already have been initialized. */
-		assert(has_patched_distance(&distances, next));
-		dist_next = get_patched_distance(&distances, next);
+		/* The grid should already have been reached. */
+		dist_next = w->dist[grid_to_i(next, w->width)];
 	}
 }
 
@@ -1775,7 +1794,7 @@ static bool run_test(const struct player *p)
 		grid = loc_sum(p->grid, ddgrid[new_dir]);
 
 		/* Visible monsters abort running */
-		if (square(cave, grid)->mon > 0) {
+		if (square_midx(cave, grid) > 0) {
 			struct monster *mon = square_monster(cave, grid);
 			if (monster_is_visible(mon)) {
 				return true;
@@ -1935,7 +1954,7 @@ static bool run_test(const struct player *p)
 		if (!square_in_bounds(cave, grid)) continue;
 
 		/* Obvious monsters abort running */
-		if (square(cave, grid)->mon > 0) {
+		if (square_midx(cave, grid) > 0) {
 			struct monster *mon = square_monster(cave, grid);
 			if (monster_is_obvious(mon))
 				return true;
@@ -2109,7 +2128,7 @@ void run_step(int dir)
 			}
 
 			/* Visible monsters abort running */
-			if (square(cave, grid)->mon > 0) {
+			if (square_midx(cave, grid) > 0) {
 				struct monster *mon =
 					square_monster(cave, grid);
 
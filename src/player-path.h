@@ -23,6 +23,7 @@
 #include "z-type.h"
 
 struct pfdistances;
+struct path_workspace;
 
 struct pfdistances *prepare_pfdistances(struct player *p, struct loc start,
 		bool only_known, bool forbid_traps);
@@ -30,6 +31,7 @@ int pfdistances_to_turncount(const struct pfdistances *a, struct loc grid);
 int pfdistances_to_path(const struct pfdistances *a, struct loc grid,
 		int16_t **step_dirs);
 void release_pfdistances(struct pfdistances *a);
+void path_workspace_free(struct path_workspace *w);
 int path_nearest_known(struct player *p, struct loc start,
 		bool (*pred)(struct chunk*, struct loc),
 		struct loc *dest_grid, int16_t **step_dirs);
@@ -146,11 +146,11 @@ void thrust_away(struct loc centre, struct loc target, int grids_away)
 			next = loc_sum(grid, ddgrid_ddd[d % 8]);
 
 			/* There's someone there, try to switch places. */
-			if (square(cave, next)->mon != 0) {
+			if (square_midx(cave, next) != 0) {
 				/* A monster is trying to pass. */
-				if (square(cave, grid)->mon > 0) {
+				if (square_midx(cave, grid) > 0) {
 					struct monster *mon = square_monster(cave, grid);
-					if (square(cave, next)->mon > 0) {
+					if (square_midx(cave, next) > 0) {
 						struct monster *mon1 = square_monster(cave, next);
 
 						/* Monsters cannot pass by stronger monsters. */
@@ -164,8 +164,8 @@ void thrust_away(struct loc centre, struct loc target, int grids_away)
 				}
 
 				/* The player is trying to pass. */
-				if (square(cave, grid)->mon < 0) {
-					if (square(cave, next)->mon > 0) {
+				if (square_midx(cave, grid) < 0) {
+					if (square_midx(cave, next) > 0) {
 						struct monster *mon1 = square_monster(cave, next);
 
 						/* Players cannot pass by stronger monsters. */
@@ -181,7 +181,7 @@ void thrust_away(struct loc centre, struct loc target, int grids_away)
 				if (square_ispassable(cave, next)) {
 					/* Travel down the path. */
 					monster_swap(grid, next);
-					if (square(cave, grid)->mon < 0) {
+					if (square_midx(cave, grid) < 0) {
 						player_handle_post_move(
 							player, true, true);
 					}
@@ -199,14 +199,14 @@ void thrust_away(struct loc centre, struct loc target, int grids_away)
 				/* If there are walls everywhere, stop here. */
 				else if (d == (8 + first_d - 1)) {
 					/* Message for player. */
-					if (square(cave, grid)->mon < 0)
+					if (square_midx(cave, grid) < 0)
 						msg("You come to rest next to a wall.");
 					i = grids_away;
 				}
 			} else {
 				/* Travel down the path. */
 				monster_swap(grid, next);
-				if (square(cave, grid)->mon < 0) {
+				if (square_midx(cave, grid) < 0) {
 					player_handle_post_move(player, true,
 						true);
 				}
@@ -222,13 +222,13 @@ void thrust_away(struct loc centre, struct loc target, int grids_away)
 
 	/* Some special messages or effects for player or monster. */
 	if (square_isfiery(cave, grid)) {
-		if (square(cave, grid)->mon < 0) {
+		if (square_midx(cave, grid) < 0) {
 			msg("You are thrown into molten lava!");
 		}
 	}
 
 	/* Clear the projection mark. */
-	sqinfo_off(square(cave, grid)->info, SQUARE_PROJECT);
+	sqinfo_off(square_info(cave, grid), SQUARE_PROJECT);
 }
 
 /**
@@ -1485,7 +1485,7 @@ void project_m(struct source origin, int r, struct loc grid, int dam, int typ,
 	bool beguile = (origin.what == SRC_PLAYER) ?
 		player_has(player, PF_BEGUILE) : false;
 
-	int m_idx = square(cave, grid)->mon;
+	int m_idx = square_midx(cave, grid);
 
 	project_monster_handler_f monster_handler = monster_handlers[typ];
 	project_monster_handler_context_t context = {
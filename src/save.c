@@ -19,10 +19,12 @@
 #include "angband.h"
 #include "cave.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "mon-group.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "monster.h"
 #include "object.h"
 #include "obj-desc.h"
@@ -306,10 +308,10 @@ void wr_randomizer(void)
 	int i;
 
 	/* current value for the simple RNG */
-	wr_u32b(Rand_value);
+	wr_u32b(Rand_state.value);
 
 	/* state index */
-	wr_u32b(state_i);
+	wr_u32b(Rand_state.state_i);
 
 	/* NULL padding for backwards compatibility with previous versions */
 	wr_u32b(0);
@@ -318,7 +320,7 @@ void wr_randomizer(void)
 
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		wr_u32b(STATE[i]);
+		wr_u32b(Rand_state.state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
@@ -852,11 +854,12 @@ void wr_stores(void)
 /**
  * Write the current dungeon terrain features and info flags
  *
- * Note that the cost and when fields of c->squares[y][x] are not saved
+ * The flat per-grid arrays are in the same row-major order as the saved
+ * runs, so they are encoded directly.
  */
 static void wr_dungeon_aux(struct chunk *c)
 {
-	int y, x;
+	int j, n = c->height * c->width;
 	size_t i;
 
 	uint8_t tmp8u;
@@ -869,26 +872,26 @@ static void wr_dungeon_aux(struct chunk *c)
 	wr_u16b(c->height);
 	wr_u16b(c->width);
 
-	/* Run length encoding of c->squares[y][x].info */
+	/* Run length encoding of c->sq_info */
 	for (i = 0; i < SQUARE_SIZE; i++) {
+		const bitflag *info = c->sq_info + i;
+
 		count = 0;
 		prev_char = 0;
 
 		/* Dump for each grid */
-		for (y = 0; y < c->height; y++) {
-			for (x = 0; x < c->width; x++) {
-				/* Extract the important c->squares[y][x].info flags */
-				tmp8u = square(c, loc(x, y))->info[i];
-
-				/* If the run is broken, or too full, flush it */
-				if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-					wr_byte(count);
-					wr_byte(prev_char);
-					prev_char = tmp8u;
-					count = 1;
-				} else /* Continue the run */
-					count++;
-			}
+		for (j = 0; j < n; j++) {
+			/* Extract the important info flags */
+			tmp8u = info[j * SQUARE_SIZE];
+
+			/* If the run is broken, or too full, flush it */
+			if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
+				wr_byte(count);
+				wr_byte(prev_char);
+				prev_char = tmp8u;
+				count = 1;
+			} else /* Continue the run */
+				count++;
 		}
 
 		/* Flush the data (if any) */
@@ -903,20 +906,18 @@ static void wr_dungeon_aux(struct chunk *c)
 	prev_char = 0;
 
 	/* Dump for each grid */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			/* Extract a byte */
-			tmp8u = square(c, loc(x, y))->feat;
+	for (j = 0; j < n; j++) {
+		/* Extract a byte */
+		tmp8u = c->sq_feat[j];
 
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-				wr_byte(count);
-				wr_byte(prev_char);
-				prev_char = tmp8u;
-				count = 1;
-			} else /* Continue the run */
-				count++;
-		}
+		/* If the run is broken, or too full, flush it */
+		if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
+			wr_byte(count);
+			wr_byte(prev_char);
+			prev_char = tmp8u;
+			count = 1;
+		} else /* Continue the run */
+			count++;
 	}
 
 	/* Flush the data (if any) */
@@ -968,7 +969,7 @@ static void wr_objects_aux(struct chunk *c)
 	wr_u16b(c->obj_max);
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			struct object *obj = square(c, loc(x, y))->obj;
+			struct object *obj = square_object(c, loc(x, y));
 			while (obj) {
 				wr_item(obj);
 				obj = obj->next;
@@ -1005,6 +1006,9 @@ static void wr_monsters_aux(struct chunk *c)
 	if (player->is_dead)
 		return;
 
+	/* Parked monsters' energy is only brought up to date when they wake */
+	monster_schedule_flush(c);
+
 	/* Total monsters */
 	wr_u16b(cave_monster_max(c));
 
@@ -1028,7 +1032,7 @@ static void wr_traps_aux(struct chunk *c)
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			struct trap *trap = square(c, loc(x, y))->trap;
+			struct trap *trap = square_trap(c, loc(x, y));
 			while (trap) {
 				wr_trap(trap);
 				trap = trap->next;
@@ -1096,6 +1100,15 @@ void wr_chunks(void)
 	/* Now write each chunk */
 	for (j = 0; j < chunk_list_max; j++) {
 		struct chunk *c = chunk_list[j];
+		uint32_t start;
+
+		/* Stored chunks unchanged since the last save are copied */
+		if (c->save_record && c->save_record_gen == c->gen) {
+			wr_bytes(c->save_record, c->save_record_size);
+			continue;
+		}
+		start = wr_tell();
+		chunk_expand(c);
 
 		/* Write the terrain and info */
 		wr_dungeon_aux(c);
@@ -1128,7 +1141,15 @@ void wr_chunks(void)
 			}
 			wr_byte(c->ghost->bones_selector);
 		}
+
+		/* Keep the encoded chunk for next time */
+		mem_free(c->save_record);
+		c->save_record = wr_copy(start, &c->save_record_size);
+		c->save_record_gen = c->gen;
 	}
+
+	/* Pack away again any chunks expanded to be written */
+	chunk_list_trim();
 }
 
 
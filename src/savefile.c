@@ -22,6 +22,12 @@
 #include "savefile.h"
 #include "save-charoutput.h"
 #include "z-file.h"
+#ifdef UNIX
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
 
 /**
  * The savefile code.
@@ -187,16 +193,29 @@ void note(const char *message)
  * Base put/get
  * ------------------------------------------------------------------------ */
 
+/**
+ * Make room for at least n more bytes, doubling the buffer so that large
+ * blocks don't cost a reallocation every BUFFER_BLOCK_INCREMENT bytes
+ */
+static void sf_reserve(uint32_t n)
+{
+	uint32_t need = buffer_pos + n;
+
+	if (need <= buffer_size) return;
+	while (buffer_size < need) {
+		buffer_size = MAX(buffer_size * 2,
+			buffer_size + BUFFER_BLOCK_INCREMENT);
+	}
+	buffer = mem_realloc(buffer, buffer_size);
+}
+
 static void sf_put(uint8_t v)
 {
 	assert(buffer != NULL);
 	assert(buffer_size > 0);
 
 	if (buffer_size == buffer_pos)
-	{
-		buffer_size += BUFFER_BLOCK_INCREMENT;
-		buffer = mem_realloc(buffer, buffer_size);
-	}
+		sf_reserve(1);
 
 	assert(buffer_pos < buffer_size);
 
@@ -315,6 +334,46 @@ void pad_bytes(int n)
 	while (n--) wr_byte(0);
 }
 
+/**
+ * Write a run of bytes which were encoded earlier, for instance a record
+ * taken with wr_copy() during a previous save
+ */
+void wr_bytes(const uint8_t *data, uint32_t len)
+{
+	uint32_t i;
+
+	assert(buffer != NULL);
+	sf_reserve(len);
+	memcpy(buffer + buffer_pos, data, len);
+	for (i = 0; i < len; i++) {
+		buffer_check += data[i];
+	}
+	buffer_pos += len;
+}
+
+/**
+ * The position in the current block, for use with wr_copy()
+ */
+uint32_t wr_tell(void)
+{
+	return buffer_pos;
+}
+
+/**
+ * Copy out what has been written to the current block since position from;
+ * the caller owns the copy, and its size is returned in len
+ */
+uint8_t *wr_copy(uint32_t from, uint32_t *len)
+{
+	uint8_t *copy;
+
+	assert(from <= buffer_pos);
+	*len = buffer_pos - from;
+	copy = mem_alloc(MAX(*len, 1));
+	memcpy(copy, buffer + from, *len);
+	return copy;
+}
+
 
 /**
  * ------------------------------------------------------------------------
@@ -322,11 +381,61 @@ void pad_bytes(int n)
  * ------------------------------------------------------------------------ */
 
 
-static bool try_save(ang_file *file)
+/* The whole savefile, as built in memory before it is written out */
+static uint8_t *image;
+static uint32_t image_size;
+static uint32_t image_pos;
+
+#ifdef UNIX
+/* Process writing a savefile in the background, or 0 if there is none */
+static pid_t background_pid;
+#endif
+
+#ifdef UNIX
+/**
+ * The front end's handlers would save or clean up the game from within the
+ * background writer, so it gets the default ones
+ */
+static void background_signals(void)
+{
+	static const int sigs[] = {
+		SIGINT, SIGQUIT, SIGTERM, SIGHUP, SIGSEGV, SIGBUS, SIGFPE,
+		SIGILL, SIGABRT,
+#ifdef SIGTSTP
+		SIGTSTP,
+#endif
+	};
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(sigs); i++) {
+		(void)signal(sigs[i], SIG_DFL);
+	}
+}
+#endif
+
+static void image_put(const void *data, uint32_t len)
+{
+	if (image_pos + len > image_size) {
+		while (image_pos + len > image_size) {
+			image_size = MAX(image_size * 2, BUFFER_INITIAL_SIZE);
+		}
+		image = mem_realloc(image, image_size);
+	}
+	memcpy(image + image_pos, data, len);
+	image_pos += len;
+}
+
+/**
+ * Encode every block into the savefile image
+ */
+static void build_image(void)
 {
 	uint8_t savefile_head[SAVEFILE_HEAD_SIZE];
 	size_t i, pos;
-	bool success = true;
+
+	image_pos = 0;
+	image_put(savefile_magic, 4);
+	image_put(savefile_name, 4);
 
 	/* Start off the buffer */
 	buffer = mem_alloc(BUFFER_INITIAL_SIZE);
@@ -357,94 +466,209 @@ static bool try_save(ang_file *file)
 
 		assert(pos == SAVEFILE_HEAD_SIZE);
 
-		if (! file_write(file, (char *)savefile_head,
-				SAVEFILE_HEAD_SIZE)) {
-			success = false;
-		}
-		if (! file_write(file, (char *)buffer, buffer_pos)) {
-			success = false;
-		}
+		image_put(savefile_head, SAVEFILE_HEAD_SIZE);
+		image_put(buffer, buffer_pos);
 
 		/* pad to 4 byte multiples */
 		if (buffer_pos % 4) {
-			if (! file_write(file, "xxx", 4 - (buffer_pos % 4))) {
-				success = false;
-			}
+			image_put("xxx", 4 - (buffer_pos % 4));
 		}
 	}
 
 	mem_free(buffer);
+	buffer = NULL;
+}
 
-	return success;
+static void free_image(void)
+{
+	mem_free(image);
+	image = NULL;
+	image_size = 0;
+	image_pos = 0;
 }
 
 /**
- * Attempt to save the player in a savefile
+ * Open a new file to write the savefile for path into, and choose the name
+ * the old savefile will be moved to while the new one replaces it
  */
-bool savefile_save(const char *path)
+static ang_file *open_new_savefile(const char *path, char *new_savefile,
+		char *old_savefile, size_t len)
 {
 	ang_file *file;
-	char new_savefile[1024];
-	char old_savefile[1024];
-	bool ok = false;
 
-	/* Generate a CharOutput.txt, mainly for angband.live, when saving. */
-	(void) save_charoutput();
-
-	/* New savefile */
 	safe_setuid_grab();
-	file_get_savefile(old_savefile, sizeof(old_savefile), path, "old");
+	file_get_savefile(old_savefile, len, path, "old");
+	file_get_savefile(new_savefile, len, path, "new");
+	file = file_open(new_savefile, MODE_WRITE, FTYPE_SAVE);
+	safe_setuid_drop();
 
-	/* Open the savefile */
-        file_get_savefile(new_savefile, sizeof(new_savefile), path, "new");
+	return file;
+}
 
-	file = file_open(new_savefile, MODE_WRITE, FTYPE_SAVE);
+/**
+ * Put the new savefile in place of the old one if it was written properly,
+ * otherwise throw it away.  Allocates nothing, so a forked child can use it.
+ */
+static bool replace_savefile(const char *path, const char *new_savefile,
+		const char *old_savefile, bool written)
+{
+	bool ok = written;
+
+	safe_setuid_grab();
+	if (!written) {
+		/* Delete temp file if the save failed */
+		file_delete(new_savefile);
+	} else if (file_exists(path) && !file_move(path, old_savefile)) {
+		ok = false;
+	} else if (!file_move(new_savefile, path)) {
+		ok = false;
+		(void)file_move(old_savefile, path);
+	} else {
+		(void)file_delete(old_savefile);
+	}
 	safe_setuid_drop();
 
-	if (file) {
-		if (file_write(file, (char*)&savefile_magic, 4)
-				&& file_write(file, (char*)&savefile_name, 4)) {
-			ok = try_save(file);
-		}
-		if (!file_close(file)) {
-			ok = false;
-		}
+	return ok;
+}
+
+/**
+ * Write the savefile image to path, by way of a new file which then replaces
+ * the old one
+ */
+static bool write_image(const char *path)
+{
+	char new_savefile[1024];
+	char old_savefile[1024];
+	ang_file *file = open_new_savefile(path, new_savefile, old_savefile,
+		sizeof(new_savefile));
+	bool ok;
+
+	if (!file) return false;
+	ok = file_write(file, (char *)image, image_pos);
+	if (!file_close(file)) {
+		ok = false;
 	}
 
-	if (ok) {
-		/*
-		 * Moving the files about, if interrupted, could leave no save
-		 * file in place.
-		 */
-		character_saved = false;
+	return replace_savefile(path, new_savefile, old_savefile, ok);
+}
+
+/**
+ * Attempt to save the player in a savefile
+ */
+bool savefile_save(const char *path)
+{
+	bool ok;
+
+	/* Saves must land in the order they were made */
+	savefile_background_finish(true);
+
+	/* Generate a CharOutput.txt, mainly for angband.live, when saving. */
+	(void) save_charoutput();
+
+	build_image();
 
-		safe_setuid_grab();
+	/*
+	 * Moving the files about, if interrupted, could leave no save
+	 * file in place.
+	 */
+	character_saved = false;
+	ok = write_image(path);
+	free_image();
+	character_saved = ok;
 
-		if (file_exists(path) && !file_move(path, old_savefile)) {
-			ok = false;
-		} else if (!file_move(new_savefile, path)) {
-			ok = false;
-			(void)file_move(old_savefile, path);
-		} else {
-			(void)file_delete(old_savefile);
-		} 
+	return ok;
+}
 
-		safe_setuid_drop();
+/**
+ * Save the player in a savefile without waiting for the file to be written.
+ *
+ * The savefile is encoded in memory, and on systems which can fork() a child
+ * process writes it out while the game carries on; EVENT_SAVE_DONE reports
+ * how that went once savefile_background_finish() notices it is over.
+ * Elsewhere this is the same as savefile_save().  Returns false if the save
+ * is already known to have failed.
+ */
+bool savefile_save_background(const char *path)
+{
+#ifdef UNIX
+	char new_savefile[1024];
+	char old_savefile[1024];
+	ang_file *file;
+	pid_t pid;
+	bool ok;
 
-		character_saved = ok;
+	savefile_background_finish(true);
+	(void) save_charoutput();
+	build_image();
+	character_saved = false;
+
+	/*
+	 * Everything that allocates is done before the fork, since another
+	 * thread of a threaded front end could be holding the allocator's
+	 * lock at that moment, and the child would then wait on it forever.
+	 */
+	file = open_new_savefile(path, new_savefile, old_savefile,
+		sizeof(new_savefile));
+	if (!file) {
+		free_image();
+		event_signal_flag(EVENT_SAVE_DONE, false);
+		return false;
+	}
 
-		return ok;
+	pid = fork();
+	if (pid == 0) {
+		/* Leave everything else, such as the terminal, to the parent */
+		background_signals();
+		ok = file_write_unbuffered(file, (char *)image, image_pos);
+		_exit(replace_savefile(path, new_savefile, old_savefile, ok) ?
+			0 : 1);
+	}
+	if (pid > 0) {
+		/* The child has its own copy of the file to write to */
+		(void)file_close(file);
+		free_image();
+		background_pid = pid;
+		return true;
 	}
 
-	/* Delete temp file if the save failed */
-	if (file) {
-		/* File is no longer valid, but it still points to a non zero
-		 * value if the file was created above */
-		safe_setuid_grab();
-		file_delete(new_savefile);
-		safe_setuid_drop();
+	ok = file_write(file, (char *)image, image_pos);
+	if (!file_close(file)) {
+		ok = false;
 	}
-	return false;
+	ok = replace_savefile(path, new_savefile, old_savefile, ok);
+	free_image();
+	character_saved = ok;
+	event_signal_flag(EVENT_SAVE_DONE, ok);
+	return ok;
+#else
+	bool ok = savefile_save(path);
+
+	event_signal_flag(EVENT_SAVE_DONE, ok);
+	return ok;
+#endif
+}
+
+/**
+ * Check on a background save, waiting for it to finish if wait is true.
+ * Returns true if there is no background save still in progress.
+ */
+bool savefile_background_finish(bool wait)
+{
+#ifdef UNIX
+	int status;
+	pid_t done;
+	bool ok;
+
+	if (!background_pid) return true;
+	done = waitpid(background_pid, &status, wait ? 0 : WNOHANG);
+	if (done == 0) return false;
+	ok = done == background_pid && WIFEXITED(status)
+		&& WEXITSTATUS(status) == 0;
+	background_pid = 0;
+	character_saved = ok;
+	event_signal_flag(EVENT_SAVE_DONE, ok);
+#endif
+	return true;
 }
 
 
@@ -37,6 +37,18 @@ extern bool character_saved;
  */
 bool savefile_save(const char *path);
 
+/**
+ * Save to the given location, writing the file in the background where
+ * possible; EVENT_SAVE_DONE reports the result.
+ */
+bool savefile_save_background(const char *path);
+
+/**
+ * Check on, or with wait set wait for, a background save.  Returns true if
+ * there is none still in progress.
+ */
+bool savefile_background_finish(bool wait);
+
 /**
  * Load the savefile given.  Returns true on succcess, false otherwise.
  */
@@ -70,6 +82,9 @@ void wr_u32b(uint32_t v);
 void wr_s32b(int32_t v);
 void wr_string(const char *str);
 void pad_bytes(int n);
+void wr_bytes(const uint8_t *data, uint32_t len);
+uint32_t wr_tell(void);
+uint8_t *wr_copy(uint32_t from, uint32_t *len);
 
 /* Reading bits */
 void rd_byte(uint8_t *ip);
@@ -339,13 +339,13 @@ bool target_accept(int y, int x)
 	struct object *obj;
 
 	/* Player grids are always interesting */
-	if (square(cave, grid)->mon < 0) return true;
+	if (square_midx(cave, grid) < 0) return true;
 
 	/* Handle hallucination */
 	if (player->timed[TMD_IMAGE]) return false;
 
 	/* Obvious monsters */
-	if (square(cave, grid)->mon > 0) {
+	if (square_midx(cave, grid) > 0) {
 		struct monster *mon = square_monster(cave, grid);
 		if (monster_is_obvious(mon)) {
 			return true;
@@ -435,6 +435,34 @@ bool target_sighted(void)
 
 #define TS_INITIAL_SIZE	20
 
+/**
+ * Check whether a grid belongs in a target set
+ */
+static bool target_set_accept(struct loc grid, int mode, monster_predicate pred)
+{
+	/* Check bounds */
+	if (!square_in_bounds_fully(cave, grid)) return false;
+
+	/* Require "interesting" contents */
+	if (!target_accept(grid.y, grid.x)) return false;
+
+	/* Special mode */
+	if (mode & (TARGET_KILL)) {
+		struct monster *mon = square_monster(cave, grid);
+
+		/* Must contain a monster */
+		if (mon == NULL) return false;
+
+		/* Must be a targettable monster */
+		if (!target_able(mon)) return false;
+
+		/* Must be the right sort of monster */
+		if (pred && !pred(mon)) return false;
+	}
+
+	return true;
+}
+
 /**
  * Return a target set of interesting locations including monsters, objects,
  * traps, and features.
@@ -448,7 +476,7 @@ bool target_sighted(void)
 struct point_set *target_get_monsters(int mode, monster_predicate pred,
 		bool restrict_to_panel)
 {
-	int y, x;
+	int y, x, i;
 	int min_y, min_x, max_y, max_x;
 	struct point_set *targets = point_set_new(TS_INITIAL_SIZE);
 
@@ -462,33 +490,27 @@ struct point_set *target_get_monsters(int mode, monster_predicate pred,
 		max_x = player->grid.x + z_info->max_range + 1;
 	}
 
-	/* Scan for targets */
-	for (y = min_y; y < max_y; y++) {
-		for (x = min_x; x < max_x; x++) {
-			struct loc grid = loc(x, y);
-
-			/* Check bounds */
-			if (!square_in_bounds_fully(cave, grid)) continue;
-
-			/* Require "interesting" contents */
-			if (!target_accept(y, x)) continue;
-
-			/* Special mode */
-			if (mode & (TARGET_KILL)) {
-				struct monster *mon = square_monster(cave, grid);
-
-				/* Must contain a monster */
-				if (mon == NULL) continue;
+	if (mode & (TARGET_KILL)) {
+		/* Only grids with a monster can qualify, so just look at those */
+		struct point_set *grids = cave_monster_grids(cave,
+			loc(min_x, min_y), loc(max_x - 1, max_y - 1));
 
-				/* Must be a targettable monster */
-				if (!target_able(mon)) continue;
-
-				/* Must be the right sort of monster */
-				if (pred && !pred(mon)) continue;
+		for (i = 0; i < point_set_size(grids); i++) {
+			if (target_set_accept(grids->pts[i], mode, pred)) {
+				add_to_point_set(targets, grids->pts[i]);
+			}
+		}
+		point_set_dispose(grids);
+	} else {
+		/* Scan for targets */
+		for (y = min_y; y < max_y; y++) {
+			for (x = min_x; x < max_x; x++) {
+				struct loc grid = loc(x, y);
+
+				if (target_set_accept(grid, mode, pred)) {
+					add_to_point_set(targets, grid);
+				}
 			}
-
-			/* Save the location */
-			add_to_point_set(targets, grid);
 		}
 	}
 
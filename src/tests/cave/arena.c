@@ -0,0 +1,88 @@
+/* cave/arena */
+/* Exercise the scratch memory arena used by level generation. */
+
+#include "unit-test.h"
+#include "generate.h"
+#include "z-queue.h"
+
+int setup_tests(void **state) {
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	gen_arena_free();
+	return 0;
+}
+
+/* Allocations are aligned, zeroed on request and don't overlap. */
+static int test_alloc(void *state) {
+	struct gen_arena_mark mark = gen_arena_mark();
+	unsigned char *a = gen_alloc(3);
+	int *b = gen_zalloc(100 * sizeof(*b));
+	char *c = gen_alloc(1);
+	int i;
+
+	require(((uintptr_t) a % 16) == 0);
+	require(((uintptr_t) b % 16) == 0);
+	require((unsigned char *) b >= a + 3);
+	require(c >= (char *) (b + 100));
+	for (i = 0; i < 100; i++) {
+		eq(b[i], 0);
+	}
+	gen_arena_release(mark);
+	ok;
+}
+
+/* Releasing to a mark hands the same memory out again, even across blocks. */
+static int test_release(void *state) {
+	struct gen_arena_mark outer = gen_arena_mark();
+	void *first = gen_alloc(64);
+	struct gen_arena_mark inner = gen_arena_mark();
+	void *second = gen_alloc(64);
+	void *big;
+
+	/* Bigger than a block, so it needs one of its own */
+	big = gen_alloc(3 * 1024 * 1024);
+	notnull(big);
+	gen_arena_release(inner);
+	ptreq(gen_alloc(64), second);
+	gen_arena_release(outer);
+	ptreq(gen_alloc(64), first);
+	gen_arena_release(outer);
+	ok;
+}
+
+/* Growing keeps the contents; queues work as usual. */
+static int test_realloc_queue(void *state) {
+	struct gen_arena_mark mark = gen_arena_mark();
+	int *a = gen_alloc(4 * sizeof(*a));
+	struct queue *q;
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		a[i] = i + 10;
+	}
+	a = gen_realloc(a, 4 * sizeof(*a), 8 * sizeof(*a));
+	for (i = 0; i < 4; i++) {
+		eq(a[i], i + 10);
+	}
+
+	q = gen_queue_new(5);
+	for (i = 0; i < 5; i++) {
+		q_push_int(q, i);
+	}
+	eq(q_len(q), 5);
+	for (i = 0; i < 5; i++) {
+		eq(q_pop_int(q), i);
+	}
+	gen_arena_release(mark);
+	ok;
+}
+
+const char *suite_name = "cave/arena";
+struct test tests[] = {
+	{ "alloc", test_alloc },
+	{ "release", test_release },
+	{ "realloc and queue", test_realloc_queue },
+	{ NULL, NULL }
+};
@@ -0,0 +1,95 @@
+/* cave/charging */
+/* Check the list of charging objects kept for recharge_objects(). */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+#include "obj-knowledge.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "player.h"
+#include "player-birth.h"
+
+static struct object_kind *rod_kind;
+
+int setup_tests(void **state) {
+	int i;
+
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	for (i = 1; i < z_info->k_max; i++) {
+		if (k_info[i].tval == TV_ROD && k_info[i].name) {
+			rod_kind = &k_info[i];
+			break;
+		}
+	}
+	cave = t_build_arena(20, 60);
+	player->cave = cave_new(cave->height, cave->width);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(player->cave);
+	player->cave = NULL;
+	cave_free(cave);
+	cave = NULL;
+	cleanup_angband();
+	return 0;
+}
+
+static struct object *make_rod(int timeout) {
+	struct object *obj = object_new();
+
+	object_prep(obj, rod_kind, 0, RANDOMISE);
+	obj->known = object_new();
+	object_set_base_known(player, obj);
+	object_touch(player, obj);
+	obj->timeout = timeout;
+	return obj;
+}
+
+/* Only charging objects go in the list, once each, however they start. */
+static int test_list(void *state) {
+	struct object *idle = make_rod(0), *charging = make_rod(20), *zapped;
+	bool note;
+
+	notnull(rod_kind);
+	find_charging_objects(cave);
+	notnull(cave->charging);
+	eq(cave->charging_count, 0);
+
+	/* Dropped objects are listed if charging */
+	require(floor_carry(cave, loc(5, 5), idle, &note));
+	eq(cave->charging_count, 0);
+	require(floor_carry(cave, loc(10, 10), charging, &note));
+	eq(cave->charging_count, 1);
+
+	/* A rod zapped where it lies is noted, only once */
+	zapped = make_rod(0);
+	require(floor_carry(cave, loc(15, 5), zapped, &note));
+	eq(cave->charging_count, 1);
+	zapped->timeout = 10;
+	note_charging_object(cave, zapped);
+	note_charging_object(cave, zapped);
+	eq(cave->charging_count, 2);
+
+	/* So is an idle stack which a charging rod joins */
+	require(floor_carry(cave, loc(5, 5), make_rod(15), &note));
+	eq(cave->charging_count, 3);
+	ok;
+}
+
+const char *suite_name = "cave/charging";
+struct test tests[] = {
+	{ "list", test_list },
+	{ NULL, NULL }
+};
@@ -0,0 +1,131 @@
+/* cave/connect */
+/* Check that ensure_connectedness() leaves every open grid reachable. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+#include "z-rand.h"
+
+#define HEIGHT 66
+#define WIDTH 198
+
+static struct chunk *c;
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	Rand_init();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	if (c) cave_free(c);
+	cleanup_angband();
+	return 0;
+}
+
+/* Rock with permanent edges and a scattering of floor grids */
+static void make_scattered(int floor_percent) {
+	struct loc grid;
+
+	if (c) cave_free(c);
+	c = cave_new(HEIGHT, WIDTH);
+	for (grid.y = 0; grid.y < HEIGHT; grid.y++) {
+		for (grid.x = 0; grid.x < WIDTH; grid.x++) {
+			if (!square_in_bounds_fully(c, grid)) {
+				square_set_feat(c, grid, FEAT_PERM);
+			} else if (randint0(100) < floor_percent) {
+				square_set_feat(c, grid, FEAT_FLOOR);
+			} else {
+				square_set_feat(c, grid, FEAT_GRANITE);
+			}
+		}
+	}
+}
+
+/* Count the open grids, and those reachable from the first of them */
+static bool all_connected(int *regions_open) {
+	int size = HEIGHT * WIDTH, open = 0, reached = 0, head = 0, tail = 0;
+	int *queue = mem_alloc(size * sizeof(*queue));
+	bool *seen = mem_zalloc(size * sizeof(*seen));
+	struct loc grid;
+
+	for (grid.y = 0; grid.y < HEIGHT; grid.y++) {
+		for (grid.x = 0; grid.x < WIDTH; grid.x++) {
+			if (!square_ispassable(c, grid)) continue;
+			if (!open++) {
+				seen[grid.y * WIDTH + grid.x] = true;
+				queue[tail++] = grid.y * WIDTH + grid.x;
+			}
+		}
+	}
+	while (head < tail) {
+		int n = queue[head++], i;
+		struct loc grid1 = loc(n % WIDTH, n / WIDTH);
+
+		reached++;
+		for (i = 0; i < 8; i++) {
+			struct loc grid2 = loc_sum(grid1, ddgrid_ddd[i]);
+			int n2 = grid2.y * WIDTH + grid2.x;
+
+			if (!square_in_bounds(c, grid2) || seen[n2]) continue;
+			if (!square_ispassable(c, grid2)) continue;
+			seen[n2] = true;
+			queue[tail++] = n2;
+		}
+	}
+	mem_free(seen);
+	mem_free(queue);
+	*regions_open = open;
+	return reached == open;
+}
+
+static int test_scattered(void *state) {
+	int percent, open_before, open_after;
+
+	for (percent = 2; percent <= 50; percent += 8) {
+		make_scattered(percent);
+		(void) all_connected(&open_before);
+		ensure_connectedness(c, false);
+		require(all_connected(&open_after));
+
+		/* Only digging, and no more than needed to join everything */
+		require(open_after >= open_before);
+		require(open_after - open_before < HEIGHT * WIDTH / 2);
+	}
+	ok;
+}
+
+/* Permanent walls are never broken, so a sealed off room stays that way. */
+static int test_sealed(void *state) {
+	struct loc grid;
+	int open;
+
+	make_scattered(10);
+	for (grid.y = 10; grid.y <= 20; grid.y++) {
+		for (grid.x = 10; grid.x <= 20; grid.x++) {
+			bool edge = grid.y == 10 || grid.y == 20 || grid.x == 10
+				|| grid.x == 20;
+
+			square_set_feat(c, grid, edge ? FEAT_PERM : FEAT_FLOOR);
+		}
+	}
+	ensure_connectedness(c, false);
+	require(!all_connected(&open));
+	for (grid.y = 10; grid.y <= 20; grid.y++) {
+		eq(square_isperm(c, loc(10, grid.y)), true);
+		eq(square_isperm(c, loc(20, grid.y)), true);
+	}
+	ok;
+}
+
+const char *suite_name = "cave/connect";
+struct test tests[] = {
+	{ "scattered", test_scattered },
+	{ "sealed", test_sealed },
+	{ NULL, NULL }
+};
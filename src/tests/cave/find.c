@@ -28,7 +28,7 @@ static void wipe_chunk_flags(struct chunk *c) {
 
 	for (grid.y = 0; grid.y < c->height; ++grid.y) {
 		for (grid.x = 0; grid.x < c->width; ++grid.x) {
-			sqinfo_wipe(square(c, grid)->info);
+			sqinfo_wipe(square_info(c, grid));
 		}
 	}
 }
@@ -48,46 +48,46 @@ static int test_cave_find_0(void *state) {
 	for (i = 0; i < (int)N_ELEMENTS(targets); ++i) {
 		target.x = targets[i].x + ((targets[i].x < 0) ? c->width : 0);
 		target.y = targets[i].y + ((targets[i].y < 0) ? c->height : 0);
-		sqinfo_on(square(c, target)->info, SQUARE_ROOM);
+		sqinfo_on(square_info(c, target), SQUARE_ROOM);
 		require(cave_find(c, &grid, square_isroom));
 		require(loc_eq(grid, target));
-		sqinfo_off(square(c, target)->info, SQUARE_ROOM);
+		sqinfo_off(square_info(c, target), SQUARE_ROOM);
 	}
 
 	target.x = 1 + randint0(c->width - 2);
 	target.y = 0;
-	sqinfo_on(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_on(square_info(c, target), SQUARE_ROOM);
 	require(cave_find(c, &grid, square_isroom));
 	require(loc_eq(grid, target));
-	sqinfo_off(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_off(square_info(c, target), SQUARE_ROOM);
 
 	target.x = 1 + randint0(c->width - 2);
 	target.y = c->height - 1;
-	sqinfo_on(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_on(square_info(c, target), SQUARE_ROOM);
 	require(cave_find(c, &grid, square_isroom));
 	require(loc_eq(grid, target));
-	sqinfo_off(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_off(square_info(c, target), SQUARE_ROOM);
 
 	target.x = 1 + randint0(c->width - 2);
 	target.y = 1 + randint0(c->height - 2);
-	sqinfo_on(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_on(square_info(c, target), SQUARE_ROOM);
 	require(cave_find(c, &grid, square_isroom));
 	require(loc_eq(grid, target));
-	sqinfo_off(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_off(square_info(c, target), SQUARE_ROOM);
 
 	target.x = 0;
 	target.y = 1 + randint0(c->height - 2);
-	sqinfo_on(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_on(square_info(c, target), SQUARE_ROOM);
 	require(cave_find(c, &grid, square_isroom));
 	require(loc_eq(grid, target));
-	sqinfo_off(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_off(square_info(c, target), SQUARE_ROOM);
 
 	target.x = c->width - 1;
 	target.y = 1 + randint0(c->height - 2);
-	sqinfo_on(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_on(square_info(c, target), SQUARE_ROOM);
 	require(cave_find(c, &grid, square_isroom));
 	require(loc_eq(grid, target));
-	sqinfo_off(square(c, target)->info, SQUARE_ROOM);
+	sqinfo_off(square_info(c, target), SQUARE_ROOM);
 
 	ok;
 }
@@ -199,7 +199,7 @@ static int test_unbundled_find_0(void *state) {
 		loc(c->width - 2, c->height - 2));
 	while (cave_find_get_grid(&grid, find_state)) {
 		if (square_in_bounds_fully(c, grid) && !square_isroom(c, grid)) {
-			sqinfo_on(square(c, grid)->info, SQUARE_ROOM);
+			sqinfo_on(square_info(c, grid), SQUARE_ROOM);
 		} else {
 			invalid = true;
 		}
@@ -217,7 +217,7 @@ static int test_unbundled_find_0(void *state) {
 	cave_find_reset(find_state);
 	while (cave_find_get_grid(&grid, find_state)) {
 		if (square_in_bounds_fully(c, grid) && square_isroom(c, grid)) {
-			sqinfo_off(square(c, grid)->info, SQUARE_ROOM);
+			sqinfo_off(square_info(c, grid), SQUARE_ROOM);
 		} else {
 			invalid = true;
 		}
@@ -0,0 +1,126 @@
+/* cave/monindex */
+/* Check the index of monster grids against a scan of the whole chunk. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-util.h"
+#include "z-rand.h"
+
+#define HEIGHT 40
+#define WIDTH 90
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	Rand_init();
+	cave = t_build_arena(HEIGHT, WIDTH);
+	player->cave = cave_new(cave->height, cave->width);
+	player_place(cave, player, loc(1, 1));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	wipe_mon_list(cave, player);
+	cave_free(player->cave);
+	player->cave = NULL;
+	cave_free(cave);
+	cave = NULL;
+	cleanup_angband();
+	return 0;
+}
+
+static struct loc random_grid(void) {
+	return loc(randint1(WIDTH - 2), randint1(HEIGHT - 2));
+}
+
+/* The index agrees with a row by row scan over random rectangles */
+static bool index_matches(void) {
+	int i;
+
+	for (i = 0; i < 40; i++) {
+		struct loc a = loc(randint0(WIDTH + 10) - 5,
+			randint0(HEIGHT + 10) - 5);
+		struct loc b = loc(a.x + randint0(30), a.y + randint0(20));
+		struct point_set *grids = cave_monster_grids(cave, a, b);
+		struct loc grid;
+		int n = 0;
+
+		for (grid.y = MAX(a.y, 0); grid.y <= MIN(b.y, HEIGHT - 1);
+				grid.y++) {
+			for (grid.x = MAX(a.x, 0); grid.x <= MIN(b.x, WIDTH - 1);
+					grid.x++) {
+				if (square_midx(cave, grid) <= 0) continue;
+				if (n >= point_set_size(grids)
+						|| !loc_eq(grids->pts[n], grid)) {
+					point_set_dispose(grids);
+					return false;
+				}
+				n++;
+			}
+		}
+		if (n != point_set_size(grids)) {
+			point_set_dispose(grids);
+			return false;
+		}
+		point_set_dispose(grids);
+	}
+	return true;
+}
+
+static int test_place_move_delete(void *state) {
+	int i;
+
+	/* Nothing but the player, who isn't indexed */
+	require(index_matches());
+
+	for (i = 0; i < 150; i++) {
+		struct loc grid = random_grid();
+
+		if (square_isempty(cave, grid)) {
+			t_add_monster(cave, grid, "scruffy little dog");
+		}
+	}
+	require(index_matches());
+
+	/* Moves onto empty grids, swaps and swaps with the player */
+	for (i = 0; i < 300; i++) {
+		struct loc from = random_grid(), to = random_grid();
+
+		if (!square_monster(cave, from)) continue;
+		monster_swap(from, to);
+	}
+	require(index_matches());
+
+	for (i = 0; i < 200; i++) {
+		struct loc grid = random_grid();
+
+		if (square_monster(cave, grid)) {
+			delete_monster(cave, grid);
+		}
+	}
+	require(index_matches());
+
+	/* Renumbering keeps the grids */
+	compact_monsters(cave, 0);
+	require(index_matches());
+	ok;
+}
+
+const char *suite_name = "cave/monindex";
+struct test tests[] = {
+	{ "place move delete", test_place_move_delete },
+	{ NULL, NULL }
+};
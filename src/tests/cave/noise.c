@@ -0,0 +1,155 @@
+/* cave/noise */
+/* Check make_noise() against a plain breadth-first search. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-timed.h"
+#include "player-util.h"
+#include "z-rand.h"
+
+static uint16_t *expected;
+
+static struct chunk *create_random_cave(int height, int width) {
+	struct chunk *c = cave_new(height, width);
+	struct loc grid;
+
+	for (grid.y = 0; grid.y < height; ++grid.y) {
+		for (grid.x = 0; grid.x < width; ++grid.x) {
+			if (!square_in_bounds_fully(c, grid)) {
+				square_set_feat(c, grid, FEAT_PERM);
+			} else {
+				square_set_feat(c, grid, one_in_(4) ?
+					FEAT_GRANITE : FEAT_FLOOR);
+			}
+		}
+	}
+	return c;
+}
+
+static struct loc random_interior_grid(struct chunk *c) {
+	return loc(1 + randint0(c->width - 2), 1 + randint0(c->height - 2));
+}
+
+/* Distances from the player (or decoy), as make_noise() always found them */
+static void brute_noise(struct chunk *c, struct player *p) {
+	struct loc decoy = cave_find_decoy(c);
+	struct loc next = loc_is_zero(decoy) ? p->grid : decoy;
+	int inc = p->timed[TMD_COVERTRACKS] ? 4 : 1;
+	int *queue = mem_alloc((c->height * c->width + 1) * sizeof(int));
+	int head = 0, tail = 0, d;
+
+	memset(expected, 0, c->height * c->width * sizeof(*expected));
+	queue[tail++] = grid_to_i(next, c->width);
+	while (head < tail) {
+		int i = queue[head++];
+
+		i_to_grid(i, c->width, &next);
+		for (d = 0; d < 8; d++) {
+			struct loc grid = loc_sum(next, ddgrid_ddd[d]);
+			int j = grid_to_i(grid, c->width);
+
+			if (!square_in_bounds(c, grid)) continue;
+			if (square_isnoflow(c, grid)) continue;
+			if (expected[j] || loc_eq(grid, p->grid)) continue;
+			expected[j] = expected[i] + inc;
+			queue[tail++] = j;
+		}
+	}
+	mem_free(queue);
+}
+
+static bool noise_matches(struct chunk *c) {
+	struct loc grid;
+
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			if (c->noise.grids[grid.y][grid.x]
+					!= expected[grid_to_i(grid, c->width)]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	Rand_init();
+	character_dungeon = false;
+	cave = create_random_cave(40, 120);
+	player->cave = cave_new(cave->height, cave->width);
+	player_place(cave, player, random_interior_grid(cave));
+	expected = mem_zalloc(cave->height * cave->width * sizeof(*expected));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(expected);
+	cave_free(player->cave);
+	player->cave = NULL;
+	cleanup_angband();
+	return 0;
+}
+
+/* Moving the player and decoy, changing terrain and covering tracks. */
+static int test_noise_random(void *state) {
+	int i;
+
+	for (i = 0; i < 300; i++) {
+		struct loc grid;
+
+		switch (randint0(5)) {
+		case 0:
+			/* Take a step */
+			grid = loc_sum(player->grid, ddgrid_ddd[randint0(8)]);
+			if (square_in_bounds_fully(cave, grid)) {
+				player_place(cave, player, grid);
+			}
+			break;
+		case 1:
+			/* Change the terrain */
+			grid = random_interior_grid(cave);
+			if (!loc_eq(grid, player->grid)) {
+				square_set_feat(cave, grid, one_in_(2) ?
+					FEAT_FLOOR : FEAT_GRANITE);
+			}
+			break;
+		case 2:
+			/* Place or remove a decoy */
+			cave->decoy = one_in_(2) ? loc(0, 0) :
+				random_interior_grid(cave);
+			break;
+		case 3:
+			player->timed[TMD_COVERTRACKS] = one_in_(3) ? 1 : 0;
+			break;
+		case 4:
+			/* Nothing changes */
+			break;
+		}
+		make_noise(cave, player, NULL);
+		brute_noise(cave, player);
+		require(noise_matches(cave));
+	}
+	cave->decoy = loc(0, 0);
+	player->timed[TMD_COVERTRACKS] = 0;
+	ok;
+}
+
+const char *suite_name = "cave/noise";
+struct test tests[] = {
+	{ "noise random", test_noise_random },
+	{ NULL, NULL }
+};
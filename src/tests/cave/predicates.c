@@ -0,0 +1,86 @@
+/* cave/predicates */
+/* Check the terrain flag words and the per-grid predicate plane. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+
+static struct chunk *c;
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	if (c) cave_free(c);
+	cleanup_angband();
+	return 0;
+}
+
+/* The expected plane bits for a feature, straight from its flags */
+static uint8_t pred_bits(int feat)
+{
+	uint8_t bits = 0;
+
+	if (tf_has(f_info[feat].flags, TF_PASSABLE)) bits |= SQUARE_PRED_PASSABLE;
+	if (tf_has(f_info[feat].flags, TF_PROJECT)) bits |= SQUARE_PRED_PROJECT;
+	if (tf_has(f_info[feat].flags, TF_LOS)) bits |= SQUARE_PRED_LOS;
+	return bits;
+}
+
+/* Every flag of every feature reads the same through the flag word. */
+static int test_flag_words(void *state) {
+	int feat, flag;
+
+	for (feat = 0; feat < z_info->f_max; feat++) {
+		for (flag = FLAG_START; flag < TF_MAX; flag++) {
+			eq(feat_has(feat, flag) != 0,
+				tf_has(f_info[feat].flags, flag) != 0);
+		}
+		eq(f_info[feat].sq_pred, pred_bits(feat));
+	}
+	ok;
+}
+
+/* The plane follows terrain changes, and copies of the chunk. */
+static int test_plane(void *state) {
+	struct chunk *copy;
+	struct loc grid;
+	int feat = 0;
+
+	c = cave_new(10, 20);
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			eq(c->sq_pred[square_index(c, grid)], pred_bits(FEAT_NONE));
+			square_set_feat(c, grid, feat);
+			feat = (feat + 1) % z_info->f_max;
+		}
+	}
+
+	copy = chunk_write(c);
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			int fidx = square_fidx(c, grid);
+
+			eq(square_ispassable(c, grid), feat_is_passable(fidx));
+			eq(square_isprojectable(c, grid), feat_is_projectable(fidx));
+			eq(square_allowslos(c, grid), feat_is_los(fidx));
+			eq(copy->sq_pred[square_index(copy, grid)], pred_bits(fidx));
+		}
+	}
+	cave_free(copy);
+	ok;
+}
+
+const char *suite_name = "cave/predicates";
+struct test tests[] = {
+	{ "flag words", test_flag_words },
+	{ "plane", test_plane },
+	{ NULL, NULL }
+};
@@ -0,0 +1,171 @@
+/* cave/store */
+/* Check that stored chunks come back intact after being packed away. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+#include "z-rand.h"
+
+#define NUM_CHUNKS 6
+
+static struct chunk *chunks[NUM_CHUNKS];
+static uint8_t *feats[NUM_CHUNKS];
+static bitflag *infos[NUM_CHUNKS];
+static uint16_t *scents[NUM_CHUNKS];
+static uint16_t old_expanded, old_memory;
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+#ifdef UNIX
+	/* Somewhere for spilled chunks to go */
+	create_needed_dirs();
+#endif
+	Rand_init();
+
+	/* Pack everything but the latest two, and spill everything packed */
+	old_expanded = z_info->stored_expanded;
+	old_memory = z_info->stored_memory;
+	z_info->stored_expanded = 2;
+	z_info->stored_memory = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	int i;
+
+	for (i = 0; i < NUM_CHUNKS; i++) {
+		mem_free(feats[i]);
+		mem_free(infos[i]);
+		mem_free(scents[i]);
+	}
+	z_info->stored_expanded = old_expanded;
+	z_info->stored_memory = old_memory;
+	cleanup_angband();
+	return 0;
+}
+
+static struct chunk *make_chunk(int i) {
+	struct chunk *c = cave_new(20 + i, 40 + 3 * i);
+	int n = c->height * c->width, j;
+	struct loc grid;
+
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			square_set_feat(c, grid, one_in_(3) ?
+				FEAT_GRANITE : FEAT_FLOOR);
+			if (one_in_(5)) {
+				sqinfo_on(square_info(c, grid), SQUARE_ROOM);
+			}
+			if (one_in_(7)) {
+				c->scent.grids[grid.y][grid.x] = randint1(1000);
+			}
+		}
+	}
+	c->name = string_make(format("Level %d", i));
+
+	feats[i] = mem_alloc(n * sizeof(*feats[i]));
+	memcpy(feats[i], c->sq_feat, n * sizeof(*feats[i]));
+	infos[i] = mem_alloc(n * SQUARE_SIZE * sizeof(*infos[i]));
+	memcpy(infos[i], c->sq_info, n * SQUARE_SIZE * sizeof(*infos[i]));
+	scents[i] = mem_alloc(n * sizeof(*scents[i]));
+	for (j = 0; j < n; j++) {
+		scents[i][j] = c->scent.grids[j / c->width][j % c->width];
+	}
+	return c;
+}
+
+static bool chunk_matches(struct chunk *c, int i) {
+	int n = c->height * c->width, j;
+
+	if (memcmp(c->sq_feat, feats[i], n * sizeof(*feats[i]))) return false;
+	if (memcmp(c->sq_info, infos[i], n * SQUARE_SIZE * sizeof(*infos[i])))
+		return false;
+	for (j = 0; j < n; j++) {
+		if (c->scent.grids[j / c->width][j % c->width] != scents[i][j])
+			return false;
+		if (c->sq_obj[j] || c->sq_trap[j] || c->sq_mon[j]) return false;
+	}
+	return true;
+}
+
+/* Older chunks are packed, and found again unchanged by name. */
+static int test_pack(void *state) {
+	int i, packed = 0;
+
+	for (i = 0; i < NUM_CHUNKS; i++) {
+		chunks[i] = make_chunk(i);
+		chunks[i]->flow_queue = mem_alloc(sizeof(int));
+		chunk_list_add(chunks[i]);
+		null(chunks[i]->flow_queue);
+	}
+	for (i = 0; i < NUM_CHUNKS; i++) {
+		if (chunks[i]->packed || chunks[i]->spill_file) {
+			null(chunks[i]->sq_feat);
+			packed++;
+		}
+	}
+	eq(packed, NUM_CHUNKS - 2);
+
+	for (i = 0; i < 3 * NUM_CHUNKS; i++) {
+		int j = randint0(NUM_CHUNKS);
+		struct chunk *c = chunk_find_name(format("Level %d", j));
+
+		ptreq(c, chunks[j]);
+		require(chunk_matches(c, j));
+	}
+	null(chunk_find_name("Level 99"));
+	ok;
+}
+
+/* Finding chunks never packs those found before; trimming does. */
+static int test_find_keeps(void *state) {
+	struct chunk *first, *second;
+	int i, expanded = 0;
+
+	chunk_list_trim();
+	first = chunk_find_name("Level 0");
+	second = chunk_find_name("Level 1");
+	(void) chunk_find_name("Level 2");
+	notnull(first->sq_feat);
+	notnull(second->sq_feat);
+	require(chunk_matches(first, 0));
+	require(chunk_matches(second, 1));
+
+	chunk_list_trim();
+	for (i = 0; i < NUM_CHUNKS; i++) {
+		if (chunks[i]->sq_feat) expanded++;
+	}
+	eq(expanded, 2);
+	ok;
+}
+
+/* Removing chunks leaves the rest findable. */
+static int test_remove(void *state) {
+	int i;
+
+	require(chunk_list_remove("Level 2"));
+	require(!chunk_list_remove("Level 2"));
+	null(chunk_find_name("Level 2"));
+	require(chunk_matches(chunks[2], 2));
+	cave_free(chunks[2]);
+	for (i = 0; i < NUM_CHUNKS; i++) {
+		if (i == 2) continue;
+		ptreq(chunk_find_name(format("Level %d", i)), chunks[i]);
+		require(chunk_matches(chunks[i], i));
+	}
+	eq(chunk_list_max, NUM_CHUNKS - 1);
+	ok;
+}
+
+const char *suite_name = "cave/store";
+struct test tests[] = {
+	{ "pack", test_pack },
+	{ "find keeps", test_find_keeps },
+	{ "remove", test_remove },
+	{ NULL, NULL }
+};
@@ -1,3 +1,12 @@
 TESTPROGS += \
+	cave/arena \
+	cave/charging \
+	cave/connect \
 	cave/find \
-	cave/scatter
+	cave/monindex \
+	cave/noise \
+	cave/predicates \
+	cave/scatter \
+	cave/store \
+	cave/traptimer \
+	cave/view
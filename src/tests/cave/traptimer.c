@@ -0,0 +1,122 @@
+/* cave/traptimer */
+/* Check that disabled traps count down as they did with a full map scan. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-util.h"
+#include "trap.h"
+#include "z-rand.h"
+
+#define NUM_GRIDS 12
+
+static struct loc grids[NUM_GRIDS];
+static int expected[NUM_GRIDS];
+static int t_idx = -1;
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	Rand_init();
+	cave = t_build_arena(20, 60);
+	player->cave = cave_new(cave->height, cave->width);
+	player_place(cave, player, loc(1, 1));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(player->cave);
+	player->cave = NULL;
+	cave_free(cave);
+	cave = NULL;
+	cleanup_angband();
+	return 0;
+}
+
+/* Any ordinary trap will do */
+static int first_trap(void) {
+	int i;
+
+	for (i = 1; i < z_info->trap_max; i++) {
+		if (trf_has(trap_info[i].flags, TRF_TRAP)
+				&& !trf_has(trap_info[i].flags, TRF_DOWN)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* Count down once, both ways */
+static void run_turn(void) {
+	int i;
+
+	decrease_trap_timeouts(cave);
+	for (i = 0; i < NUM_GRIDS; i++) {
+		if (expected[i] > 0) expected[i]--;
+	}
+}
+
+static bool timers_match(void) {
+	int i;
+
+	for (i = 0; i < NUM_GRIDS; i++) {
+		if (square_trap_timeout(cave, grids[i], t_idx) != expected[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static int test_countdown(void *state) {
+	int i, turns;
+
+	t_idx = first_trap();
+	require(t_idx > 0);
+	for (i = 0; i < NUM_GRIDS; i++) {
+		grids[i] = loc(5 + 4 * i, 3 + (i % 10));
+		place_trap(cave, grids[i], t_idx, 1);
+		require(square_trap(cave, grids[i]) != NULL);
+	}
+
+	/* Half disabled before the list is made, one more once it is */
+	for (i = 0; i < NUM_GRIDS / 2; i++) {
+		expected[i] = randint1(20);
+		square_set_trap_timeout(cave, grids[i], false, -1, expected[i]);
+	}
+	run_turn();
+	require(timers_match());
+	expected[NUM_GRIDS / 2] = 15;
+	square_set_trap_timeout(cave, grids[NUM_GRIDS / 2], false, -1, 15);
+
+	for (turns = 0; turns < 30; turns++) {
+		/* Re-disable one that is already counting, and remove another */
+		if (turns == 3) {
+			expected[0] = 25;
+			square_set_trap_timeout(cave, grids[0], false, -1, 25);
+		} else if (turns == 5) {
+			square_remove_all_traps(cave, grids[1]);
+			expected[1] = 0;
+		}
+		run_turn();
+		require(timers_match());
+	}
+
+	/* Everything ran out, so nothing is left to visit */
+	eq(cave->trap_timer_count, 0);
+	ok;
+}
+
+const char *suite_name = "cave/traptimer";
+struct test tests[] = {
+	{ "countdown", test_countdown },
+	{ NULL, NULL }
+};
@@ -0,0 +1,150 @@
+/* cave/view */
+/* Check the incremental update_view() against the brute force version. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-timed.h"
+#include "player-util.h"
+#include "z-rand.h"
+
+static struct chunk *create_random_cave(int height, int width) {
+	const int *feats[] = {
+		&FEAT_FLOOR, &FEAT_FLOOR, &FEAT_FLOOR, &FEAT_FLOOR,
+		&FEAT_FLOOR, &FEAT_FLOOR, &FEAT_GRANITE, &FEAT_CLOSED,
+		&FEAT_RUBBLE, &FEAT_LAVA
+	};
+	struct chunk *c = cave_new(height, width);
+	struct loc grid;
+
+	for (grid.y = 0; grid.y < height; ++grid.y) {
+		for (grid.x = 0; grid.x < width; ++grid.x) {
+			if (!square_in_bounds_fully(c, grid)) {
+				square_set_feat(c, grid, FEAT_PERM);
+			} else {
+				square_set_feat(c, grid, *feats[randint0(
+					(int) N_ELEMENTS(feats))]);
+				if (one_in_(3)) {
+					sqinfo_on(square_info(c, grid),
+						SQUARE_GLOW);
+				}
+				if (one_in_(4)) {
+					sqinfo_on(square_info(c, grid),
+						SQUARE_ROOM);
+				}
+			}
+		}
+	}
+	return c;
+}
+
+static struct loc random_interior_grid(struct chunk *c) {
+	return loc(1 + randint0(c->width - 2), 1 + randint0(c->height - 2));
+}
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	Rand_init();
+	character_dungeon = false;
+	cave = create_random_cave(66, 198);
+	player->cave = cave_new(cave->height, cave->width);
+	player_place(cave, player, random_interior_grid(cave));
+	view_differential_check = true;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	view_differential_check = false;
+	cave_free(player->cave);
+	player->cave = NULL;
+	cleanup_angband();
+	return 0;
+}
+
+/* Repeated updates with nothing changed reuse the last view. */
+static int test_view_static(void *state) {
+	int i;
+
+	view_differential_mismatches = 0;
+	for (i = 0; i < 5; i++) {
+		update_view(cave, player);
+		eq(view_differential_mismatches, 0);
+	}
+	ok;
+}
+
+/* Moving the player, changing terrain, light and blindness. */
+static int test_view_random(void *state) {
+	int i;
+
+	view_differential_mismatches = 0;
+	for (i = 0; i < 400; i++) {
+		struct loc grid;
+
+		switch (randint0(6)) {
+		case 0:
+			/* Take a step */
+			grid = loc_sum(player->grid, ddgrid_ddd[randint0(8)]);
+			if (square_in_bounds_fully(cave, grid)) {
+				player_place(cave, player, grid);
+			}
+			break;
+		case 1:
+			/* Teleport */
+			player_place(cave, player, random_interior_grid(cave));
+			break;
+		case 2:
+			/* Change the terrain near the player */
+			grid = loc_sum(player->grid,
+				loc(randint0(11) - 5, randint0(11) - 5));
+			if (square_in_bounds_fully(cave, grid)
+					&& !loc_eq(grid, player->grid)) {
+				square_set_feat(cave, grid, one_in_(2) ?
+					FEAT_FLOOR : FEAT_GRANITE);
+			}
+			break;
+		case 3:
+			/* Light or darken a grid near the player */
+			grid = loc_sum(player->grid,
+				loc(randint0(11) - 5, randint0(11) - 5));
+			if (square_in_bounds(cave, grid)) {
+				if (square_isglow(cave, grid)) {
+					sqinfo_off(square_info(cave, grid),
+						SQUARE_GLOW);
+				} else {
+					sqinfo_on(square_info(cave, grid),
+						SQUARE_GLOW);
+				}
+			}
+			break;
+		case 4:
+			player->state.cur_light = randint0(5) - 1;
+			break;
+		case 5:
+			player->timed[TMD_BLIND] = one_in_(4) ? 1 : 0;
+			break;
+		}
+		update_view(cave, player);
+		eq(view_differential_mismatches, 0);
+	}
+	player->timed[TMD_BLIND] = 0;
+	ok;
+}
+
+const char *suite_name = "cave/view";
+struct test tests[] = {
+	{ "view static", test_view_static },
+	{ "view random", test_view_random },
+	{ NULL, NULL }
+};
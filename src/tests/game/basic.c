@@ -16,6 +16,7 @@
 #include "player.h"
 #include "player-birth.h"
 #include "player-timed.h"
+#include "player-util.h"
 #include "z-util.h"
 
 static void event_message(game_event_type type, game_event_data *data, void *user) {
@@ -59,6 +60,28 @@ static void reset_before_load(void) {
 	play_again = false;
 }
 
+/* Whether two files have the same contents */
+static bool same_file(const char *path1, const char *path2) {
+	ang_file *f1 = file_open(path1, MODE_READ, FTYPE_RAW);
+	ang_file *f2 = file_open(path2, MODE_READ, FTYPE_RAW);
+	char buf1[1024], buf2[1024];
+	bool same = f1 && f2;
+
+	while (same) {
+		int n1 = file_read(f1, buf1, sizeof(buf1));
+		int n2 = file_read(f2, buf2, sizeof(buf2));
+
+		if (n1 != n2 || memcmp(buf1, buf2, MAX(n1, 0))) {
+			same = false;
+		} else if (n1 <= 0) {
+			break;
+		}
+	}
+	if (f1) file_close(f1);
+	if (f2) file_close(f2);
+	return same;
+}
+
 int setup_tests(void **state) {
 	/* Register a basic error handler */
 	plog_aux = println;
@@ -80,6 +103,8 @@ int setup_tests(void **state) {
 
 int teardown_tests(void *state) {
 	file_delete("Test1");
+	file_delete("Test2");
+	file_delete("Test3");
 	wipe_mon_list(cave, player);
 	cleanup_angband();
 	return 0;
@@ -248,6 +273,92 @@ static int test_drop_eat(void *state) {
 	ok;
 }
 
+static int test_resave(void *state) {
+	reset_before_load();
+
+	/* Load the saved game and leave the town, so it is stored */
+	eq(savefile_load("Test1", false), true);
+	require(character_dungeon);
+	on_new_level();
+	cmdq_push(CMD_GO_DOWN);
+	run_game_loop();
+	require(chunk_list_max > 0);
+
+	/* The second save reuses the stored chunks' records from the first */
+	eq(savefile_save("Test2"), true);
+	notnull(chunk_list[0]->save_record);
+	eq(chunk_list[0]->save_record_gen, chunk_list[0]->gen);
+	eq(savefile_save("Test3"), true);
+	require(same_file("Test2", "Test3"));
+
+	/* And the result still loads */
+	reset_before_load();
+	eq(savefile_load("Test3", false), true);
+	require(chunk_list_max > 0);
+
+	ok;
+}
+
+static int saves_done, saves_ok;
+
+static void count_save(game_event_type type, game_event_data *data, void *user) {
+	saves_done++;
+	if (data->flag) saves_ok++;
+}
+
+static int test_background_save(void *state) {
+	saves_done = saves_ok = 0;
+	event_add_handler(EVENT_SAVE_DONE, count_save, NULL);
+
+	/* Nothing changes in between, so both ways give the same file */
+	eq(savefile_save("Test2"), true);
+	eq(savefile_save_background("Test3"), true);
+	eq(savefile_background_finish(true), true);
+	event_remove_handler(EVENT_SAVE_DONE, count_save, NULL);
+	eq(saves_done, 1);
+	eq(saves_ok, 1);
+	eq(character_saved, true);
+	require(same_file("Test2", "Test3"));
+
+	reset_before_load();
+	eq(savefile_load("Test3", false), true);
+
+	ok;
+}
+
+/* Some level reachable from the given one */
+static int next_place(int place) {
+	struct level *lev = &world->levels[place];
+	const char *name = lev->down ? lev->down : lev->north ? lev->north
+		: lev->east ? lev->east : lev->south ? lev->south : lev->west;
+
+	return name ? level_by_name(world, name)->index : place;
+}
+
+/* A level made with a private generator leaves the game's one alone. */
+static int test_private_rng(void *state) {
+	struct rng_state level_rng, seeded, before;
+
+	reset_before_load();
+	eq(savefile_load("Test1", false), true);
+	require(character_dungeon);
+	on_new_level();
+
+	level_rng.quick = false;
+	Rand_state_init_r(&level_rng, 1234);
+	seeded = level_rng;
+	before = Rand_state;
+	generate_set_rng(&level_rng);
+	player_change_place(player, next_place(player->place));
+	prepare_next_level(player);
+	generate_set_rng(NULL);
+	notnull(cave);
+	require(!memcmp(&before, &Rand_state, sizeof(before)));
+	require(memcmp(&seeded, &level_rng, sizeof(seeded)));
+
+	ok;
+}
+
 const char *suite_name = "game/basic";
 struct test tests[] = {
 	{ "newgame", test_newgame },
@@ -256,5 +367,8 @@ struct test tests[] = {
 	{ "stairs2", test_stairs2 },
 	{ "droppickup", test_drop_pickup },
 	{ "dropeat", test_drop_eat },
+	{ "resave", test_resave },
+	{ "background save", test_background_save },
+	{ "private rng", test_private_rng },
 	{ NULL, NULL }
 };
@@ -298,6 +298,34 @@ static int test_many_repeat(void *state)
 	ok;
 }
 
+static int test_shared_text(void *state) {
+	int i;
+
+	messages_free();
+	messages_init();
+
+	/* Messages with the same text share it, whatever lies between */
+	message_add("You have no room for a Flask of Oil.", MSG_GENERIC);
+	message_add("msg", MSG_GENERIC);
+	message_add("You have no room for a Flask of Oil.", MSG_GENERIC);
+	eq(messages_num(), 3);
+	ptreq(message_str(0), message_str(2));
+	eq(message_count(0), 1);
+
+	/* It outlives the oldest copy being pushed out of a full log */
+	for (i = 0; i < 2 * 2048; i++) {
+		message_add((i % 2) ? "msg" :
+			"You have no room for a Flask of Oil.", MSG_GENERIC);
+	}
+	eq(messages_num(), 2048);
+	require(streq(message_str(0), "msg"));
+	require(streq(message_str(2047),
+		"You have no room for a Flask of Oil."));
+	ptreq(message_str(1), message_str(2047));
+
+	ok;
+}
+
 static int test_color(void *state) {
 	uint8_t color;
 
@@ -663,6 +691,7 @@ struct test tests[] = {
 	{ "add", test_add },
 	{ "fill", test_fill },
 	{ "many_repeat", test_many_repeat },
+	{ "shared_text", test_shared_text },
 	{ "color", test_color },
 	{ "format", test_msg },
 	{ "sound", test_sound },
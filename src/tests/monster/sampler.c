@@ -0,0 +1,205 @@
+/* monster/sampler */
+/* Check that get_mon_num() picks races with the chances it always has. */
+
+#include <math.h>
+#include "unit-test.h"
+#include "test-utils.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "monster.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-quest.h"
+#include "z-rand.h"
+
+#define LEVEL 20
+#define DRAWS 100000
+
+static uint16_t old_ood_amount;
+static double *chance;
+static int *count;
+
+int setup_tests(void **state) {
+	int i;
+
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	Rand_init();
+
+	/* Somewhere with no locality or topography adjustments */
+	for (i = 0; i < world->num_levels; i++) {
+		struct level *lev = &world->levels[i];
+
+		if (lev->topography == TOP_PLAIN
+				&& lev->locality != LOC_NAN_DUNGORTHEB
+				&& lev->locality != LOC_TOL_IN_GAURHOTH) {
+			player->place = i;
+			player->depth = lev->depth;
+			break;
+		}
+	}
+	if (i == world->num_levels) {
+		cleanup_angband();
+		return 1;
+	}
+
+	/* No out of depth monsters */
+	old_ood_amount = z_info->ood_monster_amount;
+	z_info->ood_monster_amount = 0;
+
+	chance = mem_zalloc(z_info->r_max * sizeof(*chance));
+	count = mem_zalloc(z_info->r_max * sizeof(*count));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	get_mon_num_prep(NULL);
+	mem_free(chance);
+	mem_free(count);
+	z_info->ood_monster_amount = old_ood_amount;
+	cleanup_angband();
+	return 0;
+}
+
+/* Races whose chances don't depend on where the player is */
+static bool plain_race(struct monster_race *race) {
+	return !rf_has(race->flags, RF_SEASONAL)
+		&& !rf_has(race->flags, RF_FORCE_DEPTH)
+		&& !rf_has(race->flags, RF_ANGBAND)
+		&& !rf_has(race->flags, RF_AMON_RUDH)
+		&& !rf_has(race->flags, RF_NARGOTHROND)
+		&& !rf_has(race->flags, RF_DUNGORTHEB)
+		&& !rf_has(race->flags, RF_GAURHOTH)
+		&& !rf_has(race->flags, RF_DUNGEON)
+		&& !quest_misplaced_unique_monster_check(race, player);
+}
+
+static bool plain_nonunique(struct monster_race *race) {
+	return plain_race(race) && !rf_has(race->flags, RF_UNIQUE);
+}
+
+/*
+ * Work out the chance of get_mon_num(LEVEL, LEVEL) giving each race allowed
+ * by the hook: one draw weighted by the base probability, then the deepest
+ * (latest among equals) of one, two or three such draws.
+ */
+static void expected_chances(bool (*hook)(struct monster_race *race)) {
+	double *level_prob = mem_zalloc((LEVEL + 1) * sizeof(*level_prob));
+	double total = 0, below = 0;
+	int i, lev;
+
+	for (i = 1; i < z_info->r_max - 1; i++) {
+		struct monster_race *race = &r_info[i];
+
+		chance[i] = 0;
+		if (!race->rarity || race->level <= 0 || race->level > LEVEL)
+			continue;
+		if (!hook(race)) continue;
+		if (rf_has(race->flags, RF_UNIQUE)
+				&& race->cur_num >= race->max_num) continue;
+		chance[i] = (100 / race->rarity) * (1 + race->level / 10);
+		level_prob[race->level] += chance[i];
+		total += chance[i];
+	}
+	for (lev = 0; lev <= LEVEL; lev++) {
+		double f0 = below / total, f1 = (below + level_prob[lev]) / total;
+		double g0 = 0.4 * f0 + 0.5 * f0 * f0 + 0.1 * f0 * f0 * f0;
+		double g1 = 0.4 * f1 + 0.5 * f1 * f1 + 0.1 * f1 * f1 * f1;
+
+		for (i = 1; i < z_info->r_max - 1; i++) {
+			if (chance[i] && r_info[i].level == lev) {
+				chance[i] *= (g1 - g0) / level_prob[lev];
+			}
+		}
+		below += level_prob[lev];
+	}
+	mem_free(level_prob);
+}
+
+/*
+ * Draw a lot of monsters and compare with the expected chances; bins too
+ * small for the test are lumped together, and the bound is generous
+ * enough that a correct sampler essentially never fails it.
+ */
+static bool chi_square_ok(void) {
+	double chi = 0, lump_expected = 0;
+	int i, lump_count = 0, bins = 0;
+
+	memset(count, 0, z_info->r_max * sizeof(*count));
+	for (i = 0; i < DRAWS; i++) {
+		struct monster_race *race = get_mon_num(LEVEL, LEVEL);
+
+		if (!race) return false;
+		count[race->ridx]++;
+	}
+	for (i = 1; i < z_info->r_max - 1; i++) {
+		double expected = chance[i] * DRAWS;
+
+		if (!chance[i]) {
+			if (count[i]) return false;
+		} else if (expected < 5) {
+			lump_expected += expected;
+			lump_count += count[i];
+		} else {
+			chi += (count[i] - expected) * (count[i] - expected)
+				/ expected;
+			bins++;
+		}
+	}
+	if (lump_expected > 0) {
+		chi += (lump_count - lump_expected) * (lump_count - lump_expected)
+			/ lump_expected;
+		bins++;
+	}
+	return bins > 1 && chi < (bins - 1) + 6 * sqrt(2.0 * (bins - 1));
+}
+
+static int test_distribution(void *state) {
+	get_mon_num_prep(plain_nonunique);
+	expected_chances(plain_nonunique);
+	require(chi_square_ok());
+	ok;
+}
+
+/* Uniques already in play are never chosen, and the rest share their room. */
+static int test_used_up_uniques(void *state) {
+	int i, used_up = 0;
+
+	for (i = 1; i < z_info->r_max - 1 && used_up < 5; i++) {
+		struct monster_race *race = &r_info[i];
+
+		if (rf_has(race->flags, RF_UNIQUE) && race->rarity
+				&& race->level > 0 && race->level <= LEVEL
+				&& plain_race(race)) {
+			race->cur_num = race->max_num;
+			used_up++;
+		}
+	}
+	require(used_up > 0);
+
+	get_mon_num_prep(plain_race);
+	expected_chances(plain_race);
+	require(chi_square_ok());
+
+	/* And they come back when they are free again */
+	for (i = 1; i < z_info->r_max - 1; i++) {
+		r_info[i].cur_num = 0;
+	}
+	expected_chances(plain_race);
+	require(chi_square_ok());
+	ok;
+}
+
+const char *suite_name = "monster/sampler";
+struct test tests[] = {
+	{ "distribution", test_distribution },
+	{ "used up uniques", test_used_up_uniques },
+	{ NULL, NULL }
+};
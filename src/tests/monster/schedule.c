@@ -0,0 +1,169 @@
+/* monster/schedule */
+/* Check that parked monsters gain the energy they would have every turn. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-util.h"
+#include "z-rand.h"
+
+#define NUM_MONSTERS 30
+
+static const char *race_names[] = {
+	"wolf", "cave spider", "grey mold", "scruffy little dog",
+	"black ooze"
+};
+
+static struct monster *mons[NUM_MONSTERS];
+static int expected[NUM_MONSTERS];
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	Rand_init();
+	cave = t_build_arena(20, 60);
+	player->cave = cave_new(cave->height, cave->width);
+	player_place(cave, player, loc(1, 1));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	wipe_mon_list(cave, player);
+	cave_free(player->cave);
+	player->cave = NULL;
+	cave_free(cave);
+	cave = NULL;
+	cleanup_angband();
+	return 0;
+}
+
+/* Nobody is in view or can hear the player, so every monster is passive */
+static void place_monsters(void) {
+	int i;
+
+	for (i = 0; i < NUM_MONSTERS; i++) {
+		struct loc grid = loc(20 + i, 2 + (i % 15));
+
+		mons[i] = t_add_monster(cave, grid,
+			race_names[i % (int) N_ELEMENTS(race_names)]);
+		expected[i] = mons[i]->energy;
+	}
+}
+
+/* What the monster's energy would be after a turn of the old full scan */
+static void expect_turn(int i) {
+	bool moving = expected[i] >= z_info->move_energy;
+
+	expected[i] += turn_energy(mons[i]->mspeed);
+	if (moving) {
+		expected[i] -= z_info->move_energy;
+	}
+}
+
+static void run_turn(void) {
+	int i;
+
+	process_monsters(0);
+	reset_monsters();
+	for (i = 0; i < NUM_MONSTERS; i++) {
+		expect_turn(i);
+	}
+	turn++;
+}
+
+/* Energy is right whenever anyone looks. */
+static int test_parked_energy(void *state) {
+	int i, t;
+
+	place_monsters();
+	for (t = 0; t < 300; t++) {
+		run_turn();
+
+		/* Anything which touches a monster wakes it up to date */
+		if (one_in_(3)) {
+			i = randint0(NUM_MONSTERS);
+			monster_wake(mons[i], false, 0);
+			eq(mons[i]->energy, expected[i]);
+		}
+	}
+	monster_schedule_flush(cave);
+	for (i = 0; i < NUM_MONSTERS; i++) {
+		eq(mons[i]->energy, expected[i]);
+	}
+	ok;
+}
+
+/* A parked monster's slot can be reused. */
+static int test_reuse_slot(void *state) {
+	struct loc grid = mons[0]->grid;
+	int i, t;
+
+	for (t = 0; t < 25; t++) {
+		run_turn();
+	}
+	delete_monster(cave, grid);
+	mons[0] = t_add_monster(cave, grid, "wolf");
+	expected[0] = mons[0]->energy;
+	for (t = 0; t < 100; t++) {
+		run_turn();
+	}
+	monster_schedule_flush(cave);
+	for (i = 0; i < NUM_MONSTERS; i++) {
+		eq(mons[i]->energy, expected[i]);
+	}
+	ok;
+}
+
+/* Jumping over quiet turns leaves energy as if they had been run. */
+static int test_skip_quiet(void *state) {
+	int i, t = 0, skipped = 0;
+
+	while (t < 300) {
+		int32_t quiet = monster_schedule_quiet_turns(cave);
+
+		if (quiet > 0) {
+			int32_t k = MIN(quiet, 300 - t), j;
+
+			monster_schedule_skip(cave, k);
+			for (j = 0; j < k; j++) {
+				for (i = 0; i < NUM_MONSTERS; i++) {
+					expect_turn(i);
+				}
+			}
+			turn += k;
+			t += k;
+			skipped += k;
+		} else {
+			run_turn();
+			t++;
+		}
+	}
+	require(skipped > 0);
+	monster_schedule_flush(cave);
+	for (i = 0; i < NUM_MONSTERS; i++) {
+		eq(mons[i]->energy, expected[i]);
+	}
+	ok;
+}
+
+const char *suite_name = "monster/schedule";
+struct test tests[] = {
+	{ "parked energy", test_parked_energy },
+	{ "reuse slot", test_reuse_slot },
+	{ "skip quiet turns", test_skip_quiet },
+	{ NULL, NULL }
+};
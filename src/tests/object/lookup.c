@@ -0,0 +1,130 @@
+/* object/lookup */
+/* Check the indexed name and tval/sval lookups against plain scans. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "init.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "obj-desc.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "object.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Every kind is found by its tval and sval, and by its name. */
+static int test_kinds(void *state) {
+	int k, j;
+
+	for (k = 0; k < z_info->k_max; k++) {
+		struct object_kind *kind = &k_info[k];
+		struct object_kind *first = kind;
+		char name[1024];
+
+		for (j = 0; j < k; j++) {
+			if (k_info[j].tval == kind->tval
+					&& k_info[j].sval == kind->sval) {
+				first = &k_info[j];
+				break;
+			}
+		}
+		ptreq(lookup_kind(kind->tval, kind->sval), first);
+
+		if (!kind->name || !kind->tval) continue;
+		obj_desc_name_format(name, sizeof(name), 0, kind->name, 0, false);
+		first = kind;
+		for (j = 0; j < k; j++) {
+			char other[1024];
+
+			if (!k_info[j].name || k_info[j].tval != kind->tval) continue;
+			obj_desc_name_format(other, sizeof(other), 0,
+				k_info[j].name, 0, false);
+			if (!my_stricmp(other, name)) {
+				first = &k_info[j];
+				break;
+			}
+		}
+		eq(lookup_sval(kind->tval, name), first->sval);
+	}
+
+	/* Misses */
+	eq(lookup_sval(tval_find_idx("sword"), "Sword of No Such Thing"), -1);
+	eq(lookup_sval(tval_find_idx("sword"), "12"), 12);
+	null(lookup_kind(tval_find_idx("sword"), 9999));
+	ok;
+}
+
+/* Every ego is found for each kind it can go on. */
+static int test_egos(void *state) {
+	int e;
+
+	for (e = 0; e < z_info->e_max; e++) {
+		struct ego_item *ego = &e_info[e];
+		struct poss_item *poss;
+
+		if (!ego->name) continue;
+		for (poss = ego->poss_items; poss; poss = poss->next) {
+			struct object_kind *kind = &k_info[poss->kidx];
+			struct ego_item *found =
+				lookup_ego_item(ego->name, kind->tval, kind->sval);
+
+			notnull(found);
+			require(streq(found->name, ego->name));
+			require(found <= ego);
+		}
+	}
+	null(lookup_ego_item("of No Such Thing", TV_SWORD, 1));
+	ok;
+}
+
+/* Races are found by exact name, near name, then substring. */
+static int test_races(void *state) {
+	int r;
+
+	for (r = 0; r < z_info->r_max - 1; r++) {
+		struct monster_race *race = &r_info[r];
+		char upper[256];
+		int j;
+
+		if (!race->name) continue;
+		for (j = 0; j < r; j++) {
+			if (r_info[j].name && streq(r_info[j].name, race->name)) break;
+		}
+		ptreq(lookup_monster(race->name), &r_info[j]);
+
+		my_strcpy(upper, race->name, sizeof(upper));
+		for (j = 0; upper[j]; j++) {
+			upper[j] = toupper((unsigned char) upper[j]);
+		}
+		if (!streq(upper, race->name)) {
+			struct monster_race *found = lookup_monster(upper);
+
+			notnull(found);
+			eq(my_stricmp(found->name, race->name), 0);
+		}
+	}
+	ptreq(lookup_monster("Scrawny Cat"), lookup_monster("scrawny cat"));
+	ptreq(lookup_monster("WNY CA"), lookup_monster("scrawny cat"));
+	null(lookup_monster("No Such Monster At All"));
+	ok;
+}
+
+const char *suite_name = "object/lookup";
+struct test tests[] = {
+	{ "kinds", test_kinds },
+	{ "egos", test_egos },
+	{ "races", test_races },
+	{ NULL, NULL }
+};
@@ -2,6 +2,8 @@ TESTPROGS += \
 	object/alloc \
 	object/attack \
 	object/info \
+	object/lookup \
 	object/pile \
 	object/slays \
+	object/tvalalloc \
 	object/util
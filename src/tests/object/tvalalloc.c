@@ -0,0 +1,115 @@
+/* object/tvalalloc */
+/* Check get_obj_num() with a tval against the old scan over every kind. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "init.h"
+#include "obj-make.h"
+#include "obj-tval.h"
+#include "object.h"
+#include "z-rand.h"
+#include <time.h>
+
+#define SPEED_DRAWS 200000
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	Rand_init();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+static bool allowed(const struct object_kind *kind, int level, bool good)
+{
+	if (level < kind->alloc_min || level > kind->alloc_max) return false;
+	return !good || kind_is_good(kind);
+}
+
+/*
+ * What get_obj_num() gave before: the same draws from the random number
+ * generator, then a walk over all of k_info.
+ */
+static struct object_kind *scan_obj_num(int level, bool good, int tval)
+{
+	uint32_t total = 0, value;
+	int k;
+
+	if ((level > 0) && one_in_(z_info->great_obj))
+		level = 1 + (level * z_info->max_obj_depth / randint1(z_info->max_obj_depth));
+	level = MIN(level, z_info->max_obj_depth);
+	level = MAX(level, 0);
+
+	for (k = 0; k < z_info->k_max; k++) {
+		if (k_info[k].tval == tval && allowed(&k_info[k], level, good)) {
+			total += k_info[k].alloc_prob;
+		}
+	}
+	if (!total) return NULL;
+	value = randint0(total);
+	for (k = 0; k < z_info->k_max; k++) {
+		if (k_info[k].tval == tval && allowed(&k_info[k], level, good)) {
+			if (value < (uint32_t) k_info[k].alloc_prob) break;
+			value -= k_info[k].alloc_prob;
+		}
+	}
+	return &k_info[k];
+}
+
+/* Given the same random numbers, the same kinds come out. */
+static int test_same_as_scan(void *state) {
+	int tval, level, i;
+
+	for (tval = 1; tval < TV_MAX; tval++) {
+		for (level = 0; level <= z_info->max_obj_depth; level += 7) {
+			for (i = 0; i < 40; i++) {
+				bool good = (i % 2) == 1;
+				struct rng_state saved = Rand_state;
+				struct object_kind *fast = get_obj_num(level, good, tval);
+				struct object_kind *slow;
+
+				Rand_state = saved;
+				slow = scan_obj_num(level, good, tval);
+				ptreq(fast, slow);
+			}
+		}
+	}
+	ok;
+}
+
+/* Time drawing swords both ways; report it when verbose. */
+static int test_speed(void *state) {
+	int tval = tval_find_idx("sword");
+	clock_t start;
+	double fast, slow;
+	int i;
+
+	start = clock();
+	for (i = 0; i < SPEED_DRAWS; i++) {
+		notnull(get_obj_num(30, false, tval));
+	}
+	fast = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	for (i = 0; i < SPEED_DRAWS; i++) {
+		notnull(scan_obj_num(30, false, tval));
+	}
+	slow = (double) (clock() - start) / CLOCKS_PER_SEC;
+	if (verbose) {
+		printf("    %d swords: %.3f s by tval table, %.3f s by scan\n",
+			SPEED_DRAWS, fast, slow);
+	}
+	ok;
+}
+
+const char *suite_name = "object/tvalalloc";
+struct test tests[] = {
+	{ "same as scan", test_same_as_scan },
+	{ "speed", test_speed },
+	{ NULL, NULL }
+};
@@ -3,6 +3,7 @@
 #include "unit-test.h"
 
 #include "parser.h"
+#include "z-form.h"
 #ifndef WINDOWS
 #include <locale.h>
 #include <langinfo.h>
@@ -561,6 +562,60 @@ static int test_char2(void *state) {
 	ok;
 }
 
+static enum parser_error helper_which0(struct parser *p) {
+	int *which = parser_priv(p);
+	*which = 0;
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error helper_which1(struct parser *p) {
+	int *which = parser_priv(p);
+	*which = 1;
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error helper_which_int(struct parser *p) {
+	int *which = parser_priv(p);
+	*which = parser_getint(p, "n");
+	return PARSE_ERROR_NONE;
+}
+
+static int test_supersede(void *state) {
+	int which = -1;
+	errr r = parser_reg(state, "test-which", helper_which0);
+	eq(r, 0);
+	parser_setpriv(state, &which);
+	r = parser_parse(state, "test-which");
+	eq(r, PARSE_ERROR_NONE);
+	eq(which, 0);
+	r = parser_reg(state, "test-which", helper_which1);
+	eq(r, 0);
+	r = parser_parse(state, "test-which");
+	eq(r, PARSE_ERROR_NONE);
+	eq(which, 1);
+	ok;
+}
+
+static int test_many(void *state) {
+	char buf[32];
+	int which = -1;
+	int i;
+
+	for (i = 0; i < 200; i++) {
+		strnfmt(buf, sizeof(buf), "test-many%d int n", i);
+		eq(parser_reg(state, buf, helper_which_int), 0);
+	}
+	parser_setpriv(state, &which);
+	for (i = 199; i >= 0; i--) {
+		strnfmt(buf, sizeof(buf), "test-many%d:%d", i, i);
+		eq(parser_parse(state, buf), PARSE_ERROR_NONE);
+		eq(which, i);
+	}
+	eq(parser_parse(state, "test-many200:1"),
+		PARSE_ERROR_UNDEFINED_DIRECTIVE);
+	ok;
+}
+
 const char *suite_name = "parse/parser";
 struct test tests[] = {
 	{ "priv", test_priv },
@@ -605,6 +660,8 @@ struct test tests[] = {
 	{ "char2", test_char2 },
 
 	{ "baddir", test_baddir },
+	{ "supersede", test_supersede },
+	{ "many", test_many },
 
 	{ NULL, NULL }
 };
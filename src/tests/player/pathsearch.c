@@ -0,0 +1,201 @@
+/* player/pathsearch */
+/* Check find_path() and path_nearest_known() against full distance arrays. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-path.h"
+#include "z-rand.h"
+#include <time.h>
+
+#define HEIGHT 66
+#define WIDTH 198
+#define SPEED_PATHS 200
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	Rand_init();
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	if (player->cave) {
+		cave_free(player->cave);
+		player->cave = NULL;
+	}
+	cleanup_angband();
+	return 0;
+}
+
+/*
+ * Fill the player's memory with a permanent edge and a random mix of floor,
+ * granite and, if asked, doors and rubble.
+ */
+static void make_known_map(bool obstacles) {
+	struct loc grid;
+
+	if (player->cave) cave_free(player->cave);
+	player->cave = cave_new(HEIGHT, WIDTH);
+	for (grid.y = 0; grid.y < HEIGHT; grid.y++) {
+		for (grid.x = 0; grid.x < WIDTH; grid.x++) {
+			int roll = randint0(100);
+			int feat = FEAT_FLOOR;
+
+			if (!square_in_bounds_fully(player->cave, grid)) {
+				feat = FEAT_PERM;
+			} else if (roll < 25) {
+				feat = FEAT_GRANITE;
+			} else if (obstacles && roll < 28) {
+				feat = FEAT_CLOSED;
+			} else if (obstacles && roll < 30) {
+				feat = FEAT_RUBBLE;
+			}
+			square_set_feat(player->cave, grid, feat);
+		}
+	}
+}
+
+static struct loc random_floor(void) {
+	struct loc grid;
+
+	do {
+		grid = loc(randint1(WIDTH - 2), randint1(HEIGHT - 2));
+	} while (!square_isfloor(player->cave, grid));
+	return grid;
+}
+
+/* What path_nearest_known() did before:  distances to everything, then scan */
+static int scan_nearest_known(struct loc start,
+		bool (*pred)(struct chunk*, struct loc), struct loc *dest,
+		int16_t **steps) {
+	struct pfdistances *distances = prepare_pfdistances(player, start,
+		true, true);
+	int min_turns = INT_MAX, length = -1;
+	struct loc grid;
+
+	*dest = loc(-1, -1);
+	for (grid.y = 0; grid.y < HEIGHT; grid.y++) {
+		for (grid.x = 0; grid.x < WIDTH; grid.x++) {
+			int turns;
+
+			if (loc_eq(grid, start) || !(*pred)(player->cave, grid)) {
+				continue;
+			}
+			turns = pfdistances_to_turncount(distances, grid);
+			if (turns > 0 && min_turns > turns) {
+				min_turns = turns;
+				*dest = grid;
+			}
+		}
+	}
+	if (min_turns < INT_MAX) {
+		length = pfdistances_to_path(distances, *dest, steps);
+	} else {
+		*steps = NULL;
+	}
+	release_pfdistances(distances);
+	return length;
+}
+
+/* The nearest door is the same one, by the same route, as with a full scan. */
+static int test_nearest_same_as_scan(void *state) {
+	int i;
+
+	make_known_map(true);
+	for (i = 0; i < 50; i++) {
+		struct loc start = random_floor(), fast_dest, slow_dest;
+		int16_t *fast_steps, *slow_steps;
+		int fast = path_nearest_known(player, start, square_iscloseddoor,
+			&fast_dest, &fast_steps);
+		int slow = scan_nearest_known(start, square_iscloseddoor,
+			&slow_dest, &slow_steps);
+
+		eq(fast, slow);
+		require(loc_eq(fast_dest, slow_dest));
+		if (fast > 0) {
+			require(!memcmp(fast_steps, slow_steps,
+				fast * sizeof(*fast_steps)));
+		}
+		mem_free(fast_steps);
+		mem_free(slow_steps);
+	}
+	ok;
+}
+
+/* Over open ground, find_path() takes as few steps as possible. */
+static int test_find_path_shortest(void *state) {
+	int i;
+
+	make_known_map(false);
+	for (i = 0; i < 50; i++) {
+		struct loc start = random_floor(), dest = random_floor(), grid;
+		struct pfdistances *distances = prepare_pfdistances(player,
+			start, true, true);
+		int16_t *steps;
+		int length = find_path(player, start, dest, &steps), j;
+
+		eq(length, pfdistances_to_turncount(distances, dest));
+		release_pfdistances(distances);
+
+		/* Walk it; steps are stored in reverse */
+		grid = start;
+		for (j = length - 1; j >= 0; j--) {
+			grid = loc_sum(grid, ddgrid[steps[j]]);
+			require(square_ispassable(player->cave, grid));
+		}
+		require(loc_eq(grid, dest));
+		mem_free(steps);
+	}
+	ok;
+}
+
+/* Time routes across the level both ways; report it when verbose. */
+static int test_speed(void *state) {
+	struct loc starts[SPEED_PATHS], dests[SPEED_PATHS];
+	clock_t start;
+	double fast, slow;
+	int i;
+
+	make_known_map(true);
+	for (i = 0; i < SPEED_PATHS; i++) {
+		starts[i] = random_floor();
+		dests[i] = random_floor();
+	}
+	start = clock();
+	for (i = 0; i < SPEED_PATHS; i++) {
+		(void) find_path(player, starts[i], dests[i], NULL);
+	}
+	fast = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	for (i = 0; i < SPEED_PATHS; i++) {
+		struct pfdistances *distances = prepare_pfdistances(player,
+			starts[i], true, true);
+
+		(void) pfdistances_to_path(distances, dests[i], NULL);
+		release_pfdistances(distances);
+	}
+	slow = (double) (clock() - start) / CLOCKS_PER_SEC;
+	if (verbose) {
+		printf("    %d paths: %.3f s by find_path, %.3f s by full arrays\n",
+			SPEED_PATHS, fast, slow);
+	}
+	ok;
+}
+
+const char *suite_name = "player/pathsearch";
+struct test tests[] = {
+	{ "nearest same as scan", test_nearest_same_as_scan },
+	{ "find path shortest", test_find_path_shortest },
+	{ "speed", test_speed },
+	{ NULL, NULL }
+};
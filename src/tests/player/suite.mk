@@ -6,6 +6,7 @@ TESTPROGS += player/birth \
              player/inven-carry-num \
              player/inven-wield \
              player/pathfind \
+             player/pathsearch \
              player/playerstat \
              player/pscore \
              player/timed \
@@ -1321,7 +1321,13 @@ static struct chunk TEST_DATA test_cave = {
 	.feeling_squares = 0,
 	.feat_count = NULL,
 
-	.squares = NULL,
+	.sq_feat = NULL,
+	.sq_pred = NULL,
+	.sq_info = NULL,
+	.sq_light = NULL,
+	.sq_mon = NULL,
+	.sq_obj = NULL,
+	.sq_trap = NULL,
 
 	.monsters = NULL,
 	.mon_max = 1,
@@ -1,7 +1,12 @@
 /* z-quark/quark.c */
 
 #include "unit-test.h"
+#include "z-form.h"
 #include "z-quark.h"
+#include "z-virt.h"
+#include <time.h>
+
+#define LARGE_N 100000
 
 int setup_tests(void **state) {
 	quarks_init();
@@ -46,9 +51,62 @@ static int test_dedup(void *state) {
 	ok;
 }
 
+/*
+ * Intern many distinct strings, then look them all up again.  With the
+ * linear scan this was quadratic; report the time taken when verbose.
+ */
+static int test_large(void *state) {
+	quark_t *qs = mem_alloc(LARGE_N * sizeof(*qs));
+	const char *s0;
+	char buf[32];
+	clock_t start = clock();
+	int i;
+
+	for (i = 0; i < LARGE_N; i++) {
+		strnfmt(buf, sizeof(buf), "2-quark-%d", i);
+		qs[i] = quark_add(buf);
+		if (i > 0) {
+			eq(qs[i], qs[i - 1] + 1);
+		}
+	}
+	s0 = quark_str(qs[0]);
+	for (i = 0; i < LARGE_N; i++) {
+		strnfmt(buf, sizeof(buf), "2-quark-%d", i);
+		eq(quark_add(buf), qs[i]);
+		require(streq(quark_str(qs[i]), buf));
+	}
+	/* Earlier strings don't move as the table grows */
+	require(quark_str(qs[0]) == s0);
+	require(quark_str(qs[LARGE_N - 1] + 1) == NULL);
+	if (verbose) {
+		printf("    %d quarks added and found in %.3f s\n", LARGE_N,
+			(double) (clock() - start) / CLOCKS_PER_SEC);
+	}
+	mem_free(qs);
+	ok;
+}
+
+/* Strings longer than a slab still round-trip. */
+static int test_long(void *state) {
+	char *big = mem_alloc(10000);
+	quark_t q1, q2;
+
+	memset(big, 'x', 9999);
+	big[9999] = '\0';
+	q1 = quark_add(big);
+	q2 = quark_add("3-short");
+	require(streq(quark_str(q1), big));
+	require(streq(quark_str(q2), "3-short"));
+	eq(quark_add(big), q1);
+	mem_free(big);
+	ok;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "large", test_large },
+	{ "long", test_long },
 	{ NULL, NULL }
 };
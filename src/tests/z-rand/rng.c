@@ -0,0 +1,88 @@
+/* z-rand/rng.c */
+
+#include "unit-test.h"
+#include "z-rand.h"
+
+NOSETUP
+NOTEARDOWN
+
+/* The same seed gives the same sequence whatever was drawn before. */
+static int test_seed(void *state) {
+	struct rng_state a, b;
+	int i;
+
+	a.quick = false;
+	b.quick = false;
+	Rand_state_init_r(&a, 42);
+	for (i = 0; i < 17; i++) {
+		(void) randint0_r(&a, 100);
+	}
+	Rand_state_init_r(&a, 42);
+	Rand_state_init_r(&b, 42);
+	for (i = 0; i < 1000; i++) {
+		eq(randint0_r(&a, 1000), randint0_r(&b, 1000));
+	}
+	ok;
+}
+
+/* The global functions are the _r ones on the current generator. */
+static int test_wrap(void *state) {
+	struct rng_state copy;
+	random_value v = { 3, 2, 6, 5 };
+	int i;
+
+	Rand_state.quick = false;
+	Rand_state_init(7);
+	copy = Rand_state;
+	for (i = 0; i < 100; i++) {
+		eq(randint0(50), randint0_r(&copy, 50));
+		eq(randint1(50), randint1_r(&copy, 50));
+		eq(damroll(3, 8), damroll_r(&copy, 3, 8));
+		eq(Rand_normal(100, 10), Rand_normal_r(&copy, 100, 10));
+		eq(m_bonus(10, 40), m_bonus_r(&copy, 10, 40));
+		eq(randcalc(v, 20, RANDOMISE),
+			randcalc_r(&copy, v, 20, RANDOMISE));
+		eq(rand_range(-5, 5), rand_range_r(&copy, -5, 5));
+	}
+	ok;
+}
+
+/* A private generator leaves the game's one alone. */
+static int test_private(void *state) {
+	struct rng_state priv, copy, *old;
+	int i;
+
+	Rand_state.quick = false;
+	Rand_state_init(99);
+	copy = Rand_state;
+	priv.quick = false;
+	Rand_state_init_r(&priv, 1234);
+	for (i = 0; i < 100; i++) {
+		(void) damroll_r(&priv, 4, 6);
+	}
+
+	/* Drawing through the global API after a switch uses priv */
+	old = Rand_use(&priv);
+	ptreq(old, &Rand_state);
+	for (i = 0; i < 100; i++) {
+		(void) randint0(10);
+	}
+	Rand_quick = true;
+	Rand_value = 5;
+	(void) randint0(10);
+	ptreq(Rand_use(old), &priv);
+
+	require(!Rand_quick);
+	for (i = 0; i < 100; i++) {
+		eq(randint0(1000), randint0_r(&copy, 1000));
+	}
+	ok;
+}
+
+const char *suite_name = "z-rand/rng";
+struct test tests[] = {
+	{ "seed", test_seed },
+	{ "wrap", test_wrap },
+	{ "private", test_private },
+	{ NULL, NULL }
+};
@@ -141,7 +141,7 @@ void square_free_trap(struct chunk *c, struct loc grid)
 bool square_remove_trap(struct chunk *c, struct loc grid, struct trap *trap,
 		bool memorize)
 {
-	struct trap *cursor = square(c, grid)->trap;
+	struct trap *cursor = square_trap(c, grid);
 	struct trap *prev_trap = NULL;
 	bool removed = false;
 
@@ -158,7 +158,7 @@ bool square_remove_trap(struct chunk *c, struct loc grid, struct trap *trap,
 				square_set_trap(c, grid, next_trap);
 				if (!next_trap) {
 					/* There are no more traps here. */
-					sqinfo_off(square(c, grid)->info,
+					sqinfo_off(square_info(c, grid),
 						SQUARE_TRAP);
 				}
 			}
@@ -183,7 +183,7 @@ bool square_remove_trap(struct chunk *c, struct loc grid, struct trap *trap,
  */
 bool square_remove_all_traps(struct chunk *c, struct loc grid)
 {
-	struct trap *trap = square(c, grid)->trap;
+	struct trap *trap = square_trap(c, grid);
 	struct trap_kind *rune = lookup_trap("glyph of warding");
 	bool were_there_traps = trap == NULL ? false : true;
 
@@ -198,7 +198,7 @@ bool square_remove_all_traps(struct chunk *c, struct loc grid)
 	}
 
 	square_set_trap(c, grid, NULL);
-	sqinfo_off(square(c, grid)->info, SQUARE_TRAP);
+	sqinfo_off(square_info(c, grid), SQUARE_TRAP);
 
 	/* Refresh grids that the character can see */
 	if (square_isseen(c, grid)) {
@@ -221,7 +221,7 @@ bool square_remove_all_traps_of_type(struct chunk *c, struct loc grid,
 
 	/* Look at the traps in this grid */
 	struct trap *prev_trap = NULL;
-	struct trap *trap = square(c, grid)->trap;
+	struct trap *trap = square_trap(c, grid);
 
 	while (trap) {
 		struct trap *next_trap = trap->next;
@@ -235,7 +235,7 @@ bool square_remove_all_traps_of_type(struct chunk *c, struct loc grid,
 			} else {
 				square_set_trap(c, grid, next_trap);
 				if (!next_trap) {
-					sqinfo_off(square(c, grid)->info,
+					sqinfo_off(square_info(c, grid),
 						SQUARE_TRAP);
 				}
 			}
@@ -383,7 +383,7 @@ void place_trap(struct chunk *c, struct loc grid, int t_idx, int trap_level)
 		/* Require the correct terrain */
 		if (!square_player_trap_allowed(c, grid)) return;
 
-		t_idx = pick_trap(c, square(c, grid)->feat, trap_level);
+		t_idx = pick_trap(c, square_fidx(c, grid), trap_level);
 	}
 
 	/* Failure */
@@ -412,7 +412,7 @@ void place_trap(struct chunk *c, struct loc grid, int t_idx, int trap_level)
 	}
 
 	/* Toggle on the trap marker */
-	sqinfo_on(square(c, grid)->info, SQUARE_TRAP);
+	sqinfo_on(square_info(c, grid), SQUARE_TRAP);
 
 	/* Redraw the grid */
 	square_note_spot(c, grid);
@@ -484,13 +484,13 @@ bool square_reveal_trap(struct chunk *c, struct loc grid, bool always,
  */
 void square_memorize_traps(struct chunk *c, struct loc grid)
 {
-	struct trap *trap = square(c, grid)->trap;
+	struct trap *trap = square_trap(c, grid);
 	struct trap *current = NULL;
 	if (c != cave) return;
 
 	/* Clear current knowledge */
 	square_remove_all_traps(player->cave, grid);
-	sqinfo_off(square(player->cave, grid)->info, SQUARE_TRAP);
+	sqinfo_off(square_info(player->cave, grid), SQUARE_TRAP);
 
 	/* Copy all visible traps to the known cave */
 	while (trap) {
@@ -502,15 +502,15 @@ void square_memorize_traps(struct chunk *c, struct loc grid)
 				current = next;
 			} else {
 				current = mem_zalloc(sizeof(*current));
-				player->cave->squares[grid.y][grid.x].trap = current;
+				square_set_trap(player->cave, grid, current);
 			}
 			memcpy(current, trap, sizeof(*trap));
 			current->next = NULL;
 		}
 		trap = trap->next;
 	}
-	if (square(player->cave, grid)->trap) {
-		sqinfo_on(square(player->cave, grid)->info, SQUARE_TRAP);
+	if (square_trap(player->cave, grid)) {
+		sqinfo_on(square_info(player->cave, grid), SQUARE_TRAP);
 	}
 }
 
@@ -636,6 +636,87 @@ extern void hit_trap(struct loc grid, int delayed)
 	}
 }
 
+/**
+ * Note that a grid has a disabled trap, if the chunk's list of such grids is
+ * being kept
+ */
+static void add_trap_timer(struct chunk *c, struct loc grid)
+{
+	int i;
+
+	if (!c->trap_timers) return;
+	for (i = 0; i < c->trap_timer_count; i++) {
+		if (loc_eq(c->trap_timers[i], grid)) return;
+	}
+	if (c->trap_timer_count == c->trap_timer_size) {
+		c->trap_timer_size *= 2;
+		c->trap_timers = mem_realloc(c->trap_timers,
+			c->trap_timer_size * sizeof(*c->trap_timers));
+	}
+	c->trap_timers[c->trap_timer_count++] = grid;
+}
+
+/**
+ * Count down the timers of disabled traps, once every ten game turns.
+ *
+ * Only the grids in the chunk's list of those with a disabled trap are
+ * visited; the list is made by looking over the whole chunk the first time,
+ * and kept up to date by square_set_trap_timeout() after that.
+ */
+void decrease_trap_timeouts(struct chunk *c)
+{
+	int i;
+
+	if (!c->trap_timers) {
+		struct loc grid;
+
+		c->trap_timer_size = 16;
+		c->trap_timers = mem_alloc(c->trap_timer_size
+			* sizeof(*c->trap_timers));
+		c->trap_timer_count = 0;
+		for (grid.y = 0; grid.y < c->height; grid.y++) {
+			for (grid.x = 0; grid.x < c->width; grid.x++) {
+				struct trap *trap = square_trap(c, grid);
+
+				while (trap && !trap->timeout) {
+					trap = trap->next;
+				}
+				if (trap) add_trap_timer(c, grid);
+			}
+		}
+	}
+
+	i = 0;
+	while (i < c->trap_timer_count) {
+		struct loc grid = c->trap_timers[i];
+		struct trap *trap = square_trap(c, grid);
+		bool changed = false, running = false;
+
+		while (trap) {
+			if (trap->timeout) {
+				trap->timeout--;
+				if (!trap->timeout) {
+					changed = true;
+				} else {
+					running = true;
+				}
+			}
+			trap = trap->next;
+		}
+		if (changed && square_isseen(c, grid)) {
+			square_memorize_traps(c, grid);
+			square_light_spot(c, grid);
+		}
+
+		/* Drop grids with nothing left to count down */
+		if (running) {
+			i++;
+		} else {
+			c->trap_timers[i] = c->trap_timers[--c->trap_timer_count];
+		}
+	}
+}
+
 /**
  * Disable traps for the specified number of turns in the given location
  *
@@ -658,7 +739,7 @@ bool square_set_trap_timeout(struct chunk *c, struct loc grid, bool domsg,
 	assert(square_in_bounds(c, grid));
 
 	/* Look at the traps in this grid */
-	current_trap = square(c, grid)->trap;
+	current_trap = square_trap(c, grid);
 	while (current_trap) {
 		/* Get the next trap (may be NULL) */
 		struct trap *next_trap = current_trap->next;
@@ -673,6 +754,9 @@ bool square_set_trap_timeout(struct chunk *c, struct loc grid, bool domsg,
 		/* Set the timer */
 		current_trap->timeout = time;
 		disabled = true;
+		if (time > 0) {
+			add_trap_timer(c, grid);
+		}
 
 		/* Message if requested */
 		if (domsg) {
@@ -699,7 +783,7 @@ bool square_set_trap_timeout(struct chunk *c, struct loc grid, bool domsg,
  */
 int square_trap_timeout(struct chunk *c, struct loc grid, int t_idx)
 {
-	struct trap *current_trap = square(c, grid)->trap;
+	struct trap *current_trap = square_trap(c, grid);
 	while (current_trap) {
 		/* Get the next trap (may be NULL) */
 		struct trap *next_trap = current_trap->next;
@@ -112,6 +112,7 @@ bool square_remove_all_traps_of_type(struct chunk *c, struct loc grid,
 bool square_set_trap_timeout(struct chunk *c, struct loc grid, bool domsg,
 							 int t_idx, int time);
 int square_trap_timeout(struct chunk *c, struct loc grid, int t_idx);
+void decrease_trap_timeouts(struct chunk *c);
 void square_set_door_lock(struct chunk *c, struct loc grid, int power);
 int square_door_power(struct chunk *c, struct loc grid);
 void monster_hit_trap(struct monster *mon, struct loc grid, bool *death);
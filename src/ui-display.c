@@ -1368,59 +1368,16 @@ static void update_maps(game_event_type type, game_event_data *data, void *user)
 
 	/* This signals a whole-map redraw. */
 	if (data->point.x == -1 && data->point.y == -1)
-		prt_map();
+		map_damage_all(t);
 
-	/* Single point to be redrawn */
-	else {
-		struct grid_data g;
-		int a, ta;
-		wchar_t c, tc;
-
-		int ky, kx;
-		int vy, vx;
-		int clipy;
-
-		/* Location relative to panel */
-		ky = data->point.y - t->offset_y;
-		kx = data->point.x - t->offset_x;
-
-		if (t == angband_term[0]) {
-			/* Verify location */
-			if ((ky < 0) || (ky >= SCREEN_HGT)) return;
-			if ((kx < 0) || (kx >= SCREEN_WID)) return;
-
-			/* Location in window */
-			vy = tile_height * ky + ROW_MAP;
-			vx = tile_width * kx + COL_MAP;
-
-			/* Protect the status line against modification. */
-			clipy = ROW_MAP + SCREEN_ROWS;
-		} else {
-			/* Verify location */
-			if ((ky < 0) || (ky >= t->hgt / tile_height)) return;
-			if ((kx < 0) || (kx >= t->wid / tile_width)) return;
-
-			/* Location in window */
-			vy = tile_height * ky;
-			vx = tile_width * kx;
-
-			/* All the rows may be used for the map. */
-			clipy = t->hgt;
-		}
+	/* Single point to be redrawn, if it is in view */
+	else if (!map_damage_grid(t, data->point))
+		return;
 
+	/* Subwindows catch up when they are flushed */
+	if (t != angband_term[0]) return;
 
-		/* Redraw the grid spot */
-		map_info(data->point, &g);
-		grid_data_as_text(&g, &a, &c, &ta, &tc);
-		Term_queue_char(t, vx, vy, a, c, ta, tc);
-#ifdef MAP_DEBUG
-		/* Plot 'spot' updates in light green to make them visible */
-		Term_queue_char(t, vx, vy, COLOUR_L_GREEN, c, ta, tc);
-#endif
-
-		if ((tile_width > 1) || (tile_height > 1))
-			Term_big_queue_char(t, vx, vy, clipy, a, c, COLOUR_WHITE, L' ');
-	}
+	map_redraw_damage(t);
 
 	/* Refresh the main screen unless the map needs to center */
 	if (player->upkeep->update & (PU_PANEL) && OPT(player, center_player)) {
@@ -1482,7 +1439,10 @@ static void do_animation(void)
 			continue;
 
 		mon->attr = attr;
-		player->upkeep->redraw |= (PR_MAP | PR_MONLIST);
+
+		/* Only the monster's own grid needs redrawing */
+		event_signal_point(EVENT_MAP, mon->grid.x, mon->grid.y);
+		player->upkeep->redraw |= (PR_MONLIST);
 	}
 
 	flicker++;
@@ -2154,6 +2114,15 @@ static void flush_subwindow(game_event_type type, game_event_data *data,
 	Term_activate(old);
 }
 
+static void flush_map_subwindow(game_event_type type, game_event_data *data,
+							void *user)
+{
+	/* Draw the grids which changed since the last flush */
+	map_redraw_damage(user);
+
+	flush_subwindow(type, data, user);
+}
+
 /**
  * Certain "screens" always use the main screen, including News, Birth,
  * Dungeon, Tomb-stone, High-scores, Macros, Colors, Visuals, Options.
@@ -2308,7 +2277,7 @@ static void subwindow_flag_changed(int win_idx, uint32_t flag, bool new_state)
 					       angband_term[win_idx]);
 
 			register_or_deregister(EVENT_END,
-					       flush_subwindow,
+					       flush_map_subwindow,
 					       angband_term[win_idx]);
 			break;
 		}
@@ -2565,7 +2534,7 @@ static void new_level_display_update(game_event_type type,
 
 	/* If autosave is pending, do it now. */
 	if (player->upkeep->autosave) {
-		save_game();
+		autosave_game();
 		player->upkeep->autosave = false;
 	}
 
@@ -2596,6 +2565,16 @@ static void cheat_death(game_event_type type, game_event_data *data, void *user)
 	wiz_cheat_death();
 }
 
+static void save_done(game_event_type type, game_event_data *data, void *user)
+{
+	if (data->flag) {
+		prt("Saving game... done.", 0, 0);
+	} else {
+		msg("Saving game failed!");
+		event_signal(EVENT_MESSAGE_FLUSH);
+	}
+}
+
 static void check_panel(game_event_type type, game_event_data *data, void *user)
 {
 	verify_panel();
@@ -2806,6 +2785,9 @@ static void ui_enter_world(game_event_type type, game_event_data *data,
 	/* Allow the player to cheat death, if appropriate */
 	event_add_handler(EVENT_CHEAT_DEATH, cheat_death, NULL);
 
+	/* Report on saves finished in the background */
+	event_add_handler(EVENT_SAVE_DONE, save_done, NULL);
+
 	/* Decrease "icky" depth */
 	screen_save_depth--;
 }
@@ -2870,6 +2852,7 @@ static void ui_leave_world(game_event_type type, game_event_data *data,
 
 	/* Allow the player to cheat death, if appropriate */
 	event_remove_handler(EVENT_CHEAT_DEATH, cheat_death, NULL);
+	event_remove_handler(EVENT_SAVE_DONE, save_done, NULL);
 
 	/* Prepare to interact with a store */
 	event_add_handler(EVENT_USE_STORE, use_store, NULL);
@@ -1034,6 +1034,26 @@ void save_game(void)
 	signals_protect(false);
 }
 
+/**
+ * Save the game without waiting for the savefile to be written out; the
+ * EVENT_SAVE_DONE handler reports whether it worked.
+ */
+void autosave_game(void)
+{
+	signals_protect(true);
+	disturb(player);
+	event_signal(EVENT_MESSAGE_FLUSH);
+	handle_stuff(player);
+	prt("Saving game...", 0, 0);
+	Term_fresh();
+
+	/* The savefile is encoded straight away, so only needs this briefly */
+	my_strcpy(player->died_from, "(saved)", sizeof(player->died_from));
+	(void)savefile_save_background(savefile);
+	my_strcpy(player->died_from, "(alive and well)", sizeof(player->died_from));
+	signals_protect(false);
+}
+
 /**
  * Save the game.
  *
@@ -73,6 +73,7 @@ void savefile_set_name(const char *fname, bool make_safe, bool strip_suffix);
 bool savefile_name_already_used(const char *fname, bool make_safe,
 	bool strip_suffix);
 void save_game(void);
+void autosave_game(void);
 bool save_game_checked(void);
 void close_game(bool prompt_failed_save);
 
@@ -24,6 +24,7 @@
 #include "effects-info.h"
 #include "game-input.h"
 #include "game-world.h"
+#include "generate.h"
 #include "grafmode.h"
 #include "init.h"
 #include "mon-init.h"
@@ -1591,6 +1592,7 @@ static struct object *find_artifact(struct artifact *artifact)
 		struct chunk *c = chunk_list[i];
 		int j;
 		if (strstr(c->name, "known")) continue;
+		chunk_expand(c);
 
 		/* Ground objects */
 		for (y = 1; y < c->height; y++) {
@@ -620,8 +620,98 @@ void print_rel(wchar_t c, uint8_t a, int y, int x)
 }
 
 
-static void prt_map_aux(void)
+/**
+ * Grids which have changed since a map window was last drawn, in cave
+ * coordinates, or a note that the whole window needs drawing
+ */
+struct map_damage {
+	struct loc *grids;
+	int count, size;
+	bool all;
+};
+
+static struct map_damage map_damage[ANGBAND_TERM_MAX];
+
+/**
+ * Get the index of a map window, or -1 if it isn't one
+ */
+static int map_term_index(const term *t)
 {
+	int j;
+
+	for (j = 0; j < ANGBAND_TERM_MAX; j++) {
+		if (angband_term[j] == t) return j;
+	}
+	return -1;
+}
+
+/**
+ * Find where a grid is drawn in a map window; return false if it isn't shown
+ */
+static bool map_grid_to_window(const term *t, struct loc grid, int *vy,
+		int *vx, int *clipy)
+{
+	/* Location relative to panel */
+	int ky = grid.y - t->offset_y;
+	int kx = grid.x - t->offset_x;
+
+	if (t == angband_term[0]) {
+		/* Verify location */
+		if ((ky < 0) || (ky >= SCREEN_HGT)) return false;
+		if ((kx < 0) || (kx >= SCREEN_WID)) return false;
+
+		/* Location in window */
+		*vy = tile_height * ky + ROW_MAP;
+		*vx = tile_width * kx + COL_MAP;
+
+		/* Protect the status line against modification. */
+		*clipy = ROW_MAP + SCREEN_ROWS;
+	} else {
+		/* Verify location */
+		if ((ky < 0) || (ky >= t->hgt / tile_height)) return false;
+		if ((kx < 0) || (kx >= t->wid / tile_width)) return false;
+
+		/* Location in window */
+		*vy = tile_height * ky;
+		*vx = tile_width * kx;
+
+		/* All the rows may be used for the map. */
+		*clipy = t->hgt;
+	}
+	return true;
+}
+
+/**
+ * Redraw a single grid in a map window
+ */
+static void map_draw_grid(term *t, struct loc grid)
+{
+	struct grid_data g;
+	int a, ta;
+	wchar_t c, tc;
+	int vy, vx, clipy;
+
+	if (!map_grid_to_window(t, grid, &vy, &vx, &clipy)) return;
+
+	/* Redraw the grid spot */
+	map_info(grid, &g);
+	grid_data_as_text(&g, &a, &c, &ta, &tc);
+	Term_queue_char(t, vx, vy, a, c, ta, tc);
+#ifdef MAP_DEBUG
+	/* Plot 'spot' updates in light green to make them visible */
+	Term_queue_char(t, vx, vy, COLOUR_L_GREEN, c, ta, tc);
+#endif
+
+	if ((tile_width > 1) || (tile_height > 1))
+		Term_big_queue_char(t, vx, vy, clipy, a, c, COLOUR_WHITE, L' ');
+}
+
+/**
+ * Redraw the whole of a map subwindow
+ */
+static void prt_map_window(int j)
+{
+	term *t = angband_term[j];
 	int a, ta;
 	wchar_t c, tc;
 	struct grid_data g;
@@ -629,89 +719,70 @@ static void prt_map_aux(void)
 	int y, x;
 	int vy, vx;
 	int ty, tx;
+	int clipy;
 
-	int j;
-
-	/* Scan windows */
-	for (j = 0; j < ANGBAND_TERM_MAX; j++) {
-		term *t = angband_term[j];
-		int clipy;
-
-		/* No window */
-		if (!t) continue;
-
-		/* No relevant flags */
-		if (!(window_flag[j] & (PW_MAPS))) continue;
+	if (window_flag[j] & PW_MAP) {
+		term *old = Term;
 
-		if (window_flag[j] & PW_MAP) {
-			term *old = Term;
+		Term_activate(t);
+		display_map(NULL, NULL);
+		Term_activate(old);
+		return;
+	}
 
-			Term_activate(t);
-			display_map(NULL, NULL);
-			Term_activate(old);
-			continue;
-		}
+	/* Assume screen */
+	ty = t->offset_y + (t->hgt / tile_height);
+	tx = t->offset_x + (t->wid / tile_width);
 
-		/* Assume screen */
-		ty = t->offset_y + (t->hgt / tile_height);
-		tx = t->offset_x + (t->wid / tile_width);
+	/*
+	 * The overhead view can use the last row of the terminal.
+	 * Others can not.
+	 */
+	clipy = t->hgt - ((window_flag[j] & PW_OVERHEAD) ? 0 : ROW_BOTTOM_MAP);
 
-		/*
-		 * The overhead view can use the last row of the terminal.
-		 * Others can not.
-		 */
-		clipy = t->hgt - ((window_flag[j] & PW_OVERHEAD) ? 0 : ROW_BOTTOM_MAP);
-
-		/* Dump the map */
-		for (y = t->offset_y, vy = 0; y < ty; vy += tile_height, y++) {
-			for (x = t->offset_x, vx = 0; x < tx; vx += tile_width, x++) {
-				/* Check bounds */
-				if (!square_in_bounds(cave, loc(x, y))) {
-					Term_queue_char(t, vx, vy,
-						COLOUR_WHITE, ' ',
-						0, 0);
-					if (tile_width > 1 || tile_height > 1) {
-						Term_big_queue_char(t, vx, vy,
-							clipy, COLOUR_WHITE, ' ', 0, 0);
-					}
-					continue;
+	/* Dump the map */
+	for (y = t->offset_y, vy = 0; y < ty; vy += tile_height, y++) {
+		for (x = t->offset_x, vx = 0; x < tx; vx += tile_width, x++) {
+			/* Check bounds */
+			if (!square_in_bounds(cave, loc(x, y))) {
+				Term_queue_char(t, vx, vy,
+					COLOUR_WHITE, ' ',
+					0, 0);
+				if (tile_width > 1 || tile_height > 1) {
+					Term_big_queue_char(t, vx, vy,
+						clipy, COLOUR_WHITE, ' ', 0, 0);
 				}
+				continue;
+			}
 
-				/* Determine what is there */
-				map_info(loc(x, y), &g);
-				grid_data_as_text(&g, &a, &c, &ta, &tc);
-				Term_queue_char(t, vx, vy, a, c, ta, tc);
+			/* Determine what is there */
+			map_info(loc(x, y), &g);
+			grid_data_as_text(&g, &a, &c, &ta, &tc);
+			Term_queue_char(t, vx, vy, a, c, ta, tc);
 
-				if ((tile_width > 1) || (tile_height > 1))
-					Term_big_queue_char(t, vx, vy, clipy,
-						255, -1, 0, 0);
-			}
-			/* Clear partial tile at the end of each line. */
-			for (; vx < t->wid; ++vx) {
-				Term_queue_char(t, vx, vy, COLOUR_WHITE,
-					' ', 0, 0);
-			}
+			if ((tile_width > 1) || (tile_height > 1))
+				Term_big_queue_char(t, vx, vy, clipy,
+					255, -1, 0, 0);
 		}
-		/* Clear row of partial tiles at the bottom. */
-		for (; vy < t->hgt; ++vy) {
-			for (vx = 0; vx < t->wid; ++vx) {
-				Term_queue_char(t, vx, vy, COLOUR_WHITE,
-					' ', 0, 0);
-			}
+		/* Clear partial tile at the end of each line. */
+		for (; vx < t->wid; ++vx) {
+			Term_queue_char(t, vx, vy, COLOUR_WHITE,
+				' ', 0, 0);
+		}
+	}
+	/* Clear row of partial tiles at the bottom. */
+	for (; vy < t->hgt; ++vy) {
+		for (vx = 0; vx < t->wid; ++vx) {
+			Term_queue_char(t, vx, vy, COLOUR_WHITE,
+				' ', 0, 0);
 		}
 	}
 }
 
-
-
 /**
- * Redraw (on the screen) the current map panel
- *
- * Note the inline use of "light_spot()" for efficiency.
- *
- * The main screen will always be at least 24x80 in size.
+ * Redraw the whole of the map on the main screen
  */
-void prt_map(void)
+static void prt_map_main(void)
 {
 	int a, ta;
 	wchar_t c, tc;
@@ -722,9 +793,6 @@ void prt_map(void)
 	int ty, tx;
 	int clipy;
 
-	/* Redraw map sub-windows */
-	prt_map_aux();
-
 	/* Assume screen */
 	ty = Term->offset_y + SCREEN_HGT;
 	tx = Term->offset_x + SCREEN_WID;
@@ -751,6 +819,141 @@ void prt_map(void)
 		}
 }
 
+/**
+ * Forget a map window's pending changes
+ */
+static void map_damage_clear(int j)
+{
+	map_damage[j].count = 0;
+	map_damage[j].all = false;
+}
+
+/**
+ * Note that a grid shown in a map window has changed
+ *
+ * \param t is the window
+ * \param grid is the grid, in cave coordinates
+ * \return whether the grid is shown in the window, so needs redrawing
+ */
+bool map_damage_grid(term *t, struct loc grid)
+{
+	int j = map_term_index(t), vy, vx, clipy, cells;
+	struct map_damage *damage;
+
+	if (j < 0 || !map_grid_to_window(t, grid, &vy, &vx, &clipy)) {
+		return false;
+	}
+	damage = &map_damage[j];
+	if (damage->all) return true;
+
+	/* Past one note per grid shown, redrawing everything is cheaper */
+	if (j == 0) {
+		cells = SCREEN_HGT * SCREEN_WID;
+	} else {
+		cells = (t->hgt / tile_height) * (t->wid / tile_width);
+	}
+	if (damage->count >= cells) {
+		damage->all = true;
+		return true;
+	}
+
+	if (damage->count == damage->size) {
+		damage->size = damage->size ? 2 * damage->size : 64;
+		damage->grids = mem_realloc(damage->grids,
+			damage->size * sizeof(*damage->grids));
+	}
+	damage->grids[damage->count++] = grid;
+	return true;
+}
+
+/**
+ * Note that everything in a map window has to be redrawn
+ */
+void map_damage_all(term *t)
+{
+	int j = map_term_index(t);
+
+	if (j < 0) return;
+	map_damage[j].count = 0;
+	map_damage[j].all = true;
+}
+
+/**
+ * Redraw what has changed in a map window since it was last drawn; the
+ * window still has to be refreshed afterwards
+ */
+void map_redraw_damage(term *t)
+{
+	int j = map_term_index(t), i;
+	struct map_damage *damage;
+
+	if (j < 0) return;
+	section_start(TIMED_PRT_MAP);
+	damage = &map_damage[j];
+	if (damage->all) {
+		if (j == 0) {
+			term *old = Term;
+
+			Term_activate(t);
+			prt_map_main();
+			Term_activate(old);
+		} else {
+			prt_map_window(j);
+		}
+	} else {
+		for (i = 0; i < damage->count; i++) {
+			map_draw_grid(t, damage->grids[i]);
+		}
+	}
+	map_damage_clear(j);
+	section_stop(TIMED_PRT_MAP);
+}
+
+/**
+ * Free the lists of changed grids
+ */
+void map_damage_free(void)
+{
+	int j;
+
+	for (j = 0; j < ANGBAND_TERM_MAX; j++) {
+		mem_free(map_damage[j].grids);
+		map_damage[j].grids = NULL;
+		map_damage[j].size = 0;
+		map_damage_clear(j);
+	}
+}
+
+/**
+ * Redraw (on the screen) the current map panel, and every map subwindow
+ *
+ * Note the inline use of "light_spot()" for efficiency.
+ *
+ * The main screen will always be at least 24x80 in size.
+ */
+void prt_map(void)
+{
+	int j;
+
+	section_start(TIMED_PRT_MAP);
+
+	/* Redraw map sub-windows */
+	for (j = 1; j < ANGBAND_TERM_MAX; j++) {
+		/* No window */
+		if (!angband_term[j]) continue;
+
+		/* No relevant flags */
+		if (!(window_flag[j] & (PW_MAPS))) continue;
+
+		prt_map_window(j);
+		map_damage_clear(j);
+	}
+
+	prt_map_main();
+	map_damage_clear(0);
+	section_stop(TIMED_PRT_MAP);
+}
+
 /**
  * Display a "small-scale" map of the dungeon in the active Term.
  *
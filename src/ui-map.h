@@ -20,6 +20,10 @@ extern void grid_data_as_text(struct grid_data *g, int *ap, wchar_t *cp,
 							  int *tap, wchar_t *tcp);
 extern void move_cursor_relative(int y, int x);
 extern void print_rel(wchar_t c, uint8_t a, int y, int x);
+extern bool map_damage_grid(term *t, struct loc grid);
+extern void map_damage_all(term *t);
+extern void map_redraw_damage(term *t);
+extern void map_damage_free(void);
 extern void prt_map(void);
 extern void display_map(int *cy, int *cx);
 extern void do_cmd_view_map(void);
@@ -444,7 +444,7 @@ static bool aux_reinit(struct chunk *c, struct player *p,
 	/* Assume boring. */
 	auxst->boring = true;
 
-	if (square(c, auxst->grid)->mon < 0) {
+	if (square_midx(c, auxst->grid) < 0) {
 		/* Looking at the player's grid */
 		auxst->phrase1 = "You are ";
 		auxst->phrase2 = "on ";
@@ -522,7 +522,7 @@ static bool aux_monster(struct chunk *c, struct player *p,
 	char out_val[TARGET_OUT_VAL_SIZE];
 	bool recall;
 
-	if (square(c, auxst->grid)->mon <= 0) return false;
+	if (square_midx(c, auxst->grid) <= 0) return false;
 
 	mon = square_monster(c, auxst->grid);
 	if (!monster_is_obvious(mon)) return false;
@@ -553,7 +553,7 @@ static bool aux_monster(struct chunk *c, struct player *p,
 
 			/* Describe the monster */
 			look_mon_desc(buf, sizeof(buf),
-				square(c, auxst->grid)->mon);
+				square_midx(c, auxst->grid));
 
 			/* Describe, and prompt for recall */
 			if (p->wizard) {
@@ -703,7 +703,7 @@ static bool aux_trap(struct chunk *c, struct player *p,
 	if (!square_isvisibletrap(p->cave, auxst->grid)) return false;
 
 	/* A trap */
-	trap = square(p->cave, auxst->grid)->trap;
+	trap = square_trap(p->cave, auxst->grid);
 
 	/* Not boring */
 	auxst->boring = false;
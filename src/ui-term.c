@@ -1709,7 +1709,7 @@ bool smlcurs = true;
  * Currently, the use of "Term->icky_corner" and "Term->soft_cursor"
  * together may result in undefined behavior.
  */
-errr Term_fresh(void)
+static errr Term_fresh_aux(void)
 {
 	int x, y;
 
@@ -1984,6 +1984,16 @@ errr Term_fresh(void)
 	return (0);
 }
 
+errr Term_fresh(void)
+{
+	errr result;
+
+	section_start(TIMED_TERM_FRESH);
+	result = Term_fresh_aux();
+	section_stop(TIMED_TERM_FRESH);
+	return result;
+}
+
 
 
 /**
@@ -3868,7 +3868,7 @@ void disconnect_stats(int nsim, bool stop_on_disconnect)
 			}
 		}
 
-		if ((return_path != -1 && square(cave, player->grid)->feat != return_path)
+		if ((return_path != -1 && square_fidx(cave, player->grid) != return_path)
 				|| (return_path == -1
 				&& !square_ispassable(cave, player->grid))) {
 			has_bad_start = true;
@@ -1134,6 +1134,30 @@ bool file_write(ang_file *f, const char *buf, size_t n)
 	return fwrite(buf, 1, n, f->fh) == n;
 }
 
+/**
+ * Append 'n' bytes of array 'buf' to file 'f', bypassing its stdio buffer.
+ */
+bool file_write_unbuffered(ang_file *f, const char *buf, size_t n)
+{
+#ifdef UNIX
+	int fd = fileno(f->fh);
+
+	while (n > 0) {
+		ssize_t done = write(fd, buf, n);
+
+		if (done < 0) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+		buf += done;
+		n -= done;
+	}
+	return true;
+#else
+	return file_write(f, buf, n);
+#endif
+}
+
 /** Line-based IO **/
 
 /**
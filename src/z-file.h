@@ -268,6 +268,13 @@ int file_read(ang_file *f, char *buf, size_t n);
  */
 bool file_write(ang_file *f, const char *buf, size_t n);
 
+/**
+ * As file_write(), but straight to the underlying file descriptor where
+ * there is one, so nothing is allocated or locked; for use in a forked
+ * child.  Do not mix with buffered writes to `f`.
+ */
+bool file_write_unbuffered(ang_file *f, const char *buf, size_t n);
+
 /**
  * Read a byte from the file represented by `f` and place it at the location
  * specified by 'b'.
@@ -22,20 +22,111 @@
 #include "z-quark.h"
 #include "init.h"
 
+/**
+ * The strings themselves are packed into slabs which are never moved or
+ * resized once allocated, so the pointers handed out by quark_str() stay
+ * valid until quarks_free().  Strings too long for a normal slab get a slab
+ * of their own.
+ */
+struct quark_slab {
+	struct quark_slab *next;
+	size_t used;
+	size_t size;
+	char text[];
+};
+
+static struct quark_slab *slabs;
 static char **quarks;
 static size_t nr_quarks = 1;
 static size_t alloc_quarks = 0;
 
+/**
+ * Open addressing hash table of quark indices, keyed by djb2_hash() of the
+ * string.  Zero marks an empty bucket (quark 0 is never handed out).  The
+ * table size is always a power of two and kept at most half full.
+ */
+static quark_t *quark_table;
+static size_t quark_table_size = 0;
+
 #define QUARKS_INIT	16
+#define QUARK_TABLE_INIT	64
+#define QUARK_SLAB_SIZE	4096
 
-quark_t quark_add(const char *str)
+/**
+ * Copy a string into the slab arena, returning the stable copy.
+ */
+static char *quark_slab_copy(const char *str, size_t len)
+{
+	struct quark_slab *slab = slabs;
+	char *copy;
+
+	if (!slab || slab->size - slab->used < len + 1) {
+		size_t size = MAX(len + 1, (size_t) QUARK_SLAB_SIZE);
+
+		slab = mem_alloc(sizeof(*slab) + size);
+		slab->used = 0;
+		slab->size = size;
+		if (slabs && size > QUARK_SLAB_SIZE) {
+			/* Keep filling the current slab after an oversized one */
+			slab->next = slabs->next;
+			slabs->next = slab;
+		} else {
+			slab->next = slabs;
+			slabs = slab;
+		}
+	}
+
+	copy = slab->text + slab->used;
+	memcpy(copy, str, len + 1);
+	slab->used += len + 1;
+	return copy;
+}
+
+/**
+ * Find the bucket holding the given string, or the empty bucket where it
+ * would go.
+ */
+static size_t quark_find_bucket(const char *str, uint32_t hash)
 {
+	size_t mask = quark_table_size - 1;
+	size_t i = hash & mask;
+
+	while (quark_table[i] && !streq(quarks[quark_table[i]], str)) {
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/**
+ * Double the size of the hash table, reinserting every quark.
+ */
+static void quark_table_grow(void)
+{
+	size_t mask;
 	quark_t q;
 
+	mem_free(quark_table);
+	quark_table_size *= 2;
+	quark_table = mem_zalloc(quark_table_size * sizeof(*quark_table));
+	mask = quark_table_size - 1;
 	for (q = 1; q < nr_quarks; q++) {
-		if (streq(quarks[q], str))
-			return q;
+		size_t i = djb2_hash(quarks[q]) & mask;
+
+		while (quark_table[i]) {
+			i = (i + 1) & mask;
+		}
+		quark_table[i] = q;
 	}
+}
+
+quark_t quark_add(const char *str)
+{
+	uint32_t hash = djb2_hash(str);
+	size_t bucket = quark_find_bucket(str, hash);
+	quark_t q;
+
+	if (quark_table[bucket])
+		return quark_table[bucket];
 
 	if (nr_quarks == alloc_quarks) {
 		alloc_quarks *= 2;
@@ -43,7 +134,13 @@ quark_t quark_add(const char *str)
 	}
 
 	q = nr_quarks++;
-	quarks[q] = string_make(str);
+	quarks[q] = quark_slab_copy(str, strlen(str));
+
+	if (2 * nr_quarks > quark_table_size) {
+		quark_table_grow();
+	} else {
+		quark_table[bucket] = q;
+	}
 
 	return q;
 }
@@ -58,17 +155,27 @@ void quarks_init(void)
 	nr_quarks = 1;
 	alloc_quarks = QUARKS_INIT;
 	quarks = mem_zalloc(alloc_quarks * sizeof(char*));
+	quark_table_size = QUARK_TABLE_INIT;
+	quark_table = mem_zalloc(quark_table_size * sizeof(*quark_table));
+	slabs = NULL;
 }
 
 void quarks_free(void)
 {
-	size_t i;
+	while (slabs) {
+		struct quark_slab *next = slabs->next;
 
-	/* quarks[0] is special */
-	for (i = 1; i < nr_quarks; i++)
-		string_free(quarks[i]);
+		mem_free(slabs);
+		slabs = next;
+	}
 
+	mem_free(quark_table);
+	quark_table = NULL;
+	quark_table_size = 0;
 	mem_free(quarks);
+	quarks = NULL;
+	nr_quarks = 1;
+	alloc_quarks = 0;
 }
 
 struct init_module z_quark_module = {
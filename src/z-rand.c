@@ -36,6 +36,12 @@
  * "Rand_value = seed". After that it will be automatically used instead of
  * the "complex" RNG. When you are done, you can de-activate it via
  * "Rand_quick = false". You can also choose a new seed.
+ *
+ * All of that state lives in a struct rng_state.  The usual functions work
+ * on Rand_current, which is the game's generator, Rand_state, unless
+ * something has switched to another with Rand_use().  The _r variants take
+ * the generator as an argument and touch no other state, so independent
+ * generators can be used side by side.
  */
 
 /* begin WELL RNG
@@ -53,11 +59,8 @@
 #define MAT0NEG(t, v) (v ^ (v << (-(t))))
 #define Identity(v) (v)
 
-uint32_t state_i = 0;
-uint32_t STATE[RAND_DEG] = {0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0};
+#define STATE rng->state
+#define state_i rng->state_i
 
 #define V0    STATE[state_i]
 #define VM1   STATE[(state_i + M1) & 0x0000001fU]
@@ -67,7 +70,7 @@ uint32_t STATE[RAND_DEG] = {0, 0, 0, 0, 0, 0, 0, 0,
 #define newV0 STATE[(state_i + 31) & 0x0000001fU]
 #define newV1 STATE[state_i]
 
-static uint32_t WELLRNG1024a (void){
+static uint32_t WELLRNG1024a (struct rng_state *rng){
 	uint32_t z0 = VRm1;
 	uint32_t z1 = Identity(V0) ^ MAT0POS (8, VM1);
 	uint32_t z2 = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
@@ -77,6 +80,9 @@ static uint32_t WELLRNG1024a (void){
 	state_i = (state_i + 31) & 0x0000001fU;
 	return STATE[state_i];
 }
+
+#undef STATE
+#undef state_i
 /* end WELL RNG */
 
 /**
@@ -86,45 +92,67 @@ static uint32_t WELLRNG1024a (void){
 
 
 /**
- * Whether to use the simple RNG or not.
+ * The game's generator; starts out using the simple RNG.
  */
-bool Rand_quick = true;
+struct rng_state Rand_state = { true, 0, 0, { 0 } };
 
 /**
- * The current "seed" of the simple RNG.
+ * The generator used by the functions which don't take one.
  */
-uint32_t Rand_value;
+struct rng_state *Rand_current = &Rand_state;
 
 static bool rand_fixed = false;
 static uint32_t rand_fixval = 0;
 
+/**
+ * Switch the generator used by the functions which don't take one.
+ *
+ * \param rng is the generator to use from now on.
+ * \return the generator that was in use, so the caller can restore it.
+ */
+struct rng_state *Rand_use(struct rng_state *rng)
+{
+	struct rng_state *old = Rand_current;
+
+	Rand_current = rng;
+	return old;
+}
+
 /**
  * Initialize the complex RNG using a new seed.
  */
-void Rand_state_init(uint32_t seed)
+void Rand_state_init_r(struct rng_state *rng, uint32_t seed)
 {
 	int i, j;
 
 	/* Seed the table */
-	STATE[0] = seed;
+	rng->state[0] = seed;
 
 	/* Propagate the seed */
 	for (i = 1; i < RAND_DEG; i++)
-		STATE[i] = LCRNG(STATE[i - 1]);
+		rng->state[i] = LCRNG(rng->state[i - 1]);
+
+	/* Start from a fixed index so a seed always gives the same sequence */
+	rng->state_i = 0;
 
 	/* Cycle the table ten times per degree */
 	for (i = 0; i < RAND_DEG * 10; i++) {
 		/* Acquire the next index */
-		j = (state_i + 1) % RAND_DEG;
+		j = (rng->state_i + 1) % RAND_DEG;
 
 		/* Update the table, extract an entry */
-		STATE[j] += STATE[state_i];
+		rng->state[j] += rng->state[rng->state_i];
 
 		/* Advance the index */
-		state_i = j;
+		rng->state_i = j;
 	}
 }
 
+void Rand_state_init(uint32_t seed)
+{
+	Rand_state_init_r(Rand_current, seed);
+}
+
 /**
  * Initialise the RNG
  */
@@ -165,7 +193,7 @@ void Rand_init(void)
  * This method has no bias, and is much less affected by patterns in the "low"
  * bits of the underlying RNG's. However, it is potentially non-terminating.
  */
-uint32_t Rand_div(uint32_t m)
+uint32_t Rand_div_r(struct rng_state *rng, uint32_t m)
 {
 	uint32_t n, r = 0;
 
@@ -181,12 +209,12 @@ uint32_t Rand_div(uint32_t m)
 	/* Partition size */
 	n = (0x10000000 / m);
 
-	if (Rand_quick) {
+	if (rng->quick) {
 		/* Use a simple RNG */
 		/* Wait for it */
 		while (1) {
 			/* Cycle the generator */
-			r = (Rand_value = LCRNG(Rand_value));
+			r = (rng->value = LCRNG(rng->value));
 
 			/* Mutate a 28-bit "random" number */
 			r = ((r >> 4) & 0x0FFFFFFF) / n;
@@ -198,7 +226,7 @@ uint32_t Rand_div(uint32_t m)
 		/* Use a complex RNG */
 		while (1) {
 			/* Get the next pseudorandom number */
-			r = WELLRNG1024a();
+			r = WELLRNG1024a(rng);
 
 			/* Mutate a 28-bit "random" number */
 			r = ((r >> 4) & 0x0FFFFFFF) / n;
@@ -212,6 +240,11 @@ uint32_t Rand_div(uint32_t m)
 	return (r);
 }
 
+uint32_t Rand_div(uint32_t m)
+{
+	return Rand_div_r(Rand_current, m);
+}
+
 
 /**
  * The number of entries in the "Rand_normal_table"
@@ -284,7 +317,7 @@ static int16_t Rand_normal_table[RANDNOR_NUM] = {
  *
  * Note that the binary search takes up to 16 quick iterations.
  */
-int16_t Rand_normal(int mean, int stand)
+int16_t Rand_normal_r(struct rng_state *rng, int mean, int stand)
 {
 	int16_t tmp, offset;
 
@@ -295,7 +328,7 @@ int16_t Rand_normal(int mean, int stand)
 	if (stand < 1) return (mean);
 
 	/* Roll for probability */
-	tmp = (int16_t)randint0(32768);
+	tmp = (int16_t)randint0_r(rng, 32768);
 
 	/* Binary Search */
 	while (low < high) {
@@ -313,12 +346,17 @@ int16_t Rand_normal(int mean, int stand)
 	offset = (int16_t)((long)stand * (long)low / RANDNOR_STD);
 
 	/* One half should be negative */
-	if (one_in_(2)) return (mean - offset);
+	if (one_in_r(rng, 2)) return (mean - offset);
 
 	/* One half should be positive */
 	return (mean + offset);
 }
 
+int16_t Rand_normal(int mean, int stand)
+{
+	return Rand_normal_r(Rand_current, mean, stand);
+}
+
 
 /**
  * Choose an integer from a distribution where we know the mean and approximate
@@ -332,9 +370,10 @@ int16_t Rand_normal(int mean, int stand)
  * The function chooses an integer from a normal distribution, and then scales
  * it to fit the target distribution.
  */
-int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
+int Rand_sample_r(struct rng_state *rng, int mean, int upper, int lower,
+		int stand_u, int stand_l)
 {
-	int pick = Rand_normal(0, 1000);
+	int pick = Rand_normal_r(rng, 0, 1000);
 
 	/* Scale to fit */
 	if (pick > 0) {
@@ -350,10 +389,16 @@ int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
 	return mean + pick;
 }
 
+int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
+{
+	return Rand_sample_r(Rand_current, mean, upper, lower, stand_u,
+		stand_l);
+}
+
 /**
  * Generates damage for "2d6" style dice rolls
  */
-int damroll(int num, int sides)
+int damroll_r(struct rng_state *rng, int num, int sides)
 {
 	int i;
 	int sum = 0;
@@ -361,21 +406,26 @@ int damroll(int num, int sides)
 	if (sides <= 0) return 0;
 
 	for (i = 0; i < num; i++)
-		sum += randint1(sides);
+		sum += randint1_r(rng, sides);
 	return sum;
 }
 
+int damroll(int num, int sides)
+{
+	return damroll_r(Rand_current, num, sides);
+}
+
 
 
 /**
  * Calculation helper function for damroll
  */
-int damcalc(int num, int sides, aspect dam_aspect)
+int damcalc_r(struct rng_state *rng, int num, int sides, aspect dam_aspect)
 {
 	switch (dam_aspect) {
 		case MAXIMISE:
 		case EXTREMIFY: return num * sides;
-		case RANDOMISE: return damroll(num, sides);
+		case RANDOMISE: return damroll_r(rng, num, sides);
 		case MINIMISE: return num;
 		case AVERAGE: return num * (sides + 1) / 2;
 	}
@@ -384,6 +434,11 @@ int damcalc(int num, int sides, aspect dam_aspect)
 	return 0;
 }
 
+int damcalc(int num, int sides, aspect dam_aspect)
+{
+	return damcalc_r(Rand_current, num, sides, dam_aspect);
+}
+
 
 /**
  * Generates a random signed long integer X where `A` <= X <= `B`.
@@ -391,12 +446,17 @@ int damcalc(int num, int sides, aspect dam_aspect)
  *
  * Note that "rand_range(0, N-1)" == "randint0(N)".
  */
-int rand_range(int A, int B)
+int rand_range_r(struct rng_state *rng, int A, int B)
 {
 	if (A == B) return A;
 	assert(A < B);
 
-	return A + (int32_t)Rand_div(1 + B - A);
+	return A + (int32_t)Rand_div_r(rng, 1 + B - A);
+}
+
+int rand_range(int A, int B)
+{
+	return rand_range_r(Rand_current, A, B);
 }
 
 
@@ -404,11 +464,11 @@ int rand_range(int A, int B)
  * Perform division, possibly rounding up or down depending on the size of the
  * remainder and chance.
  */
-static int simulate_division(int dividend, int divisor)
+static int simulate_division(struct rng_state *rng, int dividend, int divisor)
 {
 	int quotient  = dividend / divisor;
 	int remainder = dividend % divisor;
-	if (randint0(divisor) < remainder) quotient++;
+	if (randint0_r(rng, divisor) < remainder) quotient++;
 	return quotient;
 }
 
@@ -452,7 +512,7 @@ static int simulate_division(int dividend, int divisor)
  * 120    0.03  0.11  0.31  0.46  1.31  2.48  4.60  7.78 11.67 25.53 45.72
  * 128    0.02  0.01  0.13  0.33  0.83  1.41  3.24  6.17  9.57 14.22 64.07
  */
-int16_t m_bonus(int max, int level)
+int16_t m_bonus_r(struct rng_state *rng, int max, int level)
 {
 	int bonus, stand, value;
 
@@ -460,13 +520,13 @@ int16_t m_bonus(int max, int level)
 	if (level >= MAX_RAND_DEPTH) level = MAX_RAND_DEPTH - 1;
 
 	/* The bonus approaches max as level approaches MAX_RAND_DEPTH */
-	bonus = simulate_division(max * level, MAX_RAND_DEPTH);
+	bonus = simulate_division(rng, max * level, MAX_RAND_DEPTH);
 
 	/* The standard deviation is 1/4 of the max */
-	stand = simulate_division(max, 4);
+	stand = simulate_division(rng, max, 4);
 
 	/* Choose a value */
-	value = Rand_normal(bonus, stand);
+	value = Rand_normal_r(rng, bonus, stand);
 
 	/* Return, enforcing the min and max values */
 	if (value < 0)
@@ -477,16 +537,22 @@ int16_t m_bonus(int max, int level)
 		return value;
 }
 
+int16_t m_bonus(int max, int level)
+{
+	return m_bonus_r(Rand_current, max, level);
+}
+
 
 /**
  * Calculation helper function for m_bonus
  */
-int16_t m_bonus_calc(int max, int level, aspect bonus_aspect)
+int16_t m_bonus_calc_r(struct rng_state *rng, int max, int level,
+		aspect bonus_aspect)
 {
 	switch (bonus_aspect) {
 		case EXTREMIFY:
 		case MAXIMISE:  return max;
-		case RANDOMISE: return m_bonus(max, level);
+		case RANDOMISE: return m_bonus_r(rng, max, level);
 		case MINIMISE:  return 0;
 		case AVERAGE:   return max * level / MAX_RAND_DEPTH;
 	}
@@ -495,24 +561,35 @@ int16_t m_bonus_calc(int max, int level, aspect bonus_aspect)
 	return 0;
 }
 
+int16_t m_bonus_calc(int max, int level, aspect bonus_aspect)
+{
+	return m_bonus_calc_r(Rand_current, max, level, bonus_aspect);
+}
+
 
 /**
  * Calculation helper function for random_value structs
  */
-int randcalc(random_value v, int level, aspect rand_aspect)
+int randcalc_r(struct rng_state *rng, random_value v, int level,
+		aspect rand_aspect)
 {
 	if (rand_aspect == EXTREMIFY) {
-		int min = randcalc(v, level, MINIMISE);
-		int max = randcalc(v, level, MAXIMISE);
+		int min = randcalc_r(rng, v, level, MINIMISE);
+		int max = randcalc_r(rng, v, level, MAXIMISE);
 		return abs(min) > abs(max) ? min : max;
 
 	} else {
-		int dmg   = damcalc(v.dice, v.sides, rand_aspect);
-		int bonus = m_bonus_calc(v.m_bonus, level, rand_aspect);
+		int dmg   = damcalc_r(rng, v.dice, v.sides, rand_aspect);
+		int bonus = m_bonus_calc_r(rng, v.m_bonus, level, rand_aspect);
 		return v.base + dmg + bonus;
 	}
 }
 
+int randcalc(random_value v, int level, aspect rand_aspect)
+{
+	return randcalc_r(Rand_current, v, level, rand_aspect);
+}
+
 
 /**
  * Test to see if a value is within a random_value's range
@@ -540,10 +617,15 @@ bool randcalc_varies(random_value v)
  *
  * \param c The random_chance to roll on
  */
-bool random_chance_check(random_chance c)
+bool random_chance_check_r(struct rng_state *rng, random_chance c)
 {
 	/* Calculated so that high rolls pass the check */
-	return randint0(c.denominator) >= c.denominator - c.numerator;
+	return randint0_r(rng, c.denominator) >= c.denominator - c.numerator;
+}
+
+bool random_chance_check(random_chance c)
+{
+	return random_chance_check_r(Rand_current, c);
 }
 
 /**
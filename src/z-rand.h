@@ -57,6 +57,19 @@ typedef struct random_chance_s {
  */
 #define RAND_DEG 32
 
+/**
+ * The complete state of one random number generator.  The functions with a
+ * _r suffix take one of these explicitly, so code can keep a private
+ * generator which isn't disturbed by, and doesn't disturb, anything else.
+ * The functions without the suffix use Rand_current.
+ */
+struct rng_state {
+	bool quick;			/**< use the "quick" RNG rather than WELL */
+	uint32_t value;			/**< state of the "quick" RNG */
+	uint32_t state_i;		/**< index into state for WELL */
+	uint32_t state[RAND_DEG];	/**< state of the "complex" RNG */
+};
+
 /**
  * Random aspects used by damcalc, m_bonus_calc, and ranvals
  */
@@ -75,6 +88,7 @@ typedef enum {
  * The integer X falls along a uniform distribution.
  */
 #define randint0(M) ((int32_t) Rand_div(M))
+#define randint0_r(R, M) ((int32_t) Rand_div_r(R, M))
 
 
 /**
@@ -83,6 +97,7 @@ typedef enum {
  * The integer X falls along a uniform distribution.
  */
 #define randint1(M) ((int32_t) Rand_div(M) + 1)
+#define randint1_r(R, M) ((int32_t) Rand_div_r(R, M) + 1)
 
 /**
  * Generate a random signed long integer X where "A - D <= X <= A + D" holds.
@@ -91,33 +106,47 @@ typedef enum {
  * The integer X falls along a uniform distribution.
  */
 #define rand_spread(A, D) ((A) + (randint0(1 + (D) + (D))) - (D))
+#define rand_spread_r(R, A, D) ((A) + (randint0_r(R, 1 + (D) + (D))) - (D))
 
 /**
  * Return true one time in `x`.
  */
 #define one_in_(x) (!randint0(x))
+#define one_in_r(R, x) (!randint0_r(R, x))
+
+/**
+ * The game's own generator, which is saved with the character.
+ */
+extern struct rng_state Rand_state;
+
+/**
+ * The generator used by the functions without the _r suffix; normally
+ * &Rand_state.
+ */
+extern struct rng_state *Rand_current;
 
 /**
  * Whether we are currently using the "quick" method or not.
  */
-extern bool Rand_quick;
+#define Rand_quick (Rand_current->quick)
 
 /**
  * The state used by the "quick" RNG.
  */
-extern uint32_t Rand_value;
+#define Rand_value (Rand_current->value)
+
 
 /**
- * The state used by the "complex" RNG.
+ * Make the given generator the current one, returning the previous one so
+ * it can be restored.
  */
-extern uint32_t state_i;
-extern uint32_t STATE[RAND_DEG];
-
+struct rng_state *Rand_use(struct rng_state *rng);
 
 /**
  * Initialise the RNG state with the given seed.
  */
 void Rand_state_init(uint32_t seed);
+void Rand_state_init_r(struct rng_state *rng, uint32_t seed);
 
 /**
  * Initialise the RNG
@@ -130,12 +159,14 @@ void Rand_init(void);
  * The integer X falls along a uniform distribution.
  */
 uint32_t Rand_div(uint32_t m);
+uint32_t Rand_div_r(struct rng_state *rng, uint32_t m);
 
 /**
  * Generate a signed random integer within `stand` standard deviations of
  * `mean`, following a normal distribution.
  */
 int16_t Rand_normal(int mean, int stand);
+int16_t Rand_normal_r(struct rng_state *rng, int mean, int stand);
 
 /**
  * Generate a signed random integer following a normal distribution, where
@@ -144,6 +175,8 @@ int16_t Rand_normal(int mean, int stand);
  * the bounds are.
  */
 int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l);
+int Rand_sample_r(struct rng_state *rng, int mean, int upper, int lower,
+		int stand_u, int stand_l);
 
 /**
  * Generate a semi-random number from 0 to m-1, in a way that doesn't affect
@@ -156,11 +189,13 @@ uint32_t Rand_simple(uint32_t m);
  * Emulate a number `num` of dice rolls of dice with `sides` sides.
  */
 int damroll(int num, int sides);
+int damroll_r(struct rng_state *rng, int num, int sides);
 
 /**
  * Calculation helper function for damroll
  */
 int damcalc(int num, int sides, aspect dam_aspect);
+int damcalc_r(struct rng_state *rng, int num, int sides, aspect dam_aspect);
 
 /**
  * Generates a random signed long integer X where "A <= X <= B"
@@ -169,22 +204,28 @@ int damcalc(int num, int sides, aspect dam_aspect);
  * The integer X falls along a uniform distribution.
  */
 int rand_range(int A, int B);
+int rand_range_r(struct rng_state *rng, int A, int B);
 
 /**
  * Function used to determine enchantment bonuses, see function header for
  * a more complete description.
  */
 int16_t m_bonus(int max, int level);
+int16_t m_bonus_r(struct rng_state *rng, int max, int level);
 
 /**
  * Calculation helper function for m_bonus.
  */
 int16_t m_bonus_calc(int max, int level, aspect bonus_aspect);
+int16_t m_bonus_calc_r(struct rng_state *rng, int max, int level,
+		aspect bonus_aspect);
 
 /**
  * Calculation helper function for random_value structs.
  */
 int randcalc(random_value v, int level, aspect rand_aspect);
+int randcalc_r(struct rng_state *rng, random_value v, int level,
+		aspect rand_aspect);
 
 /**
  * Test to see if a value is within a random_value's range.
@@ -197,6 +238,7 @@ bool randcalc_valid(random_value v, int test);
 bool randcalc_varies(random_value v);
 
 bool random_chance_check(random_chance c);
+bool random_chance_check_r(struct rng_state *rng, random_chance c);
 
 int random_chance_scaled(random_chance c, int scale);
 
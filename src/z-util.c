@@ -17,6 +17,7 @@
  */
 
 #include <stdlib.h>
+#include <time.h>
 
 #include "z-util.h"
 
@@ -2054,3 +2055,44 @@ uint32_t djb2_hash(const char *str)
 	return hash;
 }
 
+uint32_t djb2_hash_nocase(const char *str)
+{
+	uint32_t hash = 5381;
+
+	while (*str) {
+		hash = hash * 33 + (unsigned char) toupper((unsigned char) *str);
+		str++;
+	}
+	return hash;
+}
+
+
+/**
+ * Section times, kept while section_timing is set
+ */
+bool section_timing = false;
+struct section_time section_times[TIMED_MAX];
+static clock_t section_began[TIMED_MAX];
+static int section_depth[TIMED_MAX];
+
+/**
+ * Note the start of a timed section; a section entered again before it
+ * ends is only timed from the outermost call
+ */
+void section_start(int section)
+{
+	if (!section_timing) return;
+	if (!section_depth[section]++) {
+		section_began[section] = clock();
+	}
+}
+
+void section_stop(int section)
+{
+	if (!section_timing || !section_depth[section]) return;
+	if (!--section_depth[section]) {
+		section_times[section].calls++;
+		section_times[section].seconds +=
+			(double) (clock() - section_began[section]) / CLOCKS_PER_SEC;
+	}
+}
@@ -237,6 +237,32 @@ extern void sort(void *array, size_t nmemb, size_t smemb,
  */
 uint32_t djb2_hash(const char *str);
 
+/**
+ * Create a hash for a string which ignores case, as my_stricmp() does
+ */
+uint32_t djb2_hash_nocase(const char *str);
+
+/**
+ * Parts of the game whose calls can be counted and timed for benchmarking;
+ * the times are inclusive, so handle_stuff() contains the others
+ */
+enum {
+	TIMED_HANDLE_STUFF,
+	TIMED_PRT_MAP,
+	TIMED_TERM_FRESH,
+	TIMED_MAX
+};
+
+struct section_time {
+	uint32_t calls;
+	double seconds;
+};
+
+extern bool section_timing;
+extern struct section_time section_times[TIMED_MAX];
+void section_start(int section);
+void section_stop(int section);
+
 /**
  * Mathematical functions
  */
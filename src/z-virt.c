@@ -18,6 +18,8 @@
 #include "z-virt.h"
 #include "z-util.h"
 
+uint32_t mem_alloc_count = 0;
+
 /**
  * Allocate `len` bytes of memory.
  *
@@ -35,6 +37,7 @@ void *mem_alloc(size_t len)
 	if (!len)
 		return NULL;
 
+	mem_alloc_count++;
 	void *p = malloc(len);
 	if (!p)
 		quit("Out of memory!");
@@ -61,6 +64,7 @@ void *mem_realloc(void *p, size_t len)
 	if (!len)
 		return NULL;
 
+	mem_alloc_count++;
 	p = realloc(p, len);
 	if (!p)
 		quit("Out of Memory!");
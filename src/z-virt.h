@@ -23,6 +23,11 @@ void *mem_zalloc(size_t len);
 void mem_free(void *p);
 void *mem_realloc(void *p, size_t len);
 
+/**
+ * Number of calls of mem_alloc(), mem_zalloc() and mem_realloc() so far
+ */
+extern uint32_t mem_alloc_count;
+
 /**
  * On NDS, we might need to allocate some data into external memory
  * with additional restrictions (no 8-bit writes). These "alt" methods